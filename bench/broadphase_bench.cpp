@@ -0,0 +1,93 @@
+#include "ecs/spatial/HashGrid.h"
+#include "ecs/math/Vector.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Engine::ECS;
+using Engine::Math::Vector3;
+
+namespace {
+
+struct Sphere {
+    Vector3 center;
+    float radius;
+};
+
+// Small spheres at the same density for every count, so the pair count
+// grows linearly with it: about 0.08 per unit cube
+std::vector<Sphere> makeSpheres(std::size_t count) {
+    float side = 50.0f * std::cbrt(float(count) / 10000.0f);
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> position(0.0f, side);
+    std::uniform_real_distribution<float> radius(0.2f, 0.6f);
+
+    std::vector<Sphere> spheres;
+    spheres.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        spheres.push_back({Vector3(position(random), position(random), position(random)), radius(random)});
+    }
+    return spheres;
+}
+
+// Every pair tested against every other; the baseline
+std::size_t bruteForcePairs(const std::vector<Sphere>& spheres, std::vector<BroadphasePair>& pairs) {
+    pairs.clear();
+    for (std::size_t i = 0; i < spheres.size(); i++) {
+        const Sphere& a = spheres[i];
+        for (std::size_t j = i + 1; j < spheres.size(); j++) {
+            const Sphere& b = spheres[j];
+            Vector3 d = a.center - b.center;
+            float r = a.radius + b.radius;
+            if (d.dot(d) <= r * r) {
+                pairs.push_back({static_cast<EntityID>(i), static_cast<EntityID>(j)});
+            }
+        }
+    }
+    return pairs.size();
+}
+
+} // namespace
+
+TEST_CASE("HashGrid pair generation against brute force", "[!benchmark][ecs][broadphase]") {
+    for (std::size_t count : {std::size_t(10000), std::size_t(50000)}) {
+        std::string suffix = " " + std::to_string(count);
+        std::vector<Sphere> spheres = makeSpheres(count);
+
+        HashGrid grid(1.0f);
+        for (std::size_t i = 0; i < count; i++) {
+            grid.insert(static_cast<EntityID>(i), spheres[i].center, spheres[i].radius);
+        }
+
+        std::vector<BroadphasePair> pairs;
+        std::vector<BroadphasePair> expected;
+        grid.findPairs(pairs);
+        REQUIRE(pairs.size() == bruteForcePairs(spheres, expected));
+
+        BENCHMARK("pairs, hash grid" + suffix) {
+            grid.findPairs(pairs);
+            return pairs.size();
+        };
+
+        // What BroadphaseSystem does each frame: move everything, then pair
+        BENCHMARK_ADVANCED("move all + pairs, hash grid" + suffix)(Catch::Benchmark::Chronometer meter) {
+            meter.measure([&](int run) {
+                float step = run % 2 == 0 ? 0.05f : -0.05f;
+                for (std::size_t i = 0; i < count; i++) {
+                    spheres[i].center.x += step;
+                    grid.update(static_cast<EntityID>(i), spheres[i].center, spheres[i].radius);
+                }
+                grid.findPairs(pairs);
+                return pairs.size();
+            });
+        };
+
+        BENCHMARK("pairs, brute force" + suffix) {
+            return bruteForcePairs(spheres, expected);
+        };
+    }
+}
@@ -0,0 +1,156 @@
+#include "ecs/spatial/DynamicBVH.h"
+#include "ecs/math/Frustum.h"
+#include "ecs/math/Matrix4x4.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+using namespace Engine::ECS;
+using namespace Engine::Math;
+
+namespace {
+
+constexpr std::size_t OBJECT_COUNT = 100000;
+
+// Unit-ish boxes scattered through a 1000 x 100 x 1000 world
+std::vector<AABB> makeBoxes(std::size_t count) {
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> horizontal(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> vertical(0.0f, 100.0f);
+    std::uniform_real_distribution<float> size(0.25f, 2.0f);
+
+    std::vector<AABB> boxes;
+    boxes.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        Vector3 center(horizontal(random), vertical(random), horizontal(random));
+        float half = size(random);
+        boxes.emplace_back(center - Vector3(half, half, half), center + Vector3(half, half, half));
+    }
+    return boxes;
+}
+
+DynamicBVH buildTree(const std::vector<AABB>& boxes) {
+    DynamicBVH tree;
+    for (std::size_t i = 0; i < boxes.size(); i++) {
+        tree.insert(static_cast<EntityID>(i), boxes[i]);
+    }
+    tree.rebuild();
+    return tree;
+}
+
+// Perspective camera at the world's edge looking across it, in the
+// column-vector layout Frustum expects
+Frustum makeFrustum() {
+    float fovY = 60.0f * 3.14159265f / 180.0f;
+    float aspect = 16.0f / 9.0f;
+    float nearPlane = 0.1f;
+    float farPlane = 300.0f;
+    float f = 1.0f / std::tan(fovY * 0.5f);
+
+    Matrix4x4 projection;
+    projection(0, 0) = f / aspect;
+    projection(1, 1) = f;
+    projection(2, 2) = -(farPlane + nearPlane) / (farPlane - nearPlane);
+    projection(2, 3) = -(2.0f * farPlane * nearPlane) / (farPlane - nearPlane);
+    projection(3, 2) = -1.0f;
+    projection(3, 3) = 0.0f;
+
+    Matrix4x4 view = Matrix4x4::createLookAt(Vector3(0.0f, 50.0f, 500.0f), Vector3(0.0f, 50.0f, 0.0f),
+                                             Vector3(0.0f, 1.0f, 0.0f));
+    return Frustum(projection * view);
+}
+
+} // namespace
+
+TEST_CASE("DynamicBVH build, refit and queries over 100k objects", "[!benchmark][ecs][spatial]") {
+    std::vector<AABB> boxes = makeBoxes(OBJECT_COUNT);
+    Frustum frustum = makeFrustum();
+    AABB region(Vector3(-50.0f, 0.0f, -50.0f), Vector3(50.0f, 100.0f, 50.0f));
+    Vector3 rayOrigin(-500.0f, 50.0f, -500.0f);
+    Vector3 rayDirection = Vector3(1.0f, 0.0f, 1.0f).normalized();
+
+    DynamicBVH tree = buildTree(boxes);
+    REQUIRE(tree.size() == OBJECT_COUNT);
+
+    // The tree may return extra leaves through its fat boxes, never fewer
+    std::size_t linearHits = 0;
+    for (const AABB& box : boxes) {
+        linearHits += frustum.intersects(box);
+    }
+    std::size_t treeHits = 0;
+    tree.queryFrustum(frustum, [&](EntityID) { treeHits++; });
+    REQUIRE(treeHits >= linearHits);
+    REQUIRE(treeHits > 0);
+
+    BENCHMARK("build: insert 100k + SAH rebuild") {
+        return buildTree(boxes).size();
+    };
+
+    BENCHMARK("build: insert 100k, no rebuild") {
+        DynamicBVH incremental;
+        for (std::size_t i = 0; i < boxes.size(); i++) {
+            incremental.insert(static_cast<EntityID>(i), boxes[i]);
+        }
+        return incremental.size();
+    };
+
+    // Each run moves every tenth object by a small step in alternating
+    // directions, so most updates stay inside their fat boxes and the rest
+    // refit or reinsert
+    BENCHMARK_ADVANCED("update 10k of 100k moving objects")(Catch::Benchmark::Chronometer meter) {
+        DynamicBVH moving = buildTree(boxes);
+        meter.measure([&](int run) {
+            float step = (run % 2 == 0 ? 0.3f : -0.3f);
+            std::size_t changed = 0;
+            for (std::size_t i = 0; i < boxes.size(); i += 10) {
+                Vector3 offset(step * float(i % 3), 0.0f, step);
+                changed += moving.update(static_cast<EntityID>(i),
+                                         AABB(boxes[i].min + offset, boxes[i].max + offset));
+            }
+            return changed;
+        });
+    };
+
+    BENCHMARK("frustum query (BVH)") {
+        std::size_t hits = 0;
+        tree.queryFrustum(frustum, [&](EntityID) { hits++; });
+        return hits;
+    };
+
+    BENCHMARK("frustum query (linear)") {
+        std::size_t hits = 0;
+        for (const AABB& box : boxes) {
+            hits += frustum.intersects(box);
+        }
+        return hits;
+    };
+
+    BENCHMARK("AABB query (BVH)") {
+        std::size_t hits = 0;
+        tree.queryAABB(region, [&](EntityID) { hits++; });
+        return hits;
+    };
+
+    BENCHMARK("AABB query (linear)") {
+        std::size_t hits = 0;
+        for (const AABB& box : boxes) {
+            hits += box.intersects(region);
+        }
+        return hits;
+    };
+
+    BENCHMARK("sphere query (BVH)") {
+        std::size_t hits = 0;
+        tree.querySphere(BoundingSphere(Vector3(0.0f, 50.0f, 0.0f), 25.0f), [&](EntityID) { hits++; });
+        return hits;
+    };
+
+    BENCHMARK("ray query (BVH)") {
+        std::size_t hits = 0;
+        tree.queryRay(rayOrigin, rayDirection, 1500.0f, [&](EntityID) { hits++; });
+        return hits;
+    };
+}
@@ -0,0 +1,90 @@
+#include "ecs/ECSManager.h"
+#include "ecs/components/TransformComponent.h"
+#include "ecs/components/BroadphaseComponent.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Engine::ECS;
+
+namespace {
+
+// `count` entities with a TransformComponent, in a manager storing
+// BroadphaseComponent with `policy`
+struct Scene {
+    std::unique_ptr<ECSManager> manager;
+    std::vector<Entity*> entities;
+
+    Scene(StoragePolicy policy, std::size_t count) : manager(std::make_unique<ECSManager>(count)) {
+        manager->registerComponent<BroadphaseComponent>(policy);
+        entities.reserve(count);
+        for (std::size_t i = 0; i < count; i++) {
+            Entity* entity = manager->createEntity();
+            entity->addComponent<TransformComponent>();
+            entities.push_back(entity);
+        }
+    }
+
+    void addAll(std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            entities[i]->addComponent<BroadphaseComponent>(1.0f);
+        }
+    }
+};
+
+const char* policyName(StoragePolicy policy) {
+    return policy == StoragePolicy::SparseSet ? "sparse set" : "archetype";
+}
+
+} // namespace
+
+TEST_CASE("Component add, remove, get and iterate by storage policy", "[!benchmark][ecs][storage]") {
+    for (std::size_t count : {std::size_t(1000), std::size_t(10000), std::size_t(100000)}) {
+        for (StoragePolicy policy : {StoragePolicy::Archetype, StoragePolicy::SparseSet}) {
+            std::string suffix = " " + std::to_string(count) + " (" + policyName(policy) + ")";
+
+            // Every run needs entities without the component, so each sample
+            // gets a scene with a batch of them per run
+            BENCHMARK_ADVANCED("add" + suffix)(Catch::Benchmark::Chronometer meter) {
+                Scene scene(policy, count * meter.runs());
+                meter.measure([&](int run) {
+                    scene.addAll(run * count, (run + 1) * count);
+                    return run;
+                });
+            };
+
+            BENCHMARK_ADVANCED("remove" + suffix)(Catch::Benchmark::Chronometer meter) {
+                Scene scene(policy, count * meter.runs());
+                scene.addAll(0, scene.entities.size());
+                meter.measure([&](int run) {
+                    for (std::size_t i = run * count; i < (run + 1) * count; i++) {
+                        scene.entities[i]->removeComponent<BroadphaseComponent>();
+                    }
+                    return run;
+                });
+            };
+
+            Scene scene(policy, count);
+            scene.addAll(0, count);
+
+            BENCHMARK("get" + suffix) {
+                float sum = 0.0f;
+                for (Entity* entity : scene.entities) {
+                    sum += entity->getComponent<BroadphaseComponent>().getRadius();
+                }
+                return sum;
+            };
+
+            BENCHMARK("iterate" + suffix) {
+                float sum = 0.0f;
+                scene.manager->view<const TransformComponent, const BroadphaseComponent>().each(
+                    [&](const TransformComponent& transform, const BroadphaseComponent& broadphase) {
+                        sum += transform.position.x + broadphase.getRadius();
+                    });
+                return sum;
+            };
+        }
+    }
+}
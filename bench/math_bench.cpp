@@ -0,0 +1,139 @@
+#include "ecs/math/Matrix4x4.h"
+#include "ecs/math/Quaternion.h"
+#include "ecs/math/Vector.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <cmath>
+#include <vector>
+
+using namespace Engine::Math;
+
+namespace {
+
+// The scalar implementations the SIMD kernels replaced, kept here as the
+// baseline to measure against. tests/ecs/math_simd_tests.cpp checks that both
+// compute the same results.
+namespace reference {
+
+Matrix4x4 multiply(const Matrix4x4& a, const Matrix4x4& b) {
+    Matrix4x4 result;
+    for (int row = 0; row < 4; row++) {
+        for (int col = 0; col < 4; col++) {
+            result(row, col) = 0.0f;
+            for (int i = 0; i < 4; i++) {
+                result(row, col) += a(row, i) * b(i, col);
+            }
+        }
+    }
+    return result;
+}
+
+Matrix4x4 createTRS(const Vector3& position, const Quaternion& rotation, const Vector3& scale) {
+    Matrix4x4 t = Matrix4x4::createTranslation(position);
+    Matrix4x4 r = Matrix4x4::createRotation(rotation);
+    Matrix4x4 s = Matrix4x4::createScale(scale);
+    return multiply(multiply(t, r), s);
+}
+
+Quaternion multiply(const Quaternion& a, const Quaternion& q) {
+    return Quaternion(
+        a.w * q.x + a.x * q.w + a.y * q.z - a.z * q.y,
+        a.w * q.y - a.x * q.z + a.y * q.w + a.z * q.x,
+        a.w * q.z + a.x * q.y - a.y * q.x + a.z * q.w,
+        a.w * q.w - a.x * q.x - a.y * q.y - a.z * q.z
+    );
+}
+
+Vector3 rotateVector(const Quaternion& q, const Vector3& v) {
+    Vector3 qvec(q.x, q.y, q.z);
+    Vector3 uv = qvec.cross(v);
+    Vector3 uuv = qvec.cross(uv);
+    return v + (uv * q.w + uuv) * 2.0f;
+}
+
+} // namespace reference
+
+constexpr std::size_t COUNT = 4096;
+
+struct Inputs {
+    std::vector<Vector3> positions;
+    std::vector<Quaternion> rotations;
+    std::vector<Vector3> scales;
+    std::vector<Matrix4x4> matrices;
+
+    Inputs() {
+        for (std::size_t i = 0; i < COUNT; i++) {
+            float f = static_cast<float>(i);
+            positions.emplace_back(f, f * 0.5f, -f);
+            rotations.push_back(Quaternion::fromEulerAngles(f * 0.01f, f * 0.02f, f * 0.03f));
+            scales.emplace_back(1.0f + f * 0.001f, 1.0f, 2.0f);
+            matrices.push_back(reference::createTRS(positions.back(), rotations.back(), scales.back()));
+        }
+    }
+};
+
+} // namespace
+
+TEST_CASE("SIMD math kernels against the scalar code they replaced", "[!benchmark][math]") {
+    Inputs in;
+
+    std::vector<Matrix4x4> matrices(COUNT);
+    std::vector<Quaternion> quaternions(COUNT);
+    std::vector<Vector3> vectors(COUNT);
+
+    BENCHMARK("mat4 multiply (scalar reference)") {
+        for (std::size_t i = 0; i < COUNT; i++) {
+            matrices[i] = reference::multiply(in.matrices[i], in.matrices[COUNT - 1 - i]);
+        }
+        return matrices[COUNT / 2].data[0];
+    };
+
+    BENCHMARK("mat4 multiply (SIMD)") {
+        for (std::size_t i = 0; i < COUNT; i++) {
+            matrices[i] = in.matrices[i] * in.matrices[COUNT - 1 - i];
+        }
+        return matrices[COUNT / 2].data[0];
+    };
+
+    BENCHMARK("createTRS (scalar reference)") {
+        for (std::size_t i = 0; i < COUNT; i++) {
+            matrices[i] = reference::createTRS(in.positions[i], in.rotations[i], in.scales[i]);
+        }
+        return matrices[COUNT / 2].data[0];
+    };
+
+    BENCHMARK("createTRS (SIMD)") {
+        for (std::size_t i = 0; i < COUNT; i++) {
+            matrices[i] = Matrix4x4::createTRS(in.positions[i], in.rotations[i], in.scales[i]);
+        }
+        return matrices[COUNT / 2].data[0];
+    };
+
+    BENCHMARK("quaternion multiply (scalar reference)") {
+        for (std::size_t i = 0; i < COUNT; i++) {
+            quaternions[i] = reference::multiply(in.rotations[i], in.rotations[COUNT - 1 - i]);
+        }
+        return quaternions[COUNT / 2].w;
+    };
+
+    BENCHMARK("quaternion multiply (SIMD)") {
+        for (std::size_t i = 0; i < COUNT; i++) {
+            quaternions[i] = in.rotations[i] * in.rotations[COUNT - 1 - i];
+        }
+        return quaternions[COUNT / 2].w;
+    };
+
+    BENCHMARK("quaternion rotate (scalar reference)") {
+        for (std::size_t i = 0; i < COUNT; i++) {
+            vectors[i] = reference::rotateVector(in.rotations[i], in.positions[i]);
+        }
+        return vectors[COUNT / 2].x;
+    };
+
+    BENCHMARK("quaternion rotate (SIMD)") {
+        for (std::size_t i = 0; i < COUNT; i++) {
+            vectors[i] = in.rotations[i].rotateVector(in.positions[i]);
+        }
+        return vectors[COUNT / 2].x;
+    };
+}
@@ -0,0 +1,57 @@
+#include "ecs/ECSManager.h"
+#include "ecs/ParallelFor.h"
+#include "ecs/components/TransformComponent.h"
+#include "core/job_system.h"
+#include "core/memory/frame_allocator.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <cmath>
+#include <memory>
+#include <string>
+
+using namespace Engine::ECS;
+using Engine::Math::Affine3x4;
+using Engine::Math::Quaternion;
+using Engine::Math::Vector3;
+
+namespace {
+
+// Per-entity work of the benchmark: move the transform a little and rebuild
+// its world matrix
+void updateTransform(TransformComponent& transform) {
+    Vector3 position = transform.position;
+    position.y = std::sin(position.x * 0.01f + position.z);
+    transform.position = position;
+    transform.worldMatrix = Affine3x4::createTRS(transform.position, transform.rotation, transform.scale);
+}
+
+} // namespace
+
+TEST_CASE("parallelForEach transform update over 100k entities", "[!benchmark][ecs][parallel]") {
+    constexpr int ENTITY_COUNT = 100000;
+    constexpr std::size_t GRAIN_SIZE = 512;
+
+    ECSManager manager(ENTITY_COUNT);
+    for (int i = 0; i < ENTITY_COUNT; i++) {
+        Entity* entity = manager.createEntity();
+        entity->addComponent<TransformComponent>(Vector3(float(i % 100), 0.0f, float(i / 100)));
+    }
+    auto transforms = manager.view<TransformComponent>();
+    REQUIRE(transforms.size() == ENTITY_COUNT);
+
+    BENCHMARK("1 thread (View::each)") {
+        transforms.each(updateTransform);
+        return transforms.size();
+    };
+
+    // The calling thread runs jobs while it waits, so N threads means a
+    // pool of N - 1 workers
+    for (unsigned int threads : {2u, 4u, 8u, 16u}) {
+        engine::core::JobSystem jobs(threads - 1);
+        BENCHMARK(std::to_string(threads) + " threads") {
+            parallelForEach(transforms, updateTransform, GRAIN_SIZE, jobs);
+            engine::core::FrameAllocator::getInstance().endFrame();
+            return transforms.size();
+        };
+    }
+}
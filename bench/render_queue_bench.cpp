@@ -0,0 +1,111 @@
+#include "rendering/render_queue.h"
+#include "rendering/shader.h"
+#include "rendering/mesh.h"
+#include "rendering/model/material.h"
+#include "rendering/gl_stub.h"
+#include "ecs/math/Affine3x4.h"
+#include "ecs/math/Matrix3x3.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace engine::rendering;
+
+namespace {
+
+constexpr std::size_t DRAW_COUNT = 5000;
+constexpr std::size_t MATERIAL_COUNT = 20;
+constexpr std::size_t MESH_COUNT = 10;
+
+// The scene the render queue was tuned on: 5000 opaque draws of 10 meshes
+// with 20 materials and one shader. Materials are stand-ins compared by
+// address; submit() is not called, so they are never applied.
+struct Scene {
+    Shader shader;
+    Shader instancedShader;
+    std::vector<std::unique_ptr<Mesh>> meshes;
+    std::vector<std::aligned_storage_t<sizeof(Material), alignof(Material)>> materials;
+    std::vector<Engine::Math::Affine3x4> worldMatrices;
+    std::vector<Engine::Math::Matrix3x3> normalMatrices;
+    std::vector<std::size_t> materialOf;
+    std::vector<std::size_t> meshOf;
+    std::vector<float> depths;
+
+    Scene() : materials(MATERIAL_COUNT), worldMatrices(DRAW_COUNT), normalMatrices(DRAW_COUNT) {
+        testing::installCountingGL();
+        for (std::size_t i = 0; i < MESH_COUNT; i++) {
+            meshes.push_back(std::make_unique<Mesh>());
+            meshes.back()->setVertices(std::vector<Vertex>(3 + i), {0, 1, 2});
+        }
+
+        std::mt19937 random(1);
+        std::uniform_real_distribution<float> depth(0.5f, 500.0f);
+        for (std::size_t i = 0; i < DRAW_COUNT; i++) {
+            materialOf.push_back(random() % MATERIAL_COUNT);
+            meshOf.push_back(random() % MESH_COUNT);
+            depths.push_back(depth(random));
+        }
+    }
+
+    void fill(RenderQueue& queue) {
+        queue.clear();
+        for (std::size_t i = 0; i < DRAW_COUNT; i++) {
+            queue.add(RenderPass::Opaque, shader, reinterpret_cast<Material*>(&materials[materialOf[i]]),
+                      *meshes[meshOf[i]], depths[i], worldMatrices[i], normalMatrices[i]);
+        }
+    }
+};
+
+} // namespace
+
+TEST_CASE("Render queue sorting and batching of a 5000-draw scene", "[!benchmark][rendering][queue]") {
+    Scene scene;
+    RenderQueue queue;
+
+    BENCHMARK("add 5000") {
+        scene.fill(queue);
+        return queue.size();
+    };
+
+    BENCHMARK("add + radix sort 5000") {
+        scene.fill(queue);
+        queue.sort();
+        return queue.getSortedKey(0);
+    };
+
+    // The baseline the radix sort replaced
+    std::vector<std::uint64_t> keys(DRAW_COUNT);
+    BENCHMARK_ADVANCED("std::stable_sort 5000 keys")(Catch::Benchmark::Chronometer meter) {
+        scene.fill(queue);
+        queue.sort();
+        std::vector<std::uint64_t> shuffled(DRAW_COUNT);
+        for (std::size_t i = 0; i < DRAW_COUNT; i++) {
+            shuffled[queue.getSortedIndex(i)] = queue.getSortedKey(i);
+        }
+        meter.measure([&] {
+            keys = shuffled;
+            std::stable_sort(keys.begin(), keys.end());
+            return keys[0];
+        });
+    };
+
+    scene.fill(queue);
+    queue.sort();
+    BENCHMARK("buildBatches 5000, one draw each") {
+        queue.buildBatches();
+        return queue.getBatches().size();
+    };
+
+    queue.setInstancedVariant(scene.shader, &scene.instancedShader);
+    scene.fill(queue);
+    queue.sort();
+    queue.buildBatches();
+    REQUIRE(queue.getBatches().size() == MATERIAL_COUNT);
+    BENCHMARK("buildBatches 5000, instanced") {
+        queue.buildBatches();
+        return queue.getIndirectCommands().size();
+    };
+}
@@ -0,0 +1,64 @@
+#include "ecs/ECSManager.h"
+#include "ecs/components/TransformComponent.h"
+#include "ecs/components/MeshRendererComponent.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+using namespace Engine::ECS;
+
+namespace {
+
+// Gives access to the member list the old render loop walked
+class RendererListSystem : public System {
+public:
+    RendererListSystem() {
+        setComponentMask<const TransformComponent, const MeshRendererComponent>();
+    }
+
+    void init() override {}
+};
+
+} // namespace
+
+TEST_CASE("View iteration against getEntities() and getComponent()", "[!benchmark][ecs][view]") {
+    constexpr int ENTITY_COUNT = 10000;
+
+    ECSManager manager(ENTITY_COUNT);
+    RendererListSystem* system = manager.registerSystem<RendererListSystem>();
+    for (int i = 0; i < ENTITY_COUNT; i++) {
+        Entity* entity = manager.createEntity();
+        entity->addComponent<TransformComponent>(Engine::Math::Vector3(float(i), 0.0f, 0.0f));
+        entity->addComponent<MeshRendererComponent>();
+    }
+    REQUIRE(system->getEntities().size() == ENTITY_COUNT);
+    REQUIRE(manager.view<const TransformComponent, const MeshRendererComponent>().size() == ENTITY_COUNT);
+
+    BENCHMARK("getEntities() + hasComponent/getComponent") {
+        float sum = 0.0f;
+        for (Entity* entity : system->getEntities()) {
+            if (entity->hasComponent<TransformComponent>() && entity->hasComponent<MeshRendererComponent>()) {
+                const TransformComponent& transform = entity->getComponent<TransformComponent>();
+                const MeshRendererComponent& renderer = entity->getComponent<MeshRendererComponent>();
+                sum += renderer.castsShadows() ? transform.position.x : 0.0f;
+            }
+        }
+        return sum;
+    };
+
+    BENCHMARK("view<...>().each()") {
+        float sum = 0.0f;
+        manager.view<const TransformComponent, const MeshRendererComponent>().each(
+            [&](const TransformComponent& transform, const MeshRendererComponent& renderer) {
+                sum += renderer.castsShadows() ? transform.position.x : 0.0f;
+            });
+        return sum;
+    };
+
+    BENCHMARK("view<...>() range-for") {
+        float sum = 0.0f;
+        for (auto [transform, renderer] : manager.view<const TransformComponent, const MeshRendererComponent>()) {
+            sum += renderer.castsShadows() ? transform.position.x : 0.0f;
+        }
+        return sum;
+    };
+}
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace engine {
+namespace core {
+
+// Tracks a group of submitted jobs; wait() on it to join the group
+struct JobCounter {
+    std::atomic<std::size_t> pending{0};
+
+    bool isDone() const { return pending.load(std::memory_order_acquire) == 0; }
+};
+
+// Type-erased void() callable stored inline, so submitting a job never
+// touches the heap. Callables larger than CAPACITY bytes do not compile;
+// capture a pointer to larger state instead.
+class Job {
+public:
+    static constexpr std::size_t CAPACITY = 48;
+
+    Job() = default;
+
+    template <typename Func, typename = std::enable_if_t<!std::is_same<std::decay_t<Func>, Job>::value>>
+    Job(Func&& fn) {
+        using Callable = std::decay_t<Func>;
+        static_assert(sizeof(Callable) <= CAPACITY, "Job callable too large; capture a pointer instead");
+        static_assert(alignof(Callable) <= alignof(std::max_align_t), "Job callable is over-aligned");
+        new (m_storage) Callable(std::forward<Func>(fn));
+        m_ops = &OPS<Callable>;
+    }
+
+    Job(Job&& other) noexcept { take(other); }
+
+    Job& operator=(Job&& other) noexcept {
+        if (this != &other) {
+            reset();
+            take(other);
+        }
+        return *this;
+    }
+
+    Job(const Job&) = delete;
+    Job& operator=(const Job&) = delete;
+
+    ~Job() { reset(); }
+
+    void operator()() { m_ops->invoke(m_storage); }
+
+    explicit operator bool() const { return m_ops != nullptr; }
+
+private:
+    struct Ops {
+        void (*invoke)(void* storage);
+        void (*move)(void* to, void* from); // move-construct `to`, destroy `from`
+        void (*destroy)(void* storage);
+    };
+
+    template <typename Callable>
+    static void invokeCallable(void* storage) {
+        (*static_cast<Callable*>(storage))();
+    }
+
+    template <typename Callable>
+    static void moveCallable(void* to, void* from) {
+        new (to) Callable(std::move(*static_cast<Callable*>(from)));
+        static_cast<Callable*>(from)->~Callable();
+    }
+
+    template <typename Callable>
+    static void destroyCallable(void* storage) {
+        static_cast<Callable*>(storage)->~Callable();
+    }
+
+    template <typename Callable>
+    static constexpr Ops OPS = {&invokeCallable<Callable>, &moveCallable<Callable>, &destroyCallable<Callable>};
+
+    alignas(std::max_align_t) unsigned char m_storage[CAPACITY];
+    const Ops* m_ops = nullptr;
+
+    void reset() {
+        if (m_ops) {
+            m_ops->destroy(m_storage);
+            m_ops = nullptr;
+        }
+    }
+
+    void take(Job& other) {
+        if (other.m_ops) {
+            other.m_ops->move(m_storage, other.m_storage);
+            m_ops = other.m_ops;
+            other.m_ops = nullptr;
+        }
+    }
+};
+
+// Work-stealing pool of worker threads.
+//
+// Every worker owns a deque: jobs submitted from a worker go to the back of
+// its own deque and are popped LIFO (hot in cache), while idle workers steal
+// the oldest jobs from the front of other deques. Jobs submitted from other
+// threads are spread across the workers round-robin.
+// Threads that wait on a JobCounter run queued jobs instead of blocking, so
+// jobs may submit and wait on further jobs without deadlocking the pool.
+class JobSystem {
+public:
+    using Job = core::Job;
+
+    // workerCount == 0 picks hardware_concurrency() - 1 (the calling thread
+    // also runs jobs while it waits)
+    explicit JobSystem(unsigned int workerCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Engine-wide pool
+    static JobSystem& getInstance();
+
+    // Queue a job; `counter` (optional) is decremented when it finishes
+    void submit(Job job, JobCounter* counter = nullptr);
+
+    // Run queued jobs on the calling thread until `counter` reaches zero
+    void wait(JobCounter& counter);
+
+    // Run one queued job on the calling thread; false if none was queued
+    bool runPendingJob();
+
+    // Call fn(begin, end) over [0, count) in ranges of at most grainSize
+    // elements, spread across the pool, and wait for all of them
+    template <typename Func>
+    void parallelFor(std::size_t count, std::size_t grainSize, Func&& fn) {
+        grainSize = std::max<std::size_t>(1, grainSize);
+        if (count <= grainSize) {
+            if (count > 0) {
+                fn(std::size_t(0), count);
+            }
+            return;
+        }
+
+        JobCounter counter;
+        for (std::size_t begin = grainSize; begin < count; begin += grainSize) {
+            std::size_t end = std::min(count, begin + grainSize);
+            submit([&fn, begin, end] { fn(begin, end); }, &counter);
+        }
+
+        // The calling thread takes the first range itself
+        fn(std::size_t(0), grainSize);
+        wait(counter);
+    }
+
+    unsigned int getWorkerCount() const { return static_cast<unsigned int>(m_workers.size()); }
+
+private:
+    struct QueuedJob {
+        Job job;
+        JobCounter* counter = nullptr;
+    };
+
+    // Ring buffer that grows but never shrinks, so steady-state submits do
+    // not allocate
+    struct WorkQueue {
+        std::vector<QueuedJob> jobs;
+        std::size_t head = 0;
+        std::size_t count = 0;
+        std::mutex mutex;
+
+        void pushBack(QueuedJob&& job);
+        bool popBack(QueuedJob& job);
+        bool popFront(QueuedJob& job);
+    };
+
+    std::vector<std::thread> m_workers;
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+    std::atomic<std::size_t> m_queuedJobs{0};
+    std::atomic<std::size_t> m_nextQueue{0};
+
+    // Idle workers sleep here until a job is queued
+    std::mutex m_sleepMutex;
+    std::condition_variable m_condition;
+    bool m_running;
+
+    void workerLoop(std::size_t index);
+    bool popJob(std::size_t queueIndex, QueuedJob& job);
+    bool stealJob(std::size_t thiefIndex, QueuedJob& job);
+    static void execute(QueuedJob& job);
+
+    // Index of the calling thread's queue, or -1 if it is not one of our workers
+    int currentWorkerIndex() const;
+};
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+namespace engine {
+namespace core {
+
+// Counts general-heap allocations (every global operator new) across all
+// threads. The counting operator new is only compiled in when the engine is
+// built with ENGINE_TRACK_ALLOCATIONS; otherwise the counts stay at zero
+// and isEnabled() is false.
+class AllocationCounter {
+public:
+    static bool isEnabled();
+
+    // Totals since startup
+    static std::uint64_t getCount();
+    static std::uint64_t getBytes();
+};
+
+// Allocations made on any thread between construction and getCount()
+class AllocationScope {
+public:
+    AllocationScope() : m_start(AllocationCounter::getCount()) {}
+
+    std::uint64_t getCount() const { return AllocationCounter::getCount() - m_start; }
+
+private:
+    std::uint64_t m_start;
+};
+
+} // namespace core
+} // namespace engine
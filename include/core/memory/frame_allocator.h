@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace engine {
+namespace core {
+
+// Bump allocator for transient per-frame data: scratch arrays, gathered
+// draw lists, job ranges.
+//
+// Double-buffered: memory handed out during frame N stays valid until the
+// end of frame N + 1, so data built during update() can be read by render()
+// and by the next frame's jobs. endFrame() switches buffers and releases
+// everything from the frame before. Nothing is freed individually.
+//
+// allocate() is lock-free and safe from any thread. If a frame outgrows its
+// buffer the rest comes from the general heap, and the buffer is enlarged
+// to fit when it is next reset, so steady-state frames never touch the heap.
+class FrameAllocator {
+public:
+    explicit FrameAllocator(std::size_t capacity = 4 * 1024 * 1024);
+
+    FrameAllocator(const FrameAllocator&) = delete;
+    FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+    // Engine-wide allocator, reset by ECSManager::refresh() at frame end
+    static FrameAllocator& getInstance();
+
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+    // Uninitialized storage for `count` objects of type T
+    template <typename T>
+    T* allocateArray(std::size_t count) {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // Switch buffers, releasing the frame before the one that just ended.
+    // Must not run concurrently with allocate().
+    void endFrame();
+
+    // Bytes handed out so far this frame, including heap overflow
+    std::size_t getUsed() const;
+
+    std::size_t getCapacity() const { return m_buffers[m_current].capacity; }
+
+private:
+    struct Buffer {
+        std::unique_ptr<std::byte[]> memory;
+        std::size_t capacity = 0;
+        std::atomic<std::size_t> offset{0};
+
+        // Allocations that did not fit, freed on reset
+        std::vector<std::unique_ptr<std::byte[]>> overflow;
+        std::size_t overflowBytes = 0;
+        std::mutex overflowMutex;
+    };
+
+    Buffer m_buffers[2];
+    int m_current = 0;
+
+    void* allocateOverflow(Buffer& buffer, std::size_t size, std::size_t alignment);
+    static void reset(Buffer& buffer);
+};
+
+// Standard library allocator backed by a FrameAllocator. deallocate() is a
+// no-op, so containers using it must not outlive the allocator's frame.
+template <typename T>
+class FrameStlAllocator {
+public:
+    using value_type = T;
+
+    FrameStlAllocator() noexcept : m_allocator(&FrameAllocator::getInstance()) {}
+    explicit FrameStlAllocator(FrameAllocator& allocator) noexcept : m_allocator(&allocator) {}
+
+    template <typename U>
+    FrameStlAllocator(const FrameStlAllocator<U>& other) noexcept : m_allocator(other.getAllocator()) {}
+
+    T* allocate(std::size_t count) { return m_allocator->allocateArray<T>(count); }
+    void deallocate(T*, std::size_t) noexcept {}
+
+    FrameAllocator* getAllocator() const noexcept { return m_allocator; }
+
+    template <typename U>
+    bool operator==(const FrameStlAllocator<U>& other) const noexcept {
+        return m_allocator == other.getAllocator();
+    }
+    template <typename U>
+    bool operator!=(const FrameStlAllocator<U>& other) const noexcept {
+        return m_allocator != other.getAllocator();
+    }
+
+private:
+    FrameAllocator* m_allocator;
+};
+
+// Scratch vector living in the current frame
+template <typename T>
+using FrameVector = std::vector<T, FrameStlAllocator<T>>;
+
+} // namespace core
+} // namespace engine
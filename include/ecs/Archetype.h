@@ -0,0 +1,150 @@
+#pragma once
+#include "Entity.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace Engine {
+namespace ECS {
+
+// Size, alignment and type-erased lifecycle operations for a component type.
+// Archetype chunks store components by value, so they need these to move
+// components between archetypes and to destroy them in place.
+struct ComponentTypeInfo {
+    std::size_t size;
+    std::size_t alignment;
+    void (*moveConstruct)(void* destination, void* source);
+    void (*destroy)(void* component);
+};
+
+template <typename T>
+const ComponentTypeInfo& getComponentTypeInfo() {
+    static const ComponentTypeInfo info = {
+        sizeof(T),
+        alignof(T),
+        [](void* destination, void* source) {
+            new (destination) T(std::move(*static_cast<T*>(source)));
+        },
+        [](void* component) {
+            static_cast<T*>(component)->~T();
+        }
+    };
+    return info;
+}
+
+// An archetype owns every entity whose ComponentMask, less its sparse-set
+// components, is exactly `mask`.
+// Components are packed by value in fixed-size chunks: each chunk holds
+// `chunkCapacity` rows, laid out as one contiguous array per component type
+// (plus an array of owning Entity pointers), so iterating one component type
+// over an archetype is a linear walk through memory.
+//
+// Rows are dense: removing a row moves the last row into the hole. Component
+// references are therefore only stable until the next structural change to
+// this archetype.
+//
+// Components with StoragePolicy::SparseSet are never part of an archetype;
+// they live in their ComponentPool, so adding or removing one leaves the
+// entity in place.
+class Archetype {
+public:
+    // Target chunk size in bytes; archetypes with very large rows fall back to
+    // one row per chunk.
+    static constexpr std::size_t CHUNK_SIZE = 16 * 1024;
+    static constexpr std::size_t CHUNK_ALIGNMENT = 64;
+    static constexpr std::size_t NO_COLUMN = static_cast<std::size_t>(-1);
+
+    Archetype(const ComponentMask& mask,
+              const std::vector<std::pair<ComponentID, const ComponentTypeInfo*>>& componentTypes);
+    ~Archetype();
+
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+
+    const ComponentMask& getMask() const { return mask; }
+
+    // Number of entities (rows) stored in this archetype
+    std::size_t size() const { return entityCount; }
+    bool empty() const { return entityCount == 0; }
+
+    std::size_t getChunkCapacity() const { return chunkCapacity; }
+    std::size_t getChunkCount() const { return chunks.size(); }
+
+    // Number of used rows in a chunk
+    std::size_t getChunkSize(std::size_t chunkIndex) const {
+        std::size_t first = chunkIndex * chunkCapacity;
+        return first < entityCount ? std::min(chunkCapacity, entityCount - first) : 0;
+    }
+
+    bool hasColumn(ComponentID id) const { return columnIndex[id] != NO_COLUMN; }
+
+    // Pointer to the first Entity* / component of a chunk
+    Entity** getEntities(std::size_t chunkIndex) const {
+        return reinterpret_cast<Entity**>(chunks[chunkIndex]);
+    }
+
+    template <typename T>
+    T* getColumn(std::size_t chunkIndex, ComponentID id) const {
+        return reinterpret_cast<T*>(chunks[chunkIndex] + columns[columnIndex[id]].offset);
+    }
+
+    // Address of component `id` in `row`; the column must exist
+    void* getComponent(ComponentID id, std::size_t row) const {
+        const Column& column = columns[columnIndex[id]];
+        return chunks[row / chunkCapacity] + column.offset + (row % chunkCapacity) * column.type->size;
+    }
+
+    Entity* getEntity(std::size_t row) const {
+        return getEntities(row / chunkCapacity)[row % chunkCapacity];
+    }
+
+    // Append a row for `entity`. Component slots are left uninitialised and
+    // must be constructed by the caller.
+    std::size_t allocateRow(Entity* entity);
+
+    // Destroy every component in `row`
+    void destroyRow(std::size_t row);
+
+    // Remove a row whose components have already been destroyed or moved out.
+    // The last row is moved into the hole; returns the entity that now lives
+    // in `row`, or nullptr if `row` was the last one.
+    Entity* removeRow(std::size_t row);
+
+    // Move the components shared with `destination` from `row` into
+    // `destinationRow`, destroying the ones `destination` does not store.
+    void moveRowTo(std::size_t row, Archetype& destination, std::size_t destinationRow);
+
+    // Cached transitions to the archetype with one component added / removed
+    std::array<Archetype*, MAX_COMPONENTS> addEdges{};
+    std::array<Archetype*, MAX_COMPONENTS> removeEdges{};
+
+    // Systems whose component mask this archetype satisfies, maintained by
+    // ECSManager. Moving an entity between archetypes only has to touch the
+    // systems in the XOR of the two masks.
+    SystemMask systems;
+
+private:
+    struct Column {
+        ComponentID id;
+        const ComponentTypeInfo* type;
+        std::size_t offset;
+    };
+
+    ComponentMask mask;
+    std::vector<Column> columns;
+    std::array<std::size_t, MAX_COMPONENTS> columnIndex;
+
+    std::vector<unsigned char*> chunks;
+    std::size_t chunkCapacity = 1;
+    std::size_t chunkBytes = CHUNK_SIZE;
+    std::size_t entityCount = 0;
+
+    // Compute column offsets for `capacity` rows; returns the bytes needed
+    std::size_t layoutColumns(std::size_t capacity);
+};
+
+} // namespace ECS
+} // namespace Engine
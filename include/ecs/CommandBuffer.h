@@ -0,0 +1,149 @@
+#pragma once
+#include "Entity.h"
+#include "Component.h"
+#include "Archetype.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Engine {
+namespace ECS {
+
+// Records structural changes (create / destroy entities, add / remove
+// components) and applies them later in one batch with playback().
+//
+// Recording is thread-safe, so systems running in parallel can queue changes
+// while they iterate. Component payloads are constructed in a block arena
+// owned by the buffer and moved into archetype storage at playback.
+// Playback groups the commands by entity, so an entity moves between
+// archetypes once no matter how many commands target it, and system
+// membership is updated once per entity instead of once per command.
+//
+// Entities created through the buffer get a placeholder handle (version 0)
+// that other commands in the same buffer may target. The real entity can be
+// looked up with getCreatedEntity() after playback.
+class CommandBuffer {
+public:
+    explicit CommandBuffer(ECSManager* manager) : manager(manager) {}
+    ~CommandBuffer();
+
+    CommandBuffer(const CommandBuffer&) = delete;
+    CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+    // Queue the creation of an entity; returns its placeholder handle
+    EntityHandle createEntity();
+
+    // Queue the destruction of an entity. The entity is marked for
+    // destruction at playback and removed at the next ECSManager::refresh().
+    void destroyEntity(EntityHandle handle);
+
+    // Queue adding (or replacing) a component. The component is constructed
+    // now and moved into the entity at playback.
+    template <typename T, typename... Args>
+    void addComponent(EntityHandle handle, Args&&... args) {
+        static_assert(std::is_base_of<Component, T>::value, "T must derive from Component");
+
+        std::lock_guard<std::mutex> lock(mutex);
+        void* payload = allocatePayload(sizeof(T), alignof(T));
+        new (payload) T(std::forward<Args>(args)...);
+
+        Command command;
+        command.type = CommandType::AddComponent;
+        command.target = handle;
+        command.component = getComponentID<T>();
+        command.typeInfo = &getComponentTypeInfo<T>();
+        command.payload = payload;
+        command.attach = [](Entity* owner) {
+            T& component = owner->getComponent<T>();
+            component.setOwner(owner);
+            component.init();
+        };
+        commands.push_back(command);
+    }
+
+    // Queue removing a component; does nothing if the entity lacks it
+    template <typename T>
+    void removeComponent(EntityHandle handle) {
+        static_assert(std::is_base_of<Component, T>::value, "T must derive from Component");
+
+        Command command;
+        command.type = CommandType::RemoveComponent;
+        command.target = handle;
+        command.component = getComponentID<T>();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        commands.push_back(command);
+    }
+
+    // Apply every recorded command. Must be called from the main thread
+    // while no systems are updating. Commands recorded during playback (for
+    // example from a component's init()) are applied before it returns.
+    void playback();
+
+    // Entity created for `placeholder` by the most recent playback(), or
+    // nullptr if it is unknown or has been destroyed
+    Entity* getCreatedEntity(EntityHandle placeholder) const;
+
+    static bool isPlaceholder(EntityHandle handle) { return handle.version == 0; }
+
+    bool empty() const;
+
+    // Drop every recorded command without applying it
+    void clear();
+
+private:
+    enum class CommandType : std::uint8_t {
+        DestroyEntity,
+        AddComponent,
+        RemoveComponent
+    };
+
+    struct Command {
+        CommandType type = CommandType::DestroyEntity;
+        EntityHandle target;
+        ComponentID component = 0;
+        const ComponentTypeInfo* typeInfo = nullptr;
+        void* payload = nullptr; // constructed component, owned until moved out
+        void (*attach)(Entity* owner) = nullptr; // setOwner() and init() once stored
+    };
+
+    // Component payloads are bump-allocated from these blocks; the blocks are
+    // kept and reused once the buffer has been fully played back
+    static constexpr std::size_t BLOCK_SIZE = 64 * 1024;
+    struct Block {
+        std::unique_ptr<unsigned char[]> data;
+        std::size_t size;
+    };
+
+    ECSManager* manager;
+
+    mutable std::mutex mutex;
+    std::vector<Command> commands;
+    std::vector<Command> executing; // batch being played back
+    std::uint32_t createdCount = 0;
+
+    std::vector<Block> blocks;
+    std::size_t blockIndex = 0;
+    std::size_t blockOffset = 0;
+
+    // Real handles for the placeholders of the most recent playback()
+    std::vector<EntityHandle> createdEntities;
+
+    // Caller must hold `mutex`
+    void* allocatePayload(std::size_t size, std::size_t alignment);
+
+    // Apply one batch of commands; entities for placeholders below
+    // `createdTotal` are created first
+    void apply(std::vector<Command>& batch, std::uint32_t createdTotal);
+
+    // Destroy payloads that were never moved into an entity
+    static void discardPayloads(std::vector<Command>& batch);
+};
+
+} // namespace ECS
+} // namespace Engine
@@ -0,0 +1,131 @@
+#pragma once
+#include "Entity.h"
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace Engine {
+namespace ECS {
+
+// Where the components of one type live, chosen per type with
+// ECSManager::registerComponent<T>() before the type is first used.
+enum class StoragePolicy {
+    // Packed in archetype chunks next to the entity's other components; best
+    // for components most entities have and that are iterated together
+    Archetype,
+    // Packed in a ComponentPool of their own; best for rare components, which
+    // would otherwise split archetypes and leave mostly empty chunks
+    SparseSet
+};
+
+// Type-independent part of a sparse-set pool. The sparse array maps an
+// EntityID to the component's position in the dense arrays plus one
+// (0 = absent); removal moves the last component into the hole.
+class ComponentPoolBase {
+public:
+    virtual ~ComponentPoolBase() = default;
+
+    bool contains(EntityID id) const {
+        return id < sparse.size() && sparse[id] != 0;
+    }
+
+    std::size_t size() const { return owners.size(); }
+
+    // Owning entity of each component, in dense order
+    Entity* const* getEntities() const { return owners.data(); }
+
+    // Move-construct the component at `source` into the pool for `owner`,
+    // replacing any existing one; returns the stored component
+    virtual void* insert(Entity* owner, void* source) = 0;
+
+    // Destroy the entity's component, if it has one
+    virtual void remove(EntityID id) = 0;
+
+    virtual void clear() = 0;
+
+protected:
+    std::vector<std::uint32_t> sparse;
+    std::vector<Entity*> owners;
+
+    // Dense position for a new component of `owner`
+    std::size_t append(Entity* owner) {
+        EntityID id = owner->getID();
+        if (id >= sparse.size()) {
+            sparse.resize(std::max<std::size_t>(id + 1, sparse.size() * 2), 0);
+        }
+        owners.push_back(owner);
+        sparse[id] = static_cast<std::uint32_t>(owners.size());
+        return owners.size() - 1;
+    }
+
+    // Forget `id`, moving the last owner into its position; returns that
+    // position
+    std::size_t erase(EntityID id) {
+        std::size_t position = sparse[id] - 1;
+        Entity* last = owners.back();
+        owners[position] = last;
+        sparse[last->getID()] = static_cast<std::uint32_t>(position + 1);
+        owners.pop_back();
+        sparse[id] = 0;
+        return position;
+    }
+};
+
+// Dense array of T by value plus a sparse index by EntityID. Lookups are two
+// array reads; references are only stable until the next add or remove of a
+// T.
+template <typename T>
+class ComponentPool : public ComponentPoolBase {
+public:
+    ~ComponentPool() override = default;
+
+    T& get(EntityID id) { return components[sparse[id] - 1]; }
+    const T& get(EntityID id) const { return components[sparse[id] - 1]; }
+
+    T* tryGet(EntityID id) { return contains(id) ? &get(id) : nullptr; }
+
+    // Construct the component for `owner`, replacing any existing one
+    template <typename... Args>
+    T& emplace(Entity* owner, Args&&... args) {
+        EntityID id = owner->getID();
+        if (contains(id)) {
+            T& component = get(id);
+            component.~T();
+            return *new (&component) T(std::forward<Args>(args)...);
+        }
+        append(owner);
+        return components.emplace_back(std::forward<Args>(args)...);
+    }
+
+    void* insert(Entity* owner, void* source) override {
+        return &emplace(owner, std::move(*static_cast<T*>(source)));
+    }
+
+    void remove(EntityID id) override {
+        if (!contains(id)) {
+            return;
+        }
+        std::size_t position = erase(id);
+        if (position != components.size() - 1) {
+            components[position] = std::move(components.back());
+        }
+        components.pop_back();
+    }
+
+    void clear() override {
+        components.clear();
+        owners.clear();
+        sparse.clear();
+    }
+
+    // Components in dense order, parallel to getEntities()
+    T* data() { return components.data(); }
+
+private:
+    std::vector<T> components;
+};
+
+} // namespace ECS
+} // namespace Engine
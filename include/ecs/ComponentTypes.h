@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <type_traits>
+
+namespace Engine {
+namespace ECS {
+
+// Every component type known to the ECS. A type's position in this list is
+// its ComponentID, so IDs are fixed at compile time and identical in every
+// translation unit and every run. New component types must be added here.
+class TransformComponent;
+class MeshRendererComponent;
+class CameraComponent;
+class CameraControllerComponent;
+class OrbitCameraController;
+class BroadphaseComponent;
+
+template <typename... Types>
+struct TypeList {
+    static constexpr std::size_t size = sizeof...(Types);
+};
+
+using ComponentTypeList = TypeList<
+    TransformComponent,
+    MeshRendererComponent,
+    CameraComponent,
+    CameraControllerComponent,
+    OrbitCameraController,
+    BroadphaseComponent
+>;
+
+// Position of T in a TypeList; equals the list size if T is not in it
+template <typename T, typename List>
+struct TypeIndex;
+
+template <typename T>
+struct TypeIndex<T, TypeList<>> {
+    static constexpr std::size_t value = 0;
+};
+
+template <typename T, typename Head, typename... Tail>
+struct TypeIndex<T, TypeList<Head, Tail...>> {
+    static constexpr std::size_t value =
+        std::is_same<T, Head>::value ? 0 : 1 + TypeIndex<T, TypeList<Tail...>>::value;
+};
+
+constexpr std::size_t COMPONENT_TYPE_COUNT = ComponentTypeList::size;
+
+// True if every type's ID is its position in the list, so IDs run from 0 to
+// size - 1 without gaps. Only fails if a type is listed twice.
+template <typename... Types>
+constexpr bool hasContiguousIDs(TypeList<Types...>) {
+    std::size_t position = 0;
+    return ((TypeIndex<Types, TypeList<Types...>>::value == position++) && ... && true);
+}
+
+static_assert(hasContiguousIDs(ComponentTypeList{}), "A component type is listed twice in ComponentTypeList");
+
+} // namespace ECS
+} // namespace Engine
@@ -2,12 +2,20 @@
 #include "Entity.h"
 #include "Component.h"
 #include "System.h"
+#include "Archetype.h"
+#include "ComponentPool.h"
+#include "View.h"
+#include "SystemScheduler.h"
+#include "CommandBuffer.h"
 #include <memory>
 #include <vector>
 #include <array>
 #include <unordered_map>
 #include <string>
 #include <chrono>
+#include <mutex>
+#include <optional>
+#include <ostream>
 
 // Forward declarations for external classes
 namespace engine {
@@ -33,23 +41,117 @@ class RenderSystem;
 
 class ECSManager {
     friend class Entity;
+    friend class CommandBuffer;
 
 private:
-    // Entity management
-    std::array<std::unique_ptr<Entity>, MAX_ENTITIES> entities;
-    std::vector<EntityID> freeEntities;
+    // Entity management - entities live in fixed-size pages that are
+    // allocated as the ID high-water mark grows, so Entity pointers stay
+    // stable and lookups by ID stay O(1)
+    static constexpr std::size_t ENTITY_PAGE_SHIFT = 10;
+    static constexpr std::size_t ENTITY_PAGE_SIZE = std::size_t(1) << ENTITY_PAGE_SHIFT;
+    using EntityPage = std::unique_ptr<std::optional<Entity>[]>;
+    
+    std::vector<EntityPage> entityPages;
+    std::vector<std::uint32_t> entityVersions; // one per ID ever handed out
+    std::vector<EntityID> freeEntities; // used as a stack
+    std::vector<EntityID> pendingDestroy;
     std::size_t livingEntityCount = 0;
     
-    // Component storage - vector of component arrays
-    std::array<std::vector<std::unique_ptr<Component>>, MAX_COMPONENTS> components;
+    // Bumped whenever components move in storage or the hierarchy changes
+    std::uint64_t structureVersion = 0;
+    
+    // Bumped whenever an entity's parent changes
+    std::uint64_t hierarchyVersion = 0;
+    
+    // Component storage - entities with the same archetype-stored components
+    // share an archetype
+    std::unordered_map<ComponentMask, std::unique_ptr<Archetype>> archetypes;
+    std::vector<Archetype*> archetypeList;
+    Archetype* emptyArchetype = nullptr;
+    std::array<const ComponentTypeInfo*, MAX_COMPONENTS> componentTypes{};
+    
+    // Components registered with StoragePolicy::SparseSet live in pools
+    // instead of archetype columns and are left out of archetype masks
+    std::array<std::unique_ptr<ComponentPoolBase>, MAX_COMPONENTS> pools;
+    ComponentMask sparseComponents;
+    
+    // Systems whose mask includes sparse-set components. An archetype can
+    // only tell that its entities might match them, so their membership is
+    // also checked against each entity's own mask.
+    SystemMask sparseSystems;
+    
+    // Cached queries, kept up to date as archetypes are created. Systems may
+    // request views concurrently during update(), so lookups are locked.
+    std::unordered_map<ComponentMask, std::unique_ptr<Query>> queries;
+    std::mutex queryMutex;
     
     // System management
     std::vector<std::unique_ptr<System>> systems;
+    std::vector<System*> activeSystems;
+    SystemScheduler scheduler;
+    bool parallelUpdates = true;
+    
+    // Structural changes recorded during the frame, applied by refresh()
+    CommandBuffer commandBuffer{this};
 
     static ::engine::rendering::Window* window;
+    
+    // Heap allocation tracking per frame, a frame ending at each refresh();
+    // only counts when built with ENGINE_TRACK_ALLOCATIONS
+    std::uint64_t frameAllocationStart = 0;
+    std::uint64_t lastFrameAllocations = 0;
+    
+    // Slot for `id`; the page must exist
+    std::optional<Entity>& entitySlot(EntityID id) const {
+        return entityPages[id >> ENTITY_PAGE_SHIFT][id & (ENTITY_PAGE_SIZE - 1)];
+    }
+    
+    // Allocate pages so that IDs below `count` have a slot
+    void ensureEntityPages(std::size_t count);
+
+    // Find or create the archetype for `mask`
+    Archetype* getArchetype(const ComponentMask& mask);
+
+    // Archetype reached from `source` by adding / removing one component
+    Archetype* getArchetypeWith(Archetype* source, ComponentID id);
+    Archetype* getArchetypeWithout(Archetype* source, ComponentID id);
+
+    // Move an entity's row to `destination`, carrying over shared components
+    void moveEntity(Entity* entity, Archetype* destination);
+
+    // Remove an entity's row from its archetype, destroying its components
+    void removeEntityFromArchetype(Entity* entity);
+
+    // Deactivate an entity and queue it for removal by refresh(). Called by
+    // CommandBuffer playback on the main thread.
+    void markForDestruction(Entity* entity);
+
+    // Whether entities of an archetype with `archetypeMask` can match
+    // `system`; sparse-set components are checked per entity
+    bool archetypeMatches(const System& system, const ComponentMask& archetypeMask) const {
+        return system.isInterested(archetypeMask | sparseComponents);
+    }
+    
+    // Systems `entity` currently belongs to
+    SystemMask getEntitySystems(const Entity* entity) const;
+
+    // Add / remove an entity to / from the systems whose interest flipped
+    // since it belonged to `oldSystems`
+    void updateSystemMembership(Entity* entity, const SystemMask& oldSystems);
+    
+    // Split `query` into archetype and sparse-set parts and find its archetypes
+    void initQuery(Query& query);
+    
+    // Recompute everything that depends on which components are sparse sets
+    void applyStoragePolicies();
 
 public:
-    ECSManager();
+    // `reserveHint` pre-allocates storage for that many entities; with the
+    // default of zero nothing is allocated until entities are created
+    explicit ECSManager(std::size_t reserveHint = 0);
+    
+    // Pre-allocate storage for at least `count` entities
+    void reserveEntities(std::size_t count);
 
     static engine::rendering::Window* getWindow() {
         return window;
@@ -58,37 +160,98 @@ public:
     // Create a new entity
     Entity* createEntity();
     
-    // Destroy an entity
+    // Destroy an entity at the next refresh(). Recorded in the command
+    // buffer, so it is safe to call from systems running on worker threads;
+    // the entity stays active until refresh() plays the buffer back.
     void destroyEntity(EntityID id);
+    void destroyEntity(EntityHandle handle);
     
     // Get entity by ID
     Entity* getEntity(EntityID id);
     
+    // Get entity by handle; nullptr if the handle is stale
+    Entity* getEntity(EntityHandle handle);
+    
+    // Whether `handle` still refers to the entity it was created for
+    bool isValid(EntityHandle handle) const;
+    
+    std::size_t getLivingEntityCount() const { return livingEntityCount; }
+    
+    // Changes whenever an entity gains or loses components, is destroyed or
+    // is re-parented. Component pointers cached while the version stays the
+    // same remain valid.
+    std::uint64_t getStructureVersion() const { return structureVersion; }
+    
+    // Changes whenever an entity is re-parented, including children losing
+    // a destroyed parent
+    std::uint64_t getHierarchyVersion() const { return hierarchyVersion; }
+    
+    // Choose where components of type T are stored. Must be called before
+    // the first T is added; components default to StoragePolicy::Archetype.
+    template <typename T>
+    void registerComponent(StoragePolicy policy = StoragePolicy::Archetype) {
+        ComponentID id = getComponentID<T>();
+        bool used = pools[id] && pools[id]->size() > 0;
+        for (Archetype* archetype : archetypeList) {
+            used = used || archetype->getMask()[id];
+        }
+        if (used) {
+            throw std::runtime_error("Component storage policy must be chosen before the component is used");
+        }
+        
+        componentTypes[id] = &getComponentTypeInfo<T>();
+        if (policy == StoragePolicy::SparseSet) {
+            if (!pools[id]) {
+                pools[id] = std::make_unique<ComponentPool<T>>();
+            }
+            sparseComponents.set(id);
+        } else {
+            pools[id].reset();
+            sparseComponents.reset(id);
+        }
+        applyStoragePolicies();
+    }
+    
+    StoragePolicy getStoragePolicy(ComponentID id) const {
+        return sparseComponents[id] ? StoragePolicy::SparseSet : StoragePolicy::Archetype;
+    }
+    
     // Component management methods
     template <typename T, typename... Args>
     T& addComponent(Entity* entity, Args&&... args) {
         ComponentID id = getComponentID<T>();
+        componentTypes[id] = &getComponentTypeInfo<T>();
         
-        // Ensure component storage exists
-        if (components[id].size() <= entity->getID()) {
-            components[id].resize(entity->getID() + 1);
+        T* component = nullptr;
+        SystemMask oldSystems = getEntitySystems(entity);
+        bool replacing = entity->componentMask[id];
+        if (sparseComponents[id]) {
+            // Only the pool changes, which replaces an existing component in
+            // place; adding may reallocate it
+            if (!replacing) {
+                structureVersion++;
+            }
+            component = &static_cast<ComponentPool<T>*>(pools[id].get())->emplace(
+                entity, std::forward<Args>(args)...);
+        } else {
+            if (!replacing) {
+                // Move the entity to the archetype that also has T
+                moveEntity(entity, getArchetypeWith(entity->archetype, id));
+            }
+            void* slot = entity->archetype->getComponent(id, entity->archetypeRow);
+            if (replacing) {
+                static_cast<T*>(slot)->~T();
+            }
+            component = new (slot) T(std::forward<Args>(args)...);
         }
-        
-        // Create component
-        components[id][entity->getID()] = std::make_unique<T>(std::forward<Args>(args)...);
-        auto component = static_cast<T*>(components[id][entity->getID()].get());
         component->setOwner(entity);
-        component->init();
         
         // Update entity's component mask
         entity->componentMask.set(id);
+        component->init();
         
-        // Add entity to interested systems
-        for (auto& system : systems) {
-            if (system->isInterested(entity)) {
-                system->addEntity(entity);
-            }
-        }
+        // Add entity to systems that are now interested in it
+        updateSystemMembership(entity, oldSystems);
         
         return *component;
     }
@@ -96,17 +259,35 @@ public:
     // Register a system
     template <typename T, typename... ComponentTypes>
     T* registerSystem() {
+        if (systems.size() >= MAX_SYSTEMS) {
+            throw std::runtime_error("Maximum number of systems reached");
+        }
+        
         // Create system
         auto system = std::make_unique<T>();
+        system->systemIndex = systems.size();
         // Important: Set the manager reference right after creation
         system->setManagerInternal(this);
-        system->template setComponentMask<ComponentTypes...>();
+        if constexpr (sizeof...(ComponentTypes) > 0) {
+            system->template setComponentMask<ComponentTypes...>();
+        }
         system->init();
         
-        // Find entities that match system requirements
-        for (std::size_t i = 0; i < MAX_ENTITIES; i++) {
-            if (entities[i] && entities[i]->isActive() && system->isInterested(entities[i].get())) {
-                system->addEntity(entities[i].get());
+        if ((system->componentMask & sparseComponents).any()) {
+            sparseSystems.set(system->systemIndex);
+        }
+        
+        // Only entities in matching archetypes can match the system
+        for (Archetype* archetype : archetypeList) {
+            if (!archetypeMatches(*system, archetype->getMask())) {
+                continue;
+            }
+            archetype->systems.set(system->systemIndex);
+            for (std::size_t row = 0; row < archetype->size(); row++) {
+                Entity* entity = archetype->getEntity(row);
+                if (entity->isActive() && system->isInterested(entity)) {
+                    system->addEntity(entity);
+                }
             }
         }
         
@@ -115,17 +296,37 @@ public:
         return systemPtr;
     }
     
-    // Update all systems
+    // Update all systems. Systems whose declared component access does not
+    // conflict run concurrently on the job system; structural changes
+    // (creating entities, adding or removing components) made inside
+    // System::update must be recorded in getCommandBuffer() instead.
     void update(float deltaTime);
     
+    // Run updates serially on the calling thread instead
+    void setParallelUpdates(bool enabled) { parallelUpdates = enabled; }
+    
+    // Print the schedule used by the last update()
+    void dumpSchedule(std::ostream& out) const { scheduler.dump(out); }
+    
     // Render all systems
     void render();
     
-    // Clean up destroyed entities
+    // Frame sync point: play back the command buffer, clean up destroyed
+    // entities, then end the frame, resetting the FrameAllocator
     void refresh();
     
+    // Deferred structural changes, safe to record from any thread
+    CommandBuffer& getCommandBuffer() { return commandBuffer; }
+    
     void initialize(engine::rendering::Window* gameWindow);
     void runGameLoop();
+    
+    // General-heap allocations made between the last two refresh() calls
+    // (in runGameLoop, leaving out buffer swaps and event polling);
+    // steady-state frames should make none once caches have filled up.
+    // Always 0 unless the engine is built with ENGINE_TRACK_ALLOCATIONS;
+    // reporting is left to the caller.
+    std::uint64_t getLastFrameAllocations() const { return lastFrameAllocations; }
     void processInput(float deltaTime);
     void shutdown();
     
@@ -139,6 +340,19 @@ public:
     static std::shared_ptr<engine::rendering::Material> createMaterial(const std::string& name);
 
     std::vector<Entity*> getAllEntities() const;
+
+    // Archetypes in creation order
+    const std::vector<Archetype*>& getArchetypes() const { return archetypeList; }
+    
+    // Cached query for all archetypes containing `mask`
+    const Query* getQuery(const ComponentMask& mask);
+    
+    // Typed iteration over every entity with all of ComponentTypes
+    template <typename... ComponentTypes>
+    View<ComponentTypes...> view() {
+        constexpr ComponentMask mask = makeComponentMask<ComponentTypes...>();
+        return View<ComponentTypes...>(getQuery(mask));
+    }
 };
 
 // Implementation of Entity template methods - now that ECSManager is fully defined
@@ -157,13 +371,10 @@ T& Entity::getComponent() {
         throw std::runtime_error("Entity does not have requested component");
     }
     
-    // We need to access the component through the manager
-    auto& componentArray = manager->components[id];
-    if (componentArray.size() <= this->id || !componentArray[this->id]) {
-        throw std::runtime_error("Component exists in mask but not in storage");
+    if (manager->sparseComponents[id]) {
+        return static_cast<ComponentPool<T>*>(manager->pools[id].get())->get(this->id);
     }
-    
-    return *static_cast<T*>(componentArray[this->id].get());
+    return *static_cast<T*>(archetype->getComponent(id, archetypeRow));
 }
 
 template <typename T>
@@ -176,21 +387,21 @@ void Entity::removeComponent() {
         return; // No component to remove
     }
     
-    // Remove component from storage
-    if (manager->components[id].size() > this->id) {
-        manager->components[id][this->id].reset();
+    SystemMask oldSystems = manager->getEntitySystems(this);
+    if (manager->sparseComponents[id]) {
+        // Only the pool changes
+        manager->pools[id]->remove(this->id);
+        manager->structureVersion++;
+    } else {
+        // Move to the archetype without T; the component is destroyed on the way
+        manager->moveEntity(this, manager->getArchetypeWithout(archetype, id));
     }
     
     // Update component mask
     componentMask.reset(id);
     
     // Update systems (remove entity from systems that no longer match)
-    for (auto& system : manager->systems) {
-        if (!system->isInterested(this) && 
-            std::find(system->getEntities().begin(), system->getEntities().end(), this) != system->getEntities().end()) {
-            system->removeEntity(this);
-        }
-    }
+    manager->updateSystemMembership(this, oldSystems);
 }
 
 } // namespace ECS
@@ -1,4 +1,5 @@
 #pragma once
+#include "ComponentTypes.h"
 #include <cstdint>
 #include <bitset>
 #include <array>
@@ -7,6 +8,7 @@
 #include <algorithm>
 #include <stdexcept>
 #include <memory>
+#include <type_traits>
 
 namespace Engine {
 namespace ECS {
@@ -15,43 +17,67 @@ namespace ECS {
 class Component;
 class System;
 class ECSManager;
-class TransformComponent;
+class Archetype;
 
-// Maximum number of components and entities
-constexpr std::size_t MAX_COMPONENTS = 32;
-constexpr std::size_t MAX_ENTITIES = 10000;
+// Maximum number of component types. Entity storage grows on demand.
+constexpr std::size_t MAX_COMPONENTS = 64;
+static_assert(COMPONENT_TYPE_COUNT <= MAX_COMPONENTS, "Too many component types for ComponentMask");
 
 // Component ID and ComponentMask types
 using ComponentID = std::size_t;
 using ComponentMask = std::bitset<MAX_COMPONENTS>;
 
+// Maximum number of registered systems; SystemMask has one bit per system
+constexpr std::size_t MAX_SYSTEMS = 64;
+using SystemMask = std::bitset<MAX_SYSTEMS>;
+
 // Entity ID type
 using EntityID = std::uint32_t;
 
-// Component ID generator
-inline ComponentID getNewComponentID() {
-    static ComponentID lastID = 0;
-    return lastID++;
-}
+// Generational entity handle. The version is bumped every time an ID is
+// recycled, so a handle to a destroyed entity can be detected as stale
+// instead of dangling.
+struct EntityHandle {
+    EntityID index = 0;
+    std::uint32_t version = 0; // 0 is never a live version
+
+    bool operator==(const EntityHandle& other) const {
+        return index == other.index && version == other.version;
+    }
+    bool operator!=(const EntityHandle& other) const { return !(*this == other); }
+};
 
-// Template function to get component ID for a specific type
+// Component ID of T: its index in ComponentTypeList, known at compile time
 template <typename T>
-inline ComponentID getComponentID() {
-    static_assert(std::is_base_of<Component, T>::value, "T must derive from Component");
-    static ComponentID typeID = getNewComponentID();
-    return typeID;
+constexpr ComponentID getComponentID() {
+    constexpr ComponentID id = TypeIndex<T, ComponentTypeList>::value;
+    static_assert(id < COMPONENT_TYPE_COUNT, "Component type missing from ComponentTypeList in ecs/ComponentTypes.h");
+    return id;
+}
+
+// Mask with the bit of every given component type set; const qualifiers are
+// ignored. A constant expression, so masks built from type packs cost nothing
+// at runtime.
+template <typename... ComponentTypes>
+constexpr ComponentMask makeComponentMask() {
+    return ComponentMask(((std::uint64_t(1) << getComponentID<std::remove_const_t<ComponentTypes>>()) | ... | std::uint64_t(0)));
 }
 
 // Entity class
 class Entity {
 private:
     EntityID id;
+    std::uint32_t version = 1;
     ComponentMask componentMask;
     ECSManager* manager;
     bool active = true;
     Entity* parent = nullptr;
     std::vector<Entity*> children;
 
+    // Location of this entity's components in archetype storage
+    Archetype* archetype = nullptr;
+    std::size_t archetypeRow = 0;
+
 public:
     Entity(EntityID id, ECSManager* manager) : id(id), manager(manager) {}
 
@@ -59,10 +85,18 @@ public:
     
     EntityID getID() const { return id; }
     
+    EntityHandle getHandle() const { return {id, version}; }
+    
     bool isActive() const { return active; }
-    void destroy() { active = false; }
+    
+    // Mark for destruction; the entity is removed at the next
+    // ECSManager::refresh(). Safe to call from systems on worker threads.
+    void destroy();
     
     ComponentMask getComponentMask() const { return componentMask; }
+
+    Archetype* getArchetype() const { return archetype; }
+    std::size_t getArchetypeRow() const { return archetypeRow; }
     
     // Check if entity has a specific component
     template <typename T>
@@ -83,6 +117,7 @@ public:
     void removeComponent();
     
     friend class ECSManager;
+    friend class CommandBuffer;
 
     Entity* getParent() const { return parent; }
     
@@ -0,0 +1,70 @@
+#pragma once
+#include "View.h"
+#include "core/job_system.h"
+#include "core/memory/frame_allocator.h"
+#include <algorithm>
+#include <vector>
+
+namespace Engine {
+namespace ECS {
+
+// Split a view into tasks of roughly `grainSize` entities and run fn over
+// them in parallel on the job system. Chunks larger than the grain are split,
+// and consecutive small chunks are batched into one task.
+// fn has the same signature as for View::each. It runs concurrently for
+// different entities, so it must only touch the components it is given
+// (and other data it synchronises itself); structural changes are not
+// allowed while the loop runs.
+template <typename... ComponentTypes, typename Func>
+void parallelForEach(const View<ComponentTypes...>& view, Func&& fn, std::size_t grainSize = 256,
+                     engine::core::JobSystem& jobs = engine::core::JobSystem::getInstance()) {
+    struct Range {
+        const Archetype* archetype;
+        std::size_t chunk;
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    grainSize = std::max<std::size_t>(1, grainSize);
+
+    // Views with sparse-set components walk their smallest pool, which is
+    // split into ranges of entries instead
+    if (const ComponentPoolBase* pool = view.getSmallestPool()) {
+        jobs.parallelFor(pool->size(), grainSize, [&](std::size_t begin, std::size_t end) {
+            view.eachInPool(*pool, begin, end, fn);
+        });
+        return;
+    }
+
+    // Ranges never cross a chunk; a task is a run of ranges [taskStarts[i], taskStarts[i + 1])
+    engine::core::FrameVector<Range> ranges;
+    engine::core::FrameVector<std::size_t> taskStarts;
+    std::size_t taskRows = grainSize;
+    for (const Archetype* archetype : view.getArchetypes()) {
+        for (std::size_t chunk = 0; chunk < archetype->getChunkCount(); chunk++) {
+            std::size_t rows = archetype->getChunkSize(chunk);
+            for (std::size_t begin = 0; begin < rows; begin += grainSize) {
+                std::size_t end = std::min(rows, begin + grainSize);
+                if (taskRows + (end - begin) > grainSize) {
+                    taskStarts.push_back(ranges.size());
+                    taskRows = 0;
+                }
+                ranges.push_back({archetype, chunk, begin, end});
+                taskRows += end - begin;
+            }
+        }
+    }
+    taskStarts.push_back(ranges.size());
+
+    jobs.parallelFor(taskStarts.size() - 1, 1, [&](std::size_t firstTask, std::size_t lastTask) {
+        for (std::size_t task = firstTask; task < lastTask; task++) {
+            for (std::size_t i = taskStarts[task]; i < taskStarts[task + 1]; i++) {
+                const Range& range = ranges[i];
+                View<ComponentTypes...>::eachInChunk(*range.archetype, range.chunk, range.begin, range.end, fn);
+            }
+        }
+    });
+}
+
+} // namespace ECS
+} // namespace Engine
@@ -1,7 +1,10 @@
 #pragma once
 #include "Entity.h"
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 #include <iostream>
+#include <type_traits>
 
 namespace Engine {
 namespace ECS {
@@ -10,8 +13,35 @@ namespace ECS {
 class System {
 private:
     ComponentMask componentMask;
-    std::vector<Entity*> entities;
     bool active = true;
+    
+    // Member entities as a sparse set: `entities` is dense, and
+    // entityIndex[id] is the entity's position in it plus one (0 = absent)
+    std::vector<Entity*> entities;
+    std::vector<std::uint32_t> entityIndex;
+    std::uint64_t membershipVersion = 0;
+    
+    // Bit assigned by ECSManager::registerSystem
+    std::size_t systemIndex = 0;
+    
+    // Declared component access, used by the scheduler to find conflicts
+    ComponentMask readMask;
+    ComponentMask writeMask;
+    bool mainThreadOnly = false;
+    
+    // Const-qualified component types are read, all others are written.
+    // Both masks are compile-time constants.
+    template <typename... ComponentTypes>
+    void declareAccess() {
+        constexpr ComponentMask reads((
+            (std::uint64_t(std::is_const<ComponentTypes>::value)
+                << getComponentID<std::remove_const_t<ComponentTypes>>()) | ... | std::uint64_t(0)));
+        constexpr ComponentMask writes((
+            (std::uint64_t(!std::is_const<ComponentTypes>::value)
+                << getComponentID<std::remove_const_t<ComponentTypes>>()) | ... | std::uint64_t(0)));
+        readMask |= reads;
+        writeMask |= writes;
+    }
     ECSManager* m_manager = nullptr;
 
 public:
@@ -20,49 +50,113 @@ public:
     virtual void setManagerInternal(ECSManager* manager) {
         m_manager = manager;
     }
+
+    ECSManager* getManager() const { return m_manager; }
     
     // Virtual functions for system lifecycle
     virtual void init() {
         std::cout << "System: Base init" << std::endl;
     }
-    virtual void update(float deltaTime) {
-        std::cout << "System: Base update with deltaTime " << deltaTime << std::endl;
-    }
-    virtual void render() {
-        std::cout << "System: Base render" << std::endl;
-    }
+    // Called every frame; keep them quiet
+    virtual void update(float deltaTime) {}
+    virtual void render() {}
     
     bool isActive() const { return active; }
     void setActive(bool state) { active = state; }
     
-    // Add entity to system
+    // Name shown in schedule dumps
+    virtual const char* getName() const { return "System"; }
+    
+    // Systems that touch the window or GL context must run on the main thread
+    bool isMainThreadOnly() const { return mainThreadOnly; }
+    void setMainThreadOnly(bool state) { mainThreadOnly = state; }
+    
+    const ComponentMask& getReadMask() const { return readMask; }
+    const ComponentMask& getWriteMask() const { return writeMask; }
+    
+    bool hasEntity(const Entity* entity) const {
+        EntityID id = entity->getID();
+        return id < entityIndex.size() && entityIndex[id] != 0;
+    }
+    
+    // Add entity to system; O(1), does nothing if it is already a member
     void addEntity(Entity* entity) {
+        EntityID id = entity->getID();
+        if (id >= entityIndex.size()) {
+            entityIndex.resize(std::max<std::size_t>(id + 1, entityIndex.size() * 2), 0);
+        }
+        if (entityIndex[id] != 0) {
+            return;
+        }
         entities.push_back(entity);
+        entityIndex[id] = static_cast<std::uint32_t>(entities.size());
+        membershipVersion++;
     }
     
-    // Remove entity from system
+    // Remove entity from system; O(1), the last member takes its place
     void removeEntity(Entity* entity) {
-        entities.erase(
-            std::remove(entities.begin(), entities.end(), entity),
-            entities.end()
-        );
+        if (!hasEntity(entity)) {
+            return;
+        }
+        EntityID id = entity->getID();
+        std::size_t position = entityIndex[id] - 1;
+        Entity* last = entities.back();
+        entities[position] = last;
+        entityIndex[last->getID()] = static_cast<std::uint32_t>(position + 1);
+        entities.pop_back();
+        entityIndex[id] = 0;
+        membershipVersion++;
     }
     
-    // Get entities managed by this system
+    // Get entities managed by this system, in no particular order
     const std::vector<Entity*>& getEntities() const {
         return entities;
     }
     
-    // Set component mask for system
+    // Changes whenever an entity joins or leaves the system
+    std::uint64_t getMembershipVersion() const { return membershipVersion; }
+    
+    // Set component mask for system. This also declares the system's access:
+    // const-qualified component types are only read, all others are written.
+    // Access is added to what was declared before, never dropped, since
+    // registerSystem<T, Types...>() calls this again after construction.
     template <typename... ComponentTypes>
     void setComponentMask() {
-        componentMask.reset();
-        (componentMask.set(getComponentID<ComponentTypes>()), ...);
+        constexpr ComponentMask mask = makeComponentMask<ComponentTypes...>();
+        componentMask = mask;
+        declareAccess<ComponentTypes...>();
+    }
+    
+    // Declare access to components the system uses outside its mask
+    template <typename... ComponentTypes>
+    void addComponentAccess() {
+        declareAccess<ComponentTypes...>();
+    }
+    
+    // Whether the system declared any component access at all
+    bool hasDeclaredAccess() const { return readMask.any() || writeMask.any(); }
+    
+    // Whether this system and `other` may not run concurrently. A system
+    // that declared no access may touch anything, so it conflicts with
+    // every other system and runs in registration order with them.
+    bool conflictsWith(const System& other) const {
+        if (mainThreadOnly && other.mainThreadOnly) {
+            return true;
+        }
+        if (!hasDeclaredAccess() || !other.hasDeclaredAccess()) {
+            return true;
+        }
+        return (writeMask & (other.readMask | other.writeMask)).any() ||
+               (other.writeMask & readMask).any();
     }
     
     // Check if entity matches system requirements
     bool isInterested(Entity* entity) const {
-        return (entity->getComponentMask() & componentMask) == componentMask;
+        return isInterested(entity->getComponentMask());
+    }
+    
+    bool isInterested(const ComponentMask& mask) const {
+        return (mask & componentMask) == componentMask;
     }
     
     friend class ECSManager;
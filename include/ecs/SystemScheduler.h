@@ -0,0 +1,63 @@
+#pragma once
+#include "System.h"
+#include "core/job_system.h"
+#include <atomic>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+namespace Engine {
+namespace ECS {
+
+// Runs System::update for a set of systems on the job system.
+//
+// build() turns the systems' declared component access into a dependency
+// DAG: a system depends on every earlier-registered system it conflicts
+// with (one writes what the other reads or writes, or either declared no
+// access), so conflicting systems always run in registration order while
+// independent ones run concurrently.
+// Main-thread-only systems are executed on the thread that calls run().
+class SystemScheduler {
+public:
+    // Rebuild the DAG for the active systems, in registration order. Does
+    // nothing if they are the systems it was last built for.
+    void build(const std::vector<System*>& systems);
+
+    // Forget the DAG, e.g. before the systems it refers to are destroyed
+    void clear() {
+        nodes.clear();
+        builtSystems.clear();
+    }
+
+    // Execute one frame of updates and wait for all of them to finish
+    void run(float deltaTime, engine::core::JobSystem& jobs);
+
+    // Print the generated schedule: one line per system with its stage and
+    // dependencies
+    void dump(std::ostream& out) const;
+
+private:
+    struct Node {
+        System* system;
+        std::vector<std::size_t> dependents;
+        std::vector<std::size_t> dependencies;
+        std::size_t stage = 0; // longest dependency chain leading to this node
+        std::atomic<std::size_t> remaining{0};
+    };
+
+    std::vector<std::unique_ptr<Node>> nodes;
+    std::vector<System*> builtSystems;
+
+    // Nodes ready to run on the main thread, and the batch it is running
+    std::vector<std::size_t> mainThreadReady;
+    std::vector<std::size_t> mainThreadRunning;
+    std::mutex mainThreadMutex;
+
+    void schedule(std::size_t index, float deltaTime, engine::core::JobSystem& jobs,
+                  engine::core::JobCounter& counter);
+    void complete(std::size_t index, float deltaTime, engine::core::JobSystem& jobs,
+                  engine::core::JobCounter& counter);
+};
+
+} // namespace ECS
+} // namespace Engine
@@ -0,0 +1,248 @@
+#pragma once
+#include "Archetype.h"
+#include "ComponentPool.h"
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Engine {
+namespace ECS {
+
+// The archetypes whose mask contains the archetype-stored part of `mask`,
+// plus the pools of its sparse-set part. Queries are owned and cached by
+// ECSManager, which appends newly created archetypes to every matching query,
+// so a query never has to rescan storage.
+struct Query {
+    ComponentMask mask;             // every component the query asks for
+    ComponentMask archetypeMask;    // the ones stored in archetype columns
+    std::vector<Archetype*> archetypes;
+
+    // Pool of each sparse-set component in `mask`, by ComponentID
+    std::array<ComponentPoolBase*, MAX_COMPONENTS> pools{};
+
+    bool matches(const Archetype& archetype) const {
+        return (archetype.getMask() & archetypeMask) == archetypeMask;
+    }
+
+    bool matches(const Entity& entity) const {
+        return (entity.getComponentMask() & mask) == mask;
+    }
+
+    bool hasSparseComponents() const { return mask != archetypeMask; }
+
+    // Smallest pool of a sparse-set component in the query; iterating its
+    // owners visits every match. nullptr if the query has none.
+    const ComponentPoolBase* getSmallestPool() const {
+        const ComponentPoolBase* smallest = nullptr;
+        for (ComponentID id = 0; id < COMPONENT_TYPE_COUNT; id++) {
+            if (pools[id] && (!smallest || pools[id]->size() < smallest->size())) {
+                smallest = pools[id];
+            }
+        }
+        return smallest;
+    }
+};
+
+// Typed iteration over every entity that has all of `ComponentTypes`.
+// Components are read straight out of archetype chunk columns, so a loop over
+// a view is a linear scan with no per-entity mask tests or lookups.
+// Use const component types for read-only access.
+//
+// A view that includes sparse-set components walks the smallest of their
+// pools instead, skipping owners that lack one of the other components, and
+// reads archetype components through each entity's row.
+//
+//     manager.view<TransformComponent, MeshRendererComponent>().each(
+//         [](TransformComponent& transform, MeshRendererComponent& renderer) { ... });
+//
+//     for (auto [transform, renderer] : manager.view<TransformComponent, MeshRendererComponent>()) { ... }
+template <typename... ComponentTypes>
+class View {
+public:
+    using Tuple = std::tuple<ComponentTypes&...>;
+
+    explicit View(const Query* query) : query(query) {}
+
+    // Call fn(ComponentTypes&...) or fn(Entity*, ComponentTypes&...) per entity
+    template <typename Func>
+    void each(Func&& fn) const {
+        if (const ComponentPoolBase* pool = getSmallestPool()) {
+            eachInPool(*pool, 0, pool->size(), fn);
+            return;
+        }
+        for (Archetype* archetype : query->archetypes) {
+            for (std::size_t chunk = 0; chunk < archetype->getChunkCount(); chunk++) {
+                eachInChunk(*archetype, chunk, 0, archetype->getChunkSize(chunk), fn);
+            }
+        }
+    }
+
+    // Call fn for rows [begin, end) of one chunk; the building block for
+    // chunked and parallel iteration of views without sparse-set components
+    template <typename Func>
+    static void eachInChunk(const Archetype& archetype, std::size_t chunk,
+                            std::size_t begin, std::size_t end, Func&& fn) {
+        auto columns = std::make_tuple(
+            archetype.template getColumn<ComponentTypes>(chunk, componentID<ComponentTypes>())...);
+        Entity** entities = archetype.getEntities(chunk);
+
+        for (std::size_t row = begin; row < end; row++) {
+            if constexpr (std::is_invocable_v<Func&, Entity*, ComponentTypes&...>) {
+                fn(entities[row], std::get<ComponentTypes*>(columns)[row]...);
+            } else {
+                fn(std::get<ComponentTypes*>(columns)[row]...);
+            }
+        }
+    }
+
+    // Call fn for the matching owners among entries [begin, end) of `pool`,
+    // which must be getSmallestPool()
+    template <typename Func>
+    void eachInPool(const ComponentPoolBase& pool, std::size_t begin, std::size_t end, Func&& fn) const {
+        Entity* const* entities = pool.getEntities();
+        for (std::size_t i = begin; i < end; i++) {
+            Entity* entity = entities[i];
+            if (!query->matches(*entity)) {
+                continue;
+            }
+            if constexpr (std::is_invocable_v<Func&, Entity*, ComponentTypes&...>) {
+                fn(entity, fetch<ComponentTypes>(*query, entity)...);
+            } else {
+                fn(fetch<ComponentTypes>(*query, entity)...);
+            }
+        }
+    }
+
+    // Pool iteration walks when the view has sparse-set components, else
+    // nullptr
+    const ComponentPoolBase* getSmallestPool() const { return query->getSmallestPool(); }
+
+    // Number of matching entities. Views with sparse-set components count
+    // by walking their smallest pool.
+    std::size_t size() const {
+        std::size_t count = 0;
+        if (const ComponentPoolBase* pool = getSmallestPool()) {
+            Entity* const* entities = pool->getEntities();
+            for (std::size_t i = 0; i < pool->size(); i++) {
+                count += query->matches(*entities[i]);
+            }
+            return count;
+        }
+        for (Archetype* archetype : query->archetypes) {
+            count += archetype->size();
+        }
+        return count;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    // Archetypes holding the view's archetype components; for views without
+    // sparse-set components, exactly the archetypes to iterate
+    const std::vector<Archetype*>& getArchetypes() const { return query->archetypes; }
+
+    class iterator {
+    public:
+        iterator(const Query* query, bool atEnd) : query(query), pool(query->getSmallestPool()) {
+            if (pool) {
+                entities = pool->getEntities();
+                chunkSize = pool->size();
+                row = atEnd ? chunkSize : 0;
+                skipUnmatched();
+            } else {
+                archetypeIndex = atEnd ? query->archetypes.size() : 0;
+                skipEmpty();
+            }
+        }
+
+        Tuple operator*() const {
+            if (pool) {
+                return Tuple(fetch<ComponentTypes>(*query, entities[row])...);
+            }
+            return Tuple(std::get<ComponentTypes*>(columns)[row]...);
+        }
+
+        Entity* getEntity() const {
+            return entities[row];
+        }
+
+        iterator& operator++() {
+            if (pool) {
+                row++;
+                skipUnmatched();
+            } else if (++row == chunkSize) {
+                row = 0;
+                chunk++;
+                skipEmpty();
+            }
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const {
+            return archetypeIndex == other.archetypeIndex && chunk == other.chunk && row == other.row;
+        }
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+
+    private:
+        const Query* query;
+        const ComponentPoolBase* pool;  // walked instead of archetypes if set
+        std::size_t archetypeIndex = 0;
+        std::size_t chunk = 0;
+        std::size_t row = 0;
+        std::size_t chunkSize = 0;
+        Entity* const* entities = nullptr;
+        std::tuple<ComponentTypes*...> columns;
+
+        // Advance to the next non-empty chunk and cache its column pointers
+        void skipEmpty() {
+            const std::vector<Archetype*>& archetypes = query->archetypes;
+            while (archetypeIndex < archetypes.size()) {
+                const Archetype* archetype = archetypes[archetypeIndex];
+                if (chunk < archetype->getChunkCount() && archetype->getChunkSize(chunk) > 0) {
+                    chunkSize = archetype->getChunkSize(chunk);
+                    entities = archetype->getEntities(chunk);
+                    columns = std::make_tuple(
+                        archetype->template getColumn<ComponentTypes>(chunk, componentID<ComponentTypes>())...);
+                    return;
+                }
+                archetypeIndex++;
+                chunk = 0;
+            }
+            chunk = 0;
+            row = 0;
+        }
+
+        // Advance to the next pool owner that has every component
+        void skipUnmatched() {
+            while (row < chunkSize && !query->matches(*entities[row])) {
+                row++;
+            }
+        }
+    };
+
+    iterator begin() const { return iterator(query, false); }
+    iterator end() const { return iterator(query, true); }
+
+private:
+    const Query* query;
+
+    template <typename T>
+    static ComponentID componentID() {
+        return getComponentID<std::remove_const_t<T>>();
+    }
+
+    // Component T of an entity the query matches
+    template <typename T>
+    static T& fetch(const Query& query, Entity* entity) {
+        ComponentID id = componentID<T>();
+        if (ComponentPoolBase* pool = query.pools[id]) {
+            return static_cast<ComponentPool<std::remove_const_t<T>>*>(pool)->get(entity->getID());
+        }
+        return *static_cast<T*>(entity->getArchetype()->getComponent(id, entity->getArchetypeRow()));
+    }
+};
+
+} // namespace ECS
+} // namespace Engine
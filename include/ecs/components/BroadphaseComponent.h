@@ -0,0 +1,23 @@
+#pragma once
+#include "../Component.h"
+
+namespace Engine {
+namespace ECS {
+
+// Marks an entity for BroadphaseSystem, which reports every pair of such
+// entities whose bounding spheres overlap. The sphere is centered on the
+// entity's world position.
+class BroadphaseComponent : public Component {
+private:
+    float m_radius = 0.5f; // World units
+
+public:
+    BroadphaseComponent() = default;
+    explicit BroadphaseComponent(float radius) : m_radius(radius) {}
+
+    void setRadius(float radius) { m_radius = radius; }
+    float getRadius() const { return m_radius; }
+};
+
+} // namespace ECS
+} // namespace Engine
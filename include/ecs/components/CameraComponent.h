@@ -82,6 +82,7 @@ public:
     // Getters for matrices
     const Math::Matrix4x4& getProjectionMatrix() const;
     const Math::Matrix4x4& getViewMatrix() const;
+    // World to clip space for column vectors (clip = viewProjection * point)
     Math::Matrix4x4 getViewProjectionMatrix() const;
     
     // Camera functionality
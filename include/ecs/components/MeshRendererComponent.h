@@ -1,5 +1,6 @@
 #pragma once
 #include "../Component.h"
+#include "../math/Matrix4x4.h"
 #include "rendering/model/model.h"
 #include "rendering/model/material.h"
 #include "rendering/shader.h"
@@ -7,6 +8,8 @@
 namespace Engine {
 namespace ECS {
 
+class TransformComponent;
+
 class MeshRendererComponent : public Component {
 private:
     std::shared_ptr<engine::rendering::Model> m_model;
@@ -25,7 +28,7 @@ public:
         m_material = material;
     }
     
-    std::shared_ptr<engine::rendering::Model> getModel() const {
+    const std::shared_ptr<engine::rendering::Model>& getModel() const {
         return m_model;
     }
     
@@ -51,6 +54,11 @@ public:
     
     void render(engine::rendering::Shader& shader);
     
+    // Render with an already resolved transform, avoiding a component lookup.
+    // Uploads its world matrix as "model" and its normal matrix as
+    // "normalMatrix".
+    void render(engine::rendering::Shader& shader, const TransformComponent& transform);
+    
     // Component interface implementation
     virtual void init() override;
     virtual void update(float deltaTime) override;
@@ -47,26 +47,36 @@ public:
         // Register input callbacks
         GLFWwindow* nativeWindow = m_window->getNativeWindow();
         
-        // Store this component in GLFW user pointer for callbacks
-        glfwSetWindowUserPointer(nativeWindow, this);
+        // Store the owning entity in the GLFW user pointer for callbacks. The
+        // component itself is relocated whenever its entity changes archetype,
+        // so it is looked up again on every callback.
+        glfwSetWindowUserPointer(nativeWindow, getOwner());
         
         // Set up mouse callbacks
         glfwSetMouseButtonCallback(nativeWindow, [](GLFWwindow* window, int button, int action, int mods) {
-            auto controller = static_cast<OrbitCameraController*>(glfwGetWindowUserPointer(window));
+            auto controller = fromWindow(window);
             if (controller) controller->mouseButtonCallback(window, button, action, mods);
         });
         
         glfwSetCursorPosCallback(nativeWindow, [](GLFWwindow* window, double xpos, double ypos) {
-            auto controller = static_cast<OrbitCameraController*>(glfwGetWindowUserPointer(window));
+            auto controller = fromWindow(window);
             if (controller) controller->cursorPosCallback(window, xpos, ypos);
         });
         
         glfwSetScrollCallback(nativeWindow, [](GLFWwindow* window, double xoffset, double yoffset) {
-            auto controller = static_cast<OrbitCameraController*>(glfwGetWindowUserPointer(window));
+            auto controller = fromWindow(window);
             if (controller) controller->scrollCallback(window, xoffset, yoffset);
         });
     }
     
+    static OrbitCameraController* fromWindow(GLFWwindow* window) {
+        auto entity = static_cast<Entity*>(glfwGetWindowUserPointer(window));
+        if (!entity || !entity->hasComponent<OrbitCameraController>()) {
+            return nullptr;
+        }
+        return &entity->getComponent<OrbitCameraController>();
+    }
+    
     void update(float deltaTime) override {
         // Process keyboard input for panning
         processKeyboardInput(deltaTime);
@@ -3,7 +3,9 @@
 #include "../math/Vector.h"
 #include "../math/Quaternion.h"
 #include "../math/Matrix4x4.h"
+#include "../math/Affine3x4.h"
 #include "../components/CameraComponent.h"
+#include <cstdint>
 #include <iostream>
 
 namespace Engine {
@@ -15,9 +17,25 @@ public:
     Math::Quaternion rotation;
     Math::Vector3 scale;
     
-    // Cached world matrix
+    // Cached world matrix, computed by TransformSystem. Setters only flag
+    // this transform; the system recomputes its descendants as well.
     mutable bool worldMatrixDirty = true;
-    mutable Math::Matrix4x4 worldMatrix;
+    mutable Math::Affine3x4 worldMatrix;
+    
+    // Set along with worldMatrixDirty, but only cleared by TransformSystem.
+    // An on-demand getWorldMatrix() clears worldMatrixDirty alone, so the
+    // system still knows the descendants need recomputing.
+    mutable bool localChanged = true;
+    
+    // Incremented whenever worldMatrix is recomputed, so readers can tell
+    // whether it changed since they last looked
+    mutable std::uint32_t worldMatrixVersion = 0;
+    
+    // Inverse world and normal matrix, derived from worldMatrix the first time
+    // either is asked for after it changes
+    mutable bool inverseMatricesDirty = true;
+    mutable Math::Affine3x4 inverseWorldMatrix;
+    mutable Math::Matrix3x3 normalMatrix;
     
     TransformComponent() 
         : position(Math::Vector3::zero()),
@@ -44,17 +62,24 @@ public:
     // Mark the transform as dirty when any property changes
     void setPosition(const Math::Vector3& newPosition) {
         position = newPosition;
-        worldMatrixDirty = true;
+        markChanged();
     }
     
     void setRotation(const Math::Quaternion& newRotation) {
         rotation = newRotation;
-        worldMatrixDirty = true;
+        markChanged();
     }
     
     void setScale(const Math::Vector3& newScale) {
         scale = newScale;
+        markChanged();
+    }
+    
+    // Flag the world matrix of this transform and its descendants as stale,
+    // e.g. after writing position, rotation or scale directly
+    void markChanged() {
         worldMatrixDirty = true;
+        localChanged = true;
     }
     
     // Calculate and return the local transformation matrix
@@ -62,10 +87,12 @@ public:
         return Math::Matrix4x4::createTRS(position, rotation, scale);
     }
     
-    // Calculate and return the world transformation matrix
-    Math::Matrix4x4 getWorldMatrix() const {
+    // World transformation matrix as of the last TransformSystem update. A
+    // transform that has not been through the system yet is computed on
+    // demand by walking up its parents.
+    const Math::Affine3x4& getWorldMatrix() const {
         if (worldMatrixDirty) {
-            worldMatrix = getLocalMatrix();
+            worldMatrix = Math::Affine3x4::createTRS(position, rotation, scale);
             
             // If this entity has a parent with a transform component, multiply by parent's world matrix
             Entity* owner = getOwner();
@@ -77,20 +104,35 @@ public:
             }
             
             worldMatrixDirty = false;
+            worldMatrixVersion++;
+            inverseMatricesDirty = true;
         }
         
         return worldMatrix;
     }
     
+    // World-to-local transform, e.g. for picking
+    const Math::Affine3x4& getInverseWorldMatrix() const {
+        updateInverseMatrices();
+        return inverseWorldMatrix;
+    }
+    
+    // Inverse transpose of the world matrix's 3x3 part, for transforming
+    // normals; upload it next to the model matrix
+    const Math::Matrix3x3& getNormalMatrix() const {
+        updateInverseMatrices();
+        return normalMatrix;
+    }
+    
     // Transformation utility methods
     void translate(const Math::Vector3& translation) {
         position = position + translation;
-        worldMatrixDirty = true;
+        markChanged();
     }
     
     void rotate(const Math::Quaternion& rotation) {
         this->rotation = rotation * this->rotation;
-        worldMatrixDirty = true;
+        markChanged();
     }
     
     // Look at a target position
@@ -120,17 +162,27 @@ public:
         
         // Extract rotation as quaternion
         rotation = Math::Quaternion::fromMatrix(lookMatrix);
-        worldMatrixDirty = true;
+        markChanged();
     }
     
     // Override functions from Component base class
     virtual void init() override {
-        worldMatrixDirty = true;
+        markChanged();
     }
     
     virtual void update(float deltaTime) override {
         // If there are animation or dynamic updates to transform, they would go here
     }
+
+private:
+    void updateInverseMatrices() const {
+        const Math::Affine3x4& world = getWorldMatrix();
+        if (inverseMatricesDirty) {
+            inverseWorldMatrix = world.inverse();
+            normalMatrix = world.normalMatrix();
+            inverseMatricesDirty = false;
+        }
+    }
 };
 
 } // namespace ECS
@@ -0,0 +1,61 @@
+#pragma once
+#include "Vector.h"
+#include "Matrix3x3.h"
+#include "Simd.h"
+#include <array>
+
+namespace Engine {
+namespace Math {
+
+class Quaternion;
+class Matrix4x4;
+
+// Affine transform stored as the top three rows of a 4x4 matrix; the bottom
+// row is always (0, 0, 0, 1) and is not stored. Used for TRS and world
+// matrices, which are always affine: 12 floats instead of 16 and a cheaper
+// product and inverse than Matrix4x4. Expanded to 4x4 only at GPU upload.
+class Affine3x4 {
+public:
+    // Row-major storage (data[row * 4 + col]), so each row loads as one SIMD
+    // register and holds three basis components plus the translation
+    alignas(16) std::array<float, 12> data;
+
+    Affine3x4();
+
+    // Drops the bottom row, which must be (0, 0, 0, 1)
+    explicit Affine3x4(const Matrix4x4& m);
+
+    // Access elements (row, column); rows 0-2 only
+    float& operator()(int row, int col) { return data[row * 4 + col]; }
+    float operator()(int row, int col) const { return data[row * 4 + col]; }
+
+    // Affine product, as if both were full 4x4 matrices
+    Affine3x4 operator*(const Affine3x4& m) const;
+
+    Vector3 transformPoint(const Vector3& point) const;
+    Vector3 transformVector(const Vector3& vector) const;
+
+    Vector3 getTranslation() const { return Vector3(data[3], data[7], data[11]); }
+
+    // Inverse of the full affine transform; identity if it is singular
+    Affine3x4 inverse() const;
+
+    // Inverse of a rotation plus translation (no scale): the transposed
+    // rotation with the translation rotated back
+    Affine3x4 inverseRigid() const;
+
+    // Inverse transpose of the 3x3 part, for transforming normals
+    Matrix3x3 normalMatrix() const;
+
+    // Equivalent to Matrix4x4::createTRS
+    static Affine3x4 createTRS(const Vector3& position, const Quaternion& rotation, const Vector3& scale);
+
+    static Affine3x4 identity();
+
+    Matrix4x4 toMatrix4x4() const;
+};
+
+static_assert(sizeof(Affine3x4) == 12 * sizeof(float), "Affine3x4 must be 12 packed floats");
+
+} // namespace Math
+} // namespace Engine
@@ -0,0 +1,114 @@
+#pragma once
+#include "Vector.h"
+#include "Affine3x4.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Engine {
+namespace Math {
+
+// Axis-aligned bounding box. A default-constructed box is empty (min > max)
+// and grows to fit whatever is merged into it.
+struct AABB {
+    Vector3 min = Vector3(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                          std::numeric_limits<float>::max());
+    Vector3 max = Vector3(-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(),
+                          -std::numeric_limits<float>::max());
+
+    AABB() = default;
+    AABB(const Vector3& min, const Vector3& max) : min(min), max(max) {}
+
+    bool isEmpty() const { return min.x > max.x || min.y > max.y || min.z > max.z; }
+
+    Vector3 center() const { return (min + max) * 0.5f; }
+    Vector3 extents() const { return (max - min) * 0.5f; }
+
+    // Half the surface area; only used to compare boxes
+    float halfArea() const {
+        Vector3 d = max - min;
+        return d.x * d.y + d.y * d.z + d.z * d.x;
+    }
+
+    bool contains(const AABB& box) const {
+        return min.x <= box.min.x && min.y <= box.min.y && min.z <= box.min.z &&
+               max.x >= box.max.x && max.y >= box.max.y && max.z >= box.max.z;
+    }
+
+    bool intersects(const AABB& box) const {
+        return min.x <= box.max.x && max.x >= box.min.x &&
+               min.y <= box.max.y && max.y >= box.min.y &&
+               min.z <= box.max.z && max.z >= box.min.z;
+    }
+
+    AABB expanded(float margin) const {
+        Vector3 offset(margin, margin, margin);
+        return AABB(min - offset, max + offset);
+    }
+
+    static AABB merged(const AABB& a, const AABB& b) {
+        return AABB(Vector3(std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z)),
+                    Vector3(std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z)));
+    }
+
+    void merge(const Vector3& point) {
+        min = Vector3(std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z));
+        max = Vector3(std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z));
+    }
+
+    void merge(const AABB& box) {
+        if (!box.isEmpty()) {
+            merge(box.min);
+            merge(box.max);
+        }
+    }
+
+    // Box around this box after an affine transform: the transformed center
+    // plus the extents projected onto each world axis
+    AABB transformed(const Affine3x4& m) const {
+        if (isEmpty()) {
+            return *this;
+        }
+        Vector3 c = m.transformPoint(center());
+        Vector3 e = extents();
+        Vector3 worldExtents(std::fabs(m(0, 0)) * e.x + std::fabs(m(0, 1)) * e.y + std::fabs(m(0, 2)) * e.z,
+                             std::fabs(m(1, 0)) * e.x + std::fabs(m(1, 1)) * e.y + std::fabs(m(1, 2)) * e.z,
+                             std::fabs(m(2, 0)) * e.x + std::fabs(m(2, 1)) * e.y + std::fabs(m(2, 2)) * e.z);
+        return AABB(c - worldExtents, c + worldExtents);
+    }
+};
+
+// Bounding sphere; a negative radius marks it empty
+struct BoundingSphere {
+    Vector3 center;
+    float radius = -1.0f;
+
+    BoundingSphere() = default;
+    BoundingSphere(const Vector3& center, float radius) : center(center), radius(radius) {}
+
+    bool isEmpty() const { return radius < 0.0f; }
+
+    bool intersects(const AABB& box) const {
+        // Squared distance from the center to the closest point of the box
+        float dx = std::max(box.min.x - center.x, std::max(0.0f, center.x - box.max.x));
+        float dy = std::max(box.min.y - center.y, std::max(0.0f, center.y - box.max.y));
+        float dz = std::max(box.min.z - center.z, std::max(0.0f, center.z - box.max.z));
+        return dx * dx + dy * dy + dz * dz <= radius * radius;
+    }
+
+    // Sphere around this sphere after an affine transform, scaled by the
+    // largest axis scale so it stays conservative under non-uniform scale
+    BoundingSphere transformed(const Affine3x4& m) const {
+        if (isEmpty()) {
+            return *this;
+        }
+        float sx = m(0, 0) * m(0, 0) + m(1, 0) * m(1, 0) + m(2, 0) * m(2, 0);
+        float sy = m(0, 1) * m(0, 1) + m(1, 1) * m(1, 1) + m(2, 1) * m(2, 1);
+        float sz = m(0, 2) * m(0, 2) + m(1, 2) * m(1, 2) + m(2, 2) * m(2, 2);
+        float maxScale = std::sqrt(std::max(sx, std::max(sy, sz)));
+        return BoundingSphere(m.transformPoint(center), radius * maxScale);
+    }
+};
+
+} // namespace Math
+} // namespace Engine
@@ -0,0 +1,48 @@
+#pragma once
+#include "Vector.h"
+#include "Matrix4x4.h"
+#include "Bounds.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace Engine {
+namespace Math {
+
+// Plane with a unit normal; points with distanceTo(p) >= 0 are on the inner
+// side
+struct Plane {
+    Vector3 normal;
+    float distance = 0.0f;
+
+    float distanceTo(const Vector3& point) const { return normal.dot(point) + distance; }
+};
+
+// View frustum as six inward-facing planes, for culling world-space bounds
+class Frustum {
+public:
+    enum PlaneIndex { Left, Right, Bottom, Top, Near, Far, PLANE_COUNT };
+
+    Frustum() = default;
+
+    // Planes of a matrix taking world space to clip space with column
+    // vectors (clip = viewProjection * point), as returned by
+    // CameraComponent::getViewProjectionMatrix
+    explicit Frustum(const Matrix4x4& viewProjection);
+
+    const Plane& getPlane(int index) const { return planes[index]; }
+
+    bool intersects(const BoundingSphere& sphere) const;
+    bool intersects(const AABB& box) const;
+
+    // Tests `count` spheres given as separate center/radius arrays, four at a
+    // time, writing 1 to visible[i] if sphere i intersects the frustum and 0
+    // otherwise. Returns the number of visible spheres.
+    std::size_t cullSpheres(const float* centerX, const float* centerY, const float* centerZ,
+                            const float* radius, std::size_t count, std::uint8_t* visible) const;
+
+private:
+    Plane planes[PLANE_COUNT];
+};
+
+} // namespace Math
+} // namespace Engine
@@ -0,0 +1,46 @@
+#pragma once
+#include "Vector.h"
+#include <array>
+
+namespace Engine {
+namespace Math {
+
+// 3x3 matrix, mainly for normal matrices. Column-major like Matrix4x4, so
+// Shader::setMat3 uploads it the same way as setMat4.
+class Matrix3x3 {
+public:
+    std::array<float, 9> data;
+
+    Matrix3x3() {
+        data = {1.0f, 0.0f, 0.0f,
+                0.0f, 1.0f, 0.0f,
+                0.0f, 0.0f, 1.0f};
+    }
+
+    // Access elements (row, column)
+    float& operator()(int row, int col) { return data[col * 3 + row]; }
+    float operator()(int row, int col) const { return data[col * 3 + row]; }
+
+    Vector3 operator*(const Vector3& v) const {
+        return Vector3(data[0] * v.x + data[3] * v.y + data[6] * v.z,
+                       data[1] * v.x + data[4] * v.y + data[7] * v.z,
+                       data[2] * v.x + data[5] * v.y + data[8] * v.z);
+    }
+
+    Matrix3x3 transposed() const {
+        Matrix3x3 result;
+        for (int row = 0; row < 3; row++) {
+            for (int col = 0; col < 3; col++) {
+                result(row, col) = (*this)(col, row);
+            }
+        }
+        return result;
+    }
+
+    static Matrix3x3 identity() { return Matrix3x3(); }
+};
+
+static_assert(sizeof(Matrix3x3) == 9 * sizeof(float), "Matrix3x3 must be 9 packed floats");
+
+} // namespace Math
+} // namespace Engine
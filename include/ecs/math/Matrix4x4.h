@@ -1,5 +1,6 @@
 #pragma once
 #include "Vector.h"
+#include "Simd.h"
 #include <array>
 #include <cmath>
 #include <glm/glm.hpp>
@@ -12,8 +13,9 @@ class Quaternion;
 
 class Matrix4x4 {
 public:
-    // Column-major storage (OpenGL style)
-    std::array<float, 16> data;
+    // Column-major storage (OpenGL style), aligned so columns load as one
+    // SIMD register
+    alignas(16) std::array<float, 16> data;
     
     Matrix4x4();
     
@@ -24,6 +26,18 @@ public:
     // Matrix multiplication
     Matrix4x4 operator*(const Matrix4x4& m) const;
     
+    Matrix4x4 transposed() const;
+    
+    // Inverse of any invertible matrix; identity if it is singular
+    Matrix4x4 inverse() const;
+    
+    // Inverse of a matrix whose bottom row is (0, 0, 0, 1)
+    Matrix4x4 inverseAffine() const;
+    
+    // Inverse of a rotation plus translation (no scale): the transposed
+    // rotation with the translation rotated back
+    Matrix4x4 inverseRigid() const;
+    
     // Create translation matrix
     static Matrix4x4 createTranslation(const Vector3& position);
     
@@ -33,7 +47,7 @@ public:
     // Create rotation matrix from quaternion - declaration only
     static Matrix4x4 createRotation(const Quaternion& q);
     
-    // Create transformation matrix - declaration only
+    // Create transformation matrix, equivalent to T * R * S
     static Matrix4x4 createTRS(const Vector3& position, const Quaternion& rotation, const Vector3& scale);
     
     // Create identity matrix
@@ -47,5 +61,8 @@ public:
 
 };
 
+// Shader::setMat4 uploads the storage directly, so it must be 16 packed floats
+static_assert(sizeof(Matrix4x4) == 16 * sizeof(float), "Matrix4x4 must be 16 packed floats");
+
 } // namespace Math
 } // namespace Engine
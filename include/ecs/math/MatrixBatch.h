@@ -0,0 +1,27 @@
+#pragma once
+#include "Vector.h"
+#include "Quaternion.h"
+#include "Matrix4x4.h"
+#include "Affine3x4.h"
+#include <cstddef>
+
+namespace Engine {
+namespace Math {
+
+// Batch kernels for transforming many objects per call. Inputs are separate
+// arrays per attribute; the kernels run 8 objects at a time with AVX2, 4 with
+// SSE, and fall back to the per-object functions elsewhere. Results match
+// calling the per-object functions in a loop.
+
+// out[i] = createTRS(positions[i], rotations[i], scales[i])
+void composeTRS(const Vector3* positions, const Quaternion* rotations, const Vector3* scales,
+                Matrix4x4* out, std::size_t count);
+void composeTRS(const Vector3* positions, const Quaternion* rotations, const Vector3* scales,
+                Affine3x4* out, std::size_t count);
+
+// out[i] = parents[i] * locals[i]; `out` may alias either input
+void multiplyBatch(const Matrix4x4* parents, const Matrix4x4* locals, Matrix4x4* out, std::size_t count);
+void multiplyBatch(const Affine3x4* parents, const Affine3x4* locals, Affine3x4* out, std::size_t count);
+
+} // namespace Math
+} // namespace Engine
@@ -1,6 +1,7 @@
 #pragma once
 #include "Vector.h"
 #include "Matrix4x4.h"
+#include "Simd.h"
 #include <cmath>
 
 namespace Engine {
@@ -35,12 +36,16 @@ public:
     Vector3 rotateVector(const Vector3& v) const {
         // Optimized implementation of v' = q * v * q^(-1)
         // This is the standard formula for rotating a vector by a quaternion
-        Vector3 qvec(x, y, z);
-        Vector3 uv = qvec.cross(v);
-        Vector3 uuv = qvec.cross(uv);
+        Simd::Float4 q = Simd::set(x, y, z, 0.0f);
+        Simd::Float4 vec = Simd::set(v.x, v.y, v.z, 0.0f);
+        Simd::Float4 uv = Simd::cross3(q, vec);
+        Simd::Float4 uuv = Simd::cross3(q, uv);
         
         // v + 2.0 * (q.w * uv + uuv)
-        return v + (uv * w + uuv) * 2.0f;
+        Simd::Float4 offset = Simd::multiplyAdd(uv, Simd::splat(w), uuv);
+        alignas(16) float result[4];
+        Simd::store(result, Simd::multiplyAdd(offset, Simd::splat(2.0f), vec));
+        return Vector3(result[0], result[1], result[2]);
     }
 
     // Utility functions
@@ -52,14 +57,25 @@ public:
         return *this;
     }
     
-    // Quaternion multiplication
+    // Quaternion multiplication (Hamilton product)
     Quaternion operator*(const Quaternion& q) const {
-        return Quaternion(
-            w * q.x + x * q.w + y * q.z - z * q.y,
-            w * q.y - x * q.z + y * q.w + z * q.x,
-            w * q.z + x * q.y - y * q.x + z * q.w,
-            w * q.w - x * q.x - y * q.y - z * q.z
-        );
+        // Sum of q's components, permuted and sign-flipped, weighted by ours:
+        //   w * ( q.x,  q.y,  q.z,  q.w)
+        // + x * ( q.w, -q.z,  q.y, -q.x)
+        // + y * ( q.z,  q.w, -q.x, -q.y)
+        // + z * (-q.y,  q.x,  q.w, -q.z)
+        Simd::Float4 other = Simd::loadUnaligned(&q.x);
+        Simd::Float4 result = Simd::mul(Simd::splat(w), other);
+        result = Simd::multiplyAdd(Simd::mul(Simd::splat(x), Simd::set(1.0f, -1.0f, 1.0f, -1.0f)),
+                                   Simd::shuffle<3, 2, 1, 0>(other), result);
+        result = Simd::multiplyAdd(Simd::mul(Simd::splat(y), Simd::set(1.0f, 1.0f, -1.0f, -1.0f)),
+                                   Simd::shuffle<2, 3, 0, 1>(other), result);
+        result = Simd::multiplyAdd(Simd::mul(Simd::splat(z), Simd::set(-1.0f, 1.0f, 1.0f, -1.0f)),
+                                   Simd::shuffle<1, 0, 3, 2>(other), result);
+        
+        Quaternion product;
+        Simd::storeUnaligned(&product.x, result);
+        return product;
     }
     
     // Convert to euler angles
@@ -126,6 +142,9 @@ public:
     }
 };
 
+// operator* loads and stores x, y, z, w as one 4-float vector
+static_assert(sizeof(Quaternion) == 4 * sizeof(float), "Quaternion must be four packed floats");
+
 
 } // namespace Math
 } // namespace Engine
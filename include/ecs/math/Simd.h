@@ -0,0 +1,160 @@
+#pragma once
+
+// Thin 4-wide float abstraction for the math kernels. The implementation is
+// picked at compile time: SSE on x86 (using FMA when the compiler targets it,
+// see ENGINE_ENABLE_AVX2 in CMakeLists.txt), NEON on ARM, and plain scalar
+// code everywhere else. Define ENGINE_MATH_SCALAR to force the scalar path.
+
+#if !defined(ENGINE_MATH_SCALAR) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define ENGINE_SIMD_SSE 1
+    #include <immintrin.h>
+    #if defined(__AVX2__)
+        #define ENGINE_SIMD_AVX2 1
+    #endif
+    #if defined(__FMA__)
+        #define ENGINE_SIMD_FMA 1
+    #endif
+#elif !defined(ENGINE_MATH_SCALAR) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+    #define ENGINE_SIMD_NEON 1
+    #include <arm_neon.h>
+#else
+    #define ENGINE_SIMD_SCALAR 1
+#endif
+
+namespace Engine {
+namespace Math {
+namespace Simd {
+
+#if defined(ENGINE_SIMD_SSE)
+
+using Float4 = __m128;
+
+// `p` must be 16-byte aligned
+inline Float4 load(const float* p) { return _mm_load_ps(p); }
+inline void store(float* p, Float4 v) { _mm_store_ps(p, v); }
+
+inline Float4 loadUnaligned(const float* p) { return _mm_loadu_ps(p); }
+inline void storeUnaligned(float* p, Float4 v) { _mm_storeu_ps(p, v); }
+
+inline Float4 set(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+inline Float4 splat(float value) { return _mm_set1_ps(value); }
+
+inline Float4 add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+inline Float4 sub(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+inline Float4 mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+inline Float4 min(Float4 a, Float4 b) { return _mm_min_ps(a, b); }
+
+// a * b + c
+inline Float4 multiplyAdd(Float4 a, Float4 b, Float4 c) {
+#if defined(ENGINE_SIMD_FMA)
+    return _mm_fmadd_ps(a, b, c);
+#else
+    return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+
+// Result lane i is lane Ii of v
+template <int I0, int I1, int I2, int I3>
+inline Float4 shuffle(Float4 v) {
+    return _mm_shuffle_ps(v, v, _MM_SHUFFLE(I3, I2, I1, I0));
+}
+
+inline float lane0(Float4 v) { return _mm_cvtss_f32(v); }
+
+#elif defined(ENGINE_SIMD_NEON)
+
+using Float4 = float32x4_t;
+
+inline Float4 load(const float* p) { return vld1q_f32(p); }
+inline void store(float* p, Float4 v) { vst1q_f32(p, v); }
+
+inline Float4 loadUnaligned(const float* p) { return vld1q_f32(p); }
+inline void storeUnaligned(float* p, Float4 v) { vst1q_f32(p, v); }
+
+inline Float4 set(float x, float y, float z, float w) {
+    const float values[4] = {x, y, z, w};
+    return vld1q_f32(values);
+}
+inline Float4 splat(float value) { return vdupq_n_f32(value); }
+
+inline Float4 add(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+inline Float4 sub(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+inline Float4 mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+inline Float4 min(Float4 a, Float4 b) { return vminq_f32(a, b); }
+
+inline Float4 multiplyAdd(Float4 a, Float4 b, Float4 c) {
+#if defined(__aarch64__)
+    return vfmaq_f32(c, a, b);
+#else
+    return vmlaq_f32(c, a, b);
+#endif
+}
+
+template <int I0, int I1, int I2, int I3>
+inline Float4 shuffle(Float4 v) {
+#if defined(__clang__)
+    return __builtin_shufflevector(v, v, I0, I1, I2, I3);
+#else
+    return set(vgetq_lane_f32(v, I0), vgetq_lane_f32(v, I1), vgetq_lane_f32(v, I2), vgetq_lane_f32(v, I3));
+#endif
+}
+
+inline float lane0(Float4 v) { return vgetq_lane_f32(v, 0); }
+
+#else
+
+struct Float4 {
+    float v[4];
+};
+
+inline Float4 load(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+inline void store(float* p, Float4 a) {
+    p[0] = a.v[0]; p[1] = a.v[1]; p[2] = a.v[2]; p[3] = a.v[3];
+}
+
+inline Float4 loadUnaligned(const float* p) { return load(p); }
+inline void storeUnaligned(float* p, Float4 a) { store(p, a); }
+
+inline Float4 set(float x, float y, float z, float w) { return {{x, y, z, w}}; }
+inline Float4 splat(float value) { return {{value, value, value, value}}; }
+
+inline Float4 add(Float4 a, Float4 b) {
+    return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}};
+}
+inline Float4 sub(Float4 a, Float4 b) {
+    return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}};
+}
+inline Float4 mul(Float4 a, Float4 b) {
+    return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}};
+}
+
+inline Float4 min(Float4 a, Float4 b) {
+    return {{a.v[0] < b.v[0] ? a.v[0] : b.v[0], a.v[1] < b.v[1] ? a.v[1] : b.v[1],
+             a.v[2] < b.v[2] ? a.v[2] : b.v[2], a.v[3] < b.v[3] ? a.v[3] : b.v[3]}};
+}
+
+inline Float4 multiplyAdd(Float4 a, Float4 b, Float4 c) { return add(mul(a, b), c); }
+
+template <int I0, int I1, int I2, int I3>
+inline Float4 shuffle(Float4 a) { return {{a.v[I0], a.v[I1], a.v[I2], a.v[I3]}}; }
+
+inline float lane0(Float4 a) { return a.v[0]; }
+
+#endif
+
+// Broadcast lane I of v to all lanes
+template <int I>
+inline Float4 broadcast(Float4 v) { return shuffle<I, I, I, I>(v); }
+
+// 3-component cross product of the xyz lanes; the w lane is zero if both
+// inputs have w == 0
+inline Float4 cross3(Float4 a, Float4 b) {
+    Float4 aYZX = shuffle<1, 2, 0, 3>(a);
+    Float4 bYZX = shuffle<1, 2, 0, 3>(b);
+    // (a * b.yzx - a.yzx * b).yzx
+    return shuffle<1, 2, 0, 3>(sub(mul(a, bYZX), mul(aYZX, b)));
+}
+
+} // namespace Simd
+} // namespace Math
+} // namespace Engine
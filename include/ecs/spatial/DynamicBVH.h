@@ -0,0 +1,162 @@
+#pragma once
+#include "../Entity.h"
+#include "../math/Bounds.h"
+#include "../math/Frustum.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+namespace ECS {
+
+// Dynamic bounding volume hierarchy over entity AABBs, one entity per leaf.
+//
+// Leaves store "fat" boxes, enlarged by a margin, so an entity that moves a
+// little does not touch the tree at all. A leaf that leaves its fat box is
+// refit in place while its parent still encloses it, and otherwise removed
+// and reinserted, which only touches its old and new paths to the root.
+// insert() picks the sibling that adds the least surface area, and rebuild()
+// rebuilds the whole tree top-down with a binned surface area heuristic
+// (SAH); call it after large batches of inserts.
+class DynamicBVH {
+public:
+    explicit DynamicBVH(float margin = 0.1f) : margin(margin) {}
+
+    // Add an entity, or move it if it is already in the tree
+    void insert(EntityID id, const Math::AABB& bounds);
+
+    // Move an entity already in the tree. Returns false if its fat box still
+    // contains `bounds` and nothing changed.
+    bool update(EntityID id, const Math::AABB& bounds);
+
+    // Remove an entity; does nothing if it is not in the tree
+    void remove(EntityID id);
+
+    bool contains(EntityID id) const {
+        return id < leafOf.size() && leafOf[id] != NULL_NODE;
+    }
+
+    void clear();
+
+    // Rebuild the tree over the current leaves with a binned SAH split
+    void rebuild();
+
+    std::size_t size() const { return leafCount; }
+
+    // Height of the tree, 0 when empty
+    std::size_t getHeight() const;
+
+    // Enlarged box stored for the entity; it must be in the tree
+    const Math::AABB& getFatBounds(EntityID id) const { return nodes[leafOf[id]].bounds; }
+
+    // Queries call visitor(EntityID) for every leaf whose fat box passes the
+    // test, so results are conservative
+    template <typename Visitor>
+    void queryAABB(const Math::AABB& box, Visitor&& visitor) const {
+        traverse([&box](const Math::AABB& bounds) { return bounds.intersects(box); }, visitor);
+    }
+
+    template <typename Visitor>
+    void querySphere(const Math::BoundingSphere& sphere, Visitor&& visitor) const {
+        traverse([&sphere](const Math::AABB& bounds) { return sphere.intersects(bounds); }, visitor);
+    }
+
+    template <typename Visitor>
+    void queryFrustum(const Math::Frustum& frustum, Visitor&& visitor) const {
+        traverse([&frustum](const Math::AABB& bounds) { return frustum.intersects(bounds); }, visitor);
+    }
+
+    // Leaves whose box the segment origin + t * direction, 0 <= t <= maxDistance,
+    // passes through
+    template <typename Visitor>
+    void queryRay(const Math::Vector3& origin, const Math::Vector3& direction, float maxDistance,
+                  Visitor&& visitor) const {
+        Math::Vector3 inverse(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+        traverse([&](const Math::AABB& bounds) { return rayHits(origin, inverse, maxDistance, bounds); }, visitor);
+    }
+
+private:
+    static constexpr std::int32_t NULL_NODE = -1;
+
+    struct Node {
+        Math::AABB bounds;
+        std::int32_t parent = NULL_NODE;
+        std::int32_t left = NULL_NODE;   // NULL_NODE for leaves
+        std::int32_t right = NULL_NODE;
+        EntityID id = 0;                 // leaves only
+
+        bool isLeaf() const { return left == NULL_NODE; }
+    };
+
+    float margin;
+    std::vector<Node> nodes;
+    std::int32_t root = NULL_NODE;
+    std::int32_t freeList = NULL_NODE; // linked through Node::parent
+    std::size_t leafCount = 0;
+
+    // Leaf node of each entity, NULL_NODE if absent
+    std::vector<std::int32_t> leafOf;
+
+    std::int32_t allocateNode();
+    void freeNode(std::int32_t node);
+    void insertLeaf(std::int32_t leaf);
+    void removeLeaf(std::int32_t leaf);
+    void refitAncestors(std::int32_t node);
+
+    // Leaf copy partitioned in place by rebuild()
+    struct BuildEntry {
+        Math::AABB bounds;
+        Math::Vector3 centroid;
+        std::int32_t node;
+    };
+    std::int32_t buildRange(BuildEntry* entries, std::size_t count);
+
+    static bool rayHits(const Math::Vector3& origin, const Math::Vector3& inverseDirection, float maxDistance,
+                        const Math::AABB& bounds);
+
+    // Depth-first walk that descends into nodes passing `overlaps`
+    template <typename Overlap, typename Visitor>
+    void traverse(Overlap&& overlaps, Visitor& visitor) const {
+        if (root == NULL_NODE) {
+            return;
+        }
+        // Fixed stack for the common case, spilling to the heap for very
+        // unbalanced trees
+        std::int32_t local[64];
+        std::vector<std::int32_t> spill;
+        std::size_t top = 0;
+        auto push = [&](std::int32_t node) {
+            if (top < 64) {
+                local[top] = node;
+            } else {
+                spill.push_back(node);
+            }
+            top++;
+        };
+        push(root);
+        while (top > 0) {
+            top--;
+            std::int32_t index;
+            if (top < 64) {
+                index = local[top];
+            } else {
+                index = spill.back();
+                spill.pop_back();
+            }
+
+            const Node& node = nodes[index];
+            if (!overlaps(node.bounds)) {
+                continue;
+            }
+            if (node.isLeaf()) {
+                visitor(node.id);
+            } else {
+                push(node.left);
+                push(node.right);
+            }
+        }
+    }
+};
+
+} // namespace ECS
+} // namespace Engine
@@ -0,0 +1,168 @@
+#pragma once
+#include "../Entity.h"
+#include "../math/Vector.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+namespace ECS {
+
+// Two entities whose spheres overlap, with a < b
+struct BroadphasePair {
+    EntityID a;
+    EntityID b;
+};
+
+// Hashed loose grid over entity bounding spheres, for many small objects
+// that move every frame.
+//
+// Each sphere lives in the one cell containing its center, on the finest of
+// LEVEL_COUNT grid levels (cell sizes cellSize, 2 * cellSize, 4 * cellSize,
+// ...) whose cells are at least twice its radius. Two spheres on the same
+// level can then only overlap if their cells are neighbors, and a sphere
+// only has to look at the 27 cells around it on each coarser level. Spheres
+// too large for every level go to a separate list tested against
+// everything. Moving a sphere is O(1): it is rewritten in place, or swapped
+// out of its old cell and appended to the new one.
+//
+// Cells store their spheres contiguously, so pair generation streams
+// through small arrays. Only occupied cells exist; they are found through an
+// open-addressing hash table on the packed cell coordinates, which must stay
+// within +-2^19 cells of the origin.
+class HashGrid {
+public:
+    static constexpr int LEVEL_COUNT = 8;
+
+    // `cellSize` is the finest level; choose it around twice the typical radius
+    explicit HashGrid(float cellSize = 1.0f);
+
+    // Add an entity, or move it if it is already in the grid
+    void insert(EntityID id, const Math::Vector3& center, float radius);
+
+    // Move an entity already in the grid
+    void update(EntityID id, const Math::Vector3& center, float radius);
+
+    // Remove an entity; does nothing if it is not in the grid
+    void remove(EntityID id);
+
+    bool contains(EntityID id) const {
+        return id < locationOf.size() && locationOf[id].cell != ABSENT;
+    }
+
+    void clear();
+
+    std::size_t size() const { return proxyCount; }
+    float getCellSize() const { return cellSize; }
+
+    // Replace `pairs` with every pair of overlapping spheres, grouped by cell
+    void findPairs(std::vector<BroadphasePair>& pairs) const;
+
+    // Calls visitor(EntityID) for every sphere overlapping the given one
+    template <typename Visitor>
+    void querySphere(const Math::Vector3& center, float radius, Visitor&& visitor) const {
+        auto test = [&](const Proxy& proxy) {
+            if (proxy.overlaps(center.x, center.y, center.z, radius)) {
+                visitor(proxy.id);
+            }
+        };
+        for (int level = 0; level < LEVEL_COUNT; level++) {
+            if (levelCells[level].empty()) {
+                continue;
+            }
+            // Loose cells reach half a cell past their bounds
+            float reach = radius + levelCellSize(level) * 0.5f;
+            std::int32_t lo[3], hi[3];
+            for (int axis = 0; axis < 3; axis++) {
+                float c = axis == 0 ? center.x : (axis == 1 ? center.y : center.z);
+                lo[axis] = cellCoordinate(c - reach, level);
+                hi[axis] = cellCoordinate(c + reach, level);
+            }
+            for (std::int32_t z = lo[2]; z <= hi[2]; z++) {
+                for (std::int32_t y = lo[1]; y <= hi[1]; y++) {
+                    for (std::int32_t x = lo[0]; x <= hi[0]; x++) {
+                        std::int32_t cell = findCell(packKey(level, x, y, z));
+                        if (cell != ABSENT) {
+                            for (const Proxy& proxy : cells[cell].proxies) {
+                                test(proxy);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        for (const Proxy& proxy : oversized) {
+            test(proxy);
+        }
+    }
+
+private:
+    static constexpr std::int32_t ABSENT = -1;
+    static constexpr std::int32_t OVERSIZED = -2;   // Location::cell of large spheres
+    static constexpr std::uint64_t EMPTY_KEY = ~std::uint64_t(0);
+
+    struct Proxy {
+        float x, y, z, radius;
+        EntityID id;
+
+        bool overlaps(float ox, float oy, float oz, float oradius) const {
+            float dx = x - ox, dy = y - oy, dz = z - oz;
+            float r = radius + oradius;
+            return dx * dx + dy * dy + dz * dz <= r * r;
+        }
+    };
+
+    struct Cell {
+        std::uint64_t key = EMPTY_KEY;          // EMPTY_KEY while on the free list
+        std::int32_t level = 0;
+        std::uint32_t levelSlot = 0;            // position in levelCells[level]
+        std::int32_t x = 0, y = 0, z = 0;
+        std::vector<Proxy> proxies;
+    };
+
+    struct Location {
+        std::int32_t cell = ABSENT;             // or OVERSIZED
+        std::uint32_t slot = 0;
+    };
+
+    struct Slot {
+        std::uint64_t key = EMPTY_KEY;
+        std::int32_t cell = ABSENT;
+    };
+
+    float cellSize;
+    float inverseLevelSize[LEVEL_COUNT];
+    std::size_t proxyCount = 0;
+
+    std::vector<Cell> cells;
+    std::vector<std::int32_t> freeCells;
+    std::vector<Proxy> oversized;
+    std::vector<Location> locationOf;           // by EntityID
+
+    // Occupied cells and sphere count of each level
+    std::vector<std::int32_t> levelCells[LEVEL_COUNT];
+    std::size_t levelProxyCount[LEVEL_COUNT] = {};
+
+    // Cell key -> index into `cells`; power-of-two size, linear probing
+    std::vector<Slot> table;
+    std::size_t tableCount = 0;
+
+    float levelCellSize(int level) const { return cellSize * float(1 << level); }
+
+    // Finest level for a radius, or LEVEL_COUNT if it fits none
+    int levelFor(float radius) const;
+    std::int32_t cellCoordinate(float value, int level) const;
+    static std::uint64_t packKey(int level, std::int32_t x, std::int32_t y, std::int32_t z);
+    static std::size_t hashKey(std::uint64_t key);
+
+    std::int32_t findCell(std::uint64_t key) const;
+    std::int32_t acquireCell(int level, std::int32_t x, std::int32_t y, std::int32_t z, std::uint64_t key);
+    void releaseCell(std::int32_t cell);
+    void growTable();
+
+    void place(EntityID id, const Proxy& proxy);
+    void unplace(EntityID id);
+};
+
+} // namespace ECS
+} // namespace Engine
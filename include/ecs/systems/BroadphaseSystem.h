@@ -0,0 +1,52 @@
+#pragma once
+#include "../System.h"
+#include "../ECSManager.h"
+#include "../components/TransformComponent.h"
+#include "../components/BroadphaseComponent.h"
+#include "../spatial/HashGrid.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+namespace ECS {
+
+// Finds every pair of overlapping BroadphaseComponent spheres each frame,
+// using a HashGrid keyed on world positions. Meant for many small, fast
+// objects such as projectiles and pickups, where keeping a BVH refit costs
+// more than it saves; static or large geometry belongs in
+// SpatialIndexSystem.
+//
+// Every member is moved in the grid each frame, which is O(1) per entity, so
+// there is no dirty tracking to get wrong. Choose the cell size around twice
+// the typical radius; larger spheres go to coarser grid levels.
+//
+// Register it after TransformSystem; its read access to TransformComponent
+// makes the scheduler run it after the system that writes the matrices.
+class BroadphaseSystem : public System {
+public:
+    explicit BroadphaseSystem(float cellSize = 1.0f) : grid(cellSize) {
+        setComponentMask<const TransformComponent, const BroadphaseComponent>();
+    }
+
+    const char* getName() const override { return "BroadphaseSystem"; }
+
+    void init() override {}
+
+    void update(float deltaTime) override;
+
+    // Overlapping pairs found by the last update(), each with a < b
+    const std::vector<BroadphasePair>& getPairs() const { return pairs; }
+
+    const HashGrid& getGrid() const { return grid; }
+
+private:
+    HashGrid grid;
+    std::vector<BroadphasePair> pairs;
+    std::vector<std::uint32_t> lastSeen; // frame each EntityID was last a member
+    std::vector<EntityID> indexed;       // IDs currently in the grid
+    std::uint32_t frame = 0;
+};
+
+} // namespace ECS
+} // namespace Engine
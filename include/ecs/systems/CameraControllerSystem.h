@@ -1,5 +1,7 @@
 #pragma once
 #include "../System.h"
+#include "../ECSManager.h"
+#include "../ParallelFor.h"
 #include "../components/CameraControllerComponent.h"
 #include "../components/TransformComponent.h"
 
@@ -13,14 +15,14 @@ public:
         setComponentMask<CameraControllerComponent, TransformComponent>();
     }
 
+    const char* getName() const override { return "CameraControllerSystem"; }
+
     void update(float deltaTime) override {
-        for (auto entity : getEntities()) {
-            auto& controller = entity->getComponent<CameraControllerComponent>();
-            auto& transform = entity->getComponent<TransformComponent>();
-            
-            // Pass both components to the update method
-            controller.update(deltaTime, transform);
-        }
+        parallelForEach(getManager()->view<CameraControllerComponent, TransformComponent>(),
+            [deltaTime](CameraControllerComponent& controller, TransformComponent& transform) {
+                // Pass both components to the update method
+                controller.update(deltaTime, transform);
+            });
     }
 };
 
@@ -1,12 +1,17 @@
 #pragma once
 #include "../System.h"
+#include "../ECSManager.h"
 #include "../components/TransformComponent.h"
 #include "../components/MeshRendererComponent.h"
 #include "../components/CameraComponent.h"
+#include "../math/Frustum.h"
 #include "rendering/shader.h"
+#include "rendering/render_queue.h"
 #include "rendering/window.h"
 #include "core/resource_manager.h"
 #include <vector>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <iostream>
 
@@ -17,9 +22,16 @@ namespace ECS {
 
 class RenderSystem : public System {
 public:
+    // Renderers that passed and failed frustum culling in the last render()
+    struct CullingStats {
+        std::size_t visible = 0;
+        std::size_t culled = 0;
+    };
+
     void setManager(ECSManager* manager) { m_ecsManager = manager; }
 
     void setManagerInternal(ECSManager* manager) override {
+        System::setManagerInternal(manager);
         setManager(manager);
     }
 
@@ -27,9 +39,13 @@ public:
 
     RenderSystem() {
         // Register which components this system operates on
-        setComponentMask<TransformComponent, MeshRendererComponent>();
+        setComponentMask<const TransformComponent, MeshRendererComponent>();
+        // update() only searches for the main camera
+        addComponentAccess<const CameraComponent>();
     }
 
+    const char* getName() const override { return "RenderSystem"; }
+
     virtual void init() override {
         std::cout << "RenderSystem: Initializing\n";
         // Load the default shader
@@ -40,23 +56,40 @@ public:
         );
         if (!m_defaultShader) {
             std::cerr << "RenderSystem: Failed to load shader\n";
+            return;
+        }
+        
+        // Same fragment stage; the vertex stage reads "model" and
+        // "normalMatrix" from per-instance attributes (see RenderQueue)
+        m_instancedShader = ECSManager::loadShader(
+            "defaultShaderInstanced",
+            "shaders/default_instanced.vert",
+            "shaders/default.frag"
+        );
+        if (m_instancedShader) {
+            m_renderQueue.setInstancedVariant(*m_defaultShader, m_instancedShader.get());
+        } else {
+            std::cerr << "RenderSystem: No instanced shader, drawing objects one at a time\n";
         }
     }
 
     virtual void update(float deltaTime) override {
         // Find the main camera
         m_activeCamera = findMainCamera();
+        m_time += deltaTime;
     }
 
     virtual void render() override {
-        std::cout << "RenderSystem: Starting render cycle" << std::endl;
-        // Skip rendering if no camera is available
+        // Skip rendering if no camera is available; reported once, since
+        // this runs every frame
         if (!m_activeCamera) {
-            std::cerr << "RenderSystem: No main camera found for rendering\n";
+            if (!m_reportedMissingCamera) {
+                std::cerr << "RenderSystem: No main camera found for rendering\n";
+                m_reportedMissingCamera = true;
+            }
             return;
         }
-
-        std::cout << "RenderSystem: Rendering with camera from entity " << m_activeCamera->getID() << std::endl;
+        m_reportedMissingCamera = false;
         
         // Get the camera component
         auto& camera = m_activeCamera->getComponent<CameraComponent>();
@@ -64,59 +97,145 @@ public:
         // Clear the screen
         camera.clear();
         
-        // Check if shader is available
+        // init() already reported a missing shader
         if (!m_defaultShader) {
-            std::cerr << "RenderSystem: No shader available for rendering\n";
             return;
         }
         
-        std::cout << "RenderSystem: Setting shader uniforms" << std::endl;
-        // Set up view and projection matrices
-        m_defaultShader->use();
-        m_defaultShader->setMat4("view", camera.getViewMatrix().toGLM());
-        m_defaultShader->setMat4("projection", camera.getProjectionMatrix().toGLM());
+        // Render the entities inside the camera frustum, sorted by state
+        // World matrices were computed by TransformSystem during update()
+        cullRenderers(Math::Frustum(camera.getViewProjectionMatrix()));
+        buildRenderQueue(camera.getViewMatrix());
+        updateFrameUniforms(camera);
+        m_renderQueue.submit(camera.getViewMatrix(), camera.getProjectionMatrix());
+    }
+    
+    const CullingStats& getCullingStats() const { return m_cullingStats; }
+    
+    // Draws and state changes of the last render()
+    const engine::rendering::RenderQueue::Stats& getRenderStats() const { return m_renderQueue.getStats(); }
+    
+    // Queue one draw per mesh of each visible renderer and sort them. A
+    // mesh's own material takes precedence over the renderer's. Needs no
+    // GL context.
+    void buildRenderQueue(const Math::Matrix4x4& view) {
+        m_renderQueue.clear();
+        for (const DrawItem& item : m_visibleItems) {
+            const auto& model = item.renderer->getModel();
+            const Math::Affine3x4& world = item.transform->getWorldMatrix();
+            const Math::Matrix3x3& normal = item.transform->getNormalMatrix();
+            
+            // View space looks down -z
+            Math::Vector3 center = world.transformPoint(model->getBoundingSphere().center);
+            float depth = -(view(2, 0) * center.x + view(2, 1) * center.y + view(2, 2) * center.z + view(2, 3));
+            
+            engine::rendering::Material* rendererMaterial = item.renderer->getMaterial().get();
+            const auto& meshes = model->getMeshes();
+            for (std::size_t i = 0; i < meshes.size(); i++) {
+                engine::rendering::Material* material = model->getMeshMaterial(i);
+                m_renderQueue.add(engine::rendering::RenderPass::Opaque, *m_defaultShader,
+                                  material ? material : rendererMaterial, *meshes[i], depth, world, normal);
+            }
+        }
+        m_renderQueue.sort();
+    }
+    
+    // Fill the visible list with the renderers whose model bounds intersect
+    // the frustum: a batched bounding sphere test over all of them, then a
+    // box test for the spheres that pass. Needs no GL context.
+    void cullRenderers(const Math::Frustum& frustum) {
+        m_candidates.clear();
+        m_sphereX.clear();
+        m_sphereY.clear();
+        m_sphereZ.clear();
+        m_sphereRadius.clear();
+        getManager()->view<const TransformComponent, MeshRendererComponent>().each(
+            [this](const TransformComponent& transform, MeshRendererComponent& renderer) {
+                const auto& model = renderer.getModel();
+                if (!model || !renderer.isActive() || model->getBoundingSphere().isEmpty()) {
+                    return;
+                }
+                Math::BoundingSphere sphere = model->getBoundingSphere().transformed(transform.getWorldMatrix());
+                m_candidates.push_back({&transform, &renderer});
+                m_sphereX.push_back(sphere.center.x);
+                m_sphereY.push_back(sphere.center.y);
+                m_sphereZ.push_back(sphere.center.z);
+                m_sphereRadius.push_back(sphere.radius);
+            });
+        
+        std::size_t count = m_candidates.size();
+        m_sphereVisible.resize(count);
+        frustum.cullSpheres(m_sphereX.data(), m_sphereY.data(), m_sphereZ.data(), m_sphereRadius.data(),
+                            count, m_sphereVisible.data());
         
-        std::cout << "RenderSystem: Beginning entity rendering" << std::endl;
-        // Render all entities with renderers
-        for (auto entity : getEntities()) {
-            if (entity->hasComponent<MeshRendererComponent>() && 
-                entity->hasComponent<TransformComponent>()) {
-                std::cout << "RenderSystem: Rendering entity " << entity->getID() << std::endl;
-                auto& renderer = entity->getComponent<MeshRendererComponent>();
-                auto& transform = entity->getComponent<TransformComponent>();
-                m_defaultShader->setMat4("model", transform.getWorldMatrix().toGLM());
-                renderer.render(*m_defaultShader);
+        m_visibleItems.clear();
+        for (std::size_t i = 0; i < count; i++) {
+            if (!m_sphereVisible[i]) {
+                continue;
+            }
+            const DrawItem& item = m_candidates[i];
+            const Math::AABB& bounds = item.renderer->getModel()->getBounds();
+            if (frustum.intersects(bounds.transformed(item.transform->getWorldMatrix()))) {
+                m_visibleItems.push_back(item);
             }
         }
+        
+        m_cullingStats.visible = m_visibleItems.size();
+        m_cullingStats.culled = count - m_visibleItems.size();
     }
 
 private:
+    // Upload the FrameData block once for every shader this frame
+    void updateFrameUniforms(const CameraComponent& camera) {
+        engine::rendering::FrameUniforms frame = {};
+        engine::rendering::storeMatrix(camera.getViewMatrix(), frame.view);
+        engine::rendering::storeMatrix(camera.getProjectionMatrix(), frame.projection);
+        if (m_activeCamera->hasComponent<TransformComponent>()) {
+            Math::Vector3 position = m_activeCamera->getComponent<TransformComponent>().getPosition();
+            frame.cameraPosition[0] = position.x;
+            frame.cameraPosition[1] = position.y;
+            frame.cameraPosition[2] = position.z;
+        }
+        frame.cameraPosition[3] = 1.0f;
+        frame.time = m_time;
+        m_frameUniforms.setData(frame);
+        m_frameUniforms.bind(engine::rendering::UniformBlock::Frame);
+    }
+    
+    struct DrawItem {
+        const TransformComponent* transform;
+        MeshRendererComponent* renderer;
+    };
+    
     std::shared_ptr<engine::rendering::Shader> m_defaultShader;
+    std::shared_ptr<engine::rendering::Shader> m_instancedShader;
     Entity* m_activeCamera = nullptr;
+    bool m_reportedMissingCamera = false;
     ECSManager* m_ecsManager = nullptr;
+    
+    // Culling scratch, kept between frames to reuse the allocations
+    std::vector<DrawItem> m_candidates;
+    std::vector<DrawItem> m_visibleItems;
+    std::vector<float> m_sphereX;
+    std::vector<float> m_sphereY;
+    std::vector<float> m_sphereZ;
+    std::vector<float> m_sphereRadius;
+    std::vector<std::uint8_t> m_sphereVisible;
+    CullingStats m_cullingStats;
+    engine::rendering::RenderQueue m_renderQueue;
+    engine::rendering::UniformBuffer m_frameUniforms;
+    float m_time = 0.0f;    // Seconds of update() so far
     void renderEntity(Entity* entity, const Math::Matrix4x4& worldMatrix);
     
     Entity* findMainCamera() {
-        auto entities = getManager()->getAllEntities();
-        std::cout << "RenderSystem: Searching through " << entities.size() << " entities for main camera" << std::endl;
-        
-        for (auto& entity : entities) {
-            std::cout << "RenderSystem: Checking entity " << entity->getID() 
-                      << " (active: " << entity->isActive()
-                      << ", hasCamera: " << entity->hasComponent<CameraComponent>() << ")" << std::endl;
-                      
-            if (entity && entity->isActive() && 
-                entity->hasComponent<CameraComponent>()) {
-                    
-                auto& camera = entity->getComponent<CameraComponent>();
-                std::cout << "RenderSystem: Found camera component, isMain: " << camera.isMain() << std::endl;
-                if (camera.isMain()) {
-                    std::cout << "RenderSystem: Found main camera on entity " << entity->getID() << std::endl;
-                    return entity;
-                }
+        auto cameras = getManager()->view<CameraComponent>();
+        for (auto it = cameras.begin(); it != cameras.end(); ++it) {
+            auto [camera] = *it;
+            Entity* entity = it.getEntity();
+            if (entity->isActive() && camera.isMain()) {
+                return entity;
             }
         }
-        std::cerr << "RenderSystem: No main camera found" << std::endl;
         return nullptr;
     }
 };
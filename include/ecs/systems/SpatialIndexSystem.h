@@ -0,0 +1,54 @@
+#pragma once
+#include "../System.h"
+#include "../ECSManager.h"
+#include "../components/TransformComponent.h"
+#include "../components/MeshRendererComponent.h"
+#include "../spatial/DynamicBVH.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+namespace ECS {
+
+// Keeps a DynamicBVH of the world-space bounds of every entity with a
+// transform and a model, for culling, picking and proximity queries.
+//
+// Only entities whose world matrix changed since the last update are
+// refit, using TransformComponent::worldMatrixVersion. Large batches of new
+// entities trigger a full SAH rebuild.
+//
+// Register it after TransformSystem; its read access to TransformComponent
+// makes the scheduler run it after the system that writes the matrices.
+class SpatialIndexSystem : public System {
+public:
+    SpatialIndexSystem() {
+        setComponentMask<const TransformComponent, const MeshRendererComponent>();
+    }
+
+    const char* getName() const override { return "SpatialIndexSystem"; }
+
+    void init() override {}
+
+    void update(float deltaTime) override;
+
+    const DynamicBVH& getTree() const { return tree; }
+
+private:
+    // Slack around each box, in world units, before a move touches the tree
+    static constexpr float MARGIN = 0.1f;
+
+    struct Entry {
+        EntityHandle handle;          // entity indexed under this ID
+        std::uint32_t transformVersion = 0;
+        std::uint32_t lastSeen = 0;   // frame it was last a member
+    };
+
+    DynamicBVH tree{MARGIN};
+    std::vector<Entry> entries;       // by EntityID
+    std::vector<EntityID> indexed;    // IDs currently in the tree
+    std::uint32_t frame = 0;
+};
+
+} // namespace ECS
+} // namespace Engine
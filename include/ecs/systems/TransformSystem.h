@@ -0,0 +1,74 @@
+#pragma once
+#include "../System.h"
+#include "../ECSManager.h"
+#include "../components/TransformComponent.h"
+#include "../math/Affine3x4.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+namespace ECS {
+
+// Computes the world matrix of every TransformComponent once per frame, so
+// rendering and other readers only ever see precomputed matrices.
+//
+// Transforms are kept in depth-sorted structure-of-arrays form: all roots,
+// then everything one level down, and so on, with parent indices, dirty flags
+// and world matrices in parallel arrays. The order is only rebuilt when the
+// hierarchy changes or entities gain or lose a transform; when components
+// merely move in storage the cached pointers are looked up again, and no
+// world matrix is recomputed because of it. Each frame the levels are
+// walked in order: a transform is recomputed if it was modified or any of its
+// ancestors was, and each level is split across the job system. Each job
+// gathers its changed transforms and runs them through the batch kernels in
+// MatrixBatch.h.
+//
+// Register it after the systems that move transforms; its write access to
+// TransformComponent makes the scheduler run it after them.
+class TransformSystem : public System {
+public:
+    TransformSystem() {
+        setComponentMask<TransformComponent>();
+    }
+
+    const char* getName() const override { return "TransformSystem"; }
+
+    void init() override {}
+
+    void update(float deltaTime) override;
+
+    // Number of world matrices recomputed by the last update()
+    std::size_t getUpdatedCount() const { return updatedCount; }
+
+private:
+    // Transforms per job when a level is split across the job system
+    static constexpr std::size_t GRAIN_SIZE = 256;
+
+    // Versions the arrays below were built or relinked against
+    std::uint64_t builtStructureVersion = 0;
+    std::uint64_t builtHierarchyVersion = 0;
+    std::uint64_t builtMembershipVersion = 0;
+    bool built = false;
+
+    // Depth-sorted arrays, all indexed the same way
+    std::vector<Entity*> owners;
+    std::vector<TransformComponent*> transforms;
+    std::vector<std::int32_t> parents; // index of the parent transform, or -1
+    std::vector<std::uint8_t> dirty;   // recomputed this frame
+    std::vector<Math::Affine3x4> worldMatrices;
+
+    // Start of each depth level in the arrays, followed by their size
+    std::vector<std::size_t> levels;
+
+    std::size_t updatedCount = 0;
+
+    // Re-sort the member entities by depth
+    void rebuild();
+
+    // Refresh the transform pointers after components moved in storage
+    void relink();
+};
+
+} // namespace ECS
+} // namespace Engine
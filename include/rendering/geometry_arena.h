@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine {
+namespace rendering {
+
+struct Vertex;
+
+// Shared vertex and index buffers that every Mesh sub-allocates from, behind
+// one vertex array. Draws of different meshes then need no vertex array
+// switch, and a whole run of them can go out as one multi-draw.
+//
+// Indices stay relative to their mesh and are drawn with the range's
+// firstVertex as base vertex. Freed ranges are reused first fit; when
+// neither buffer has room it is doubled and its contents copied on the GPU.
+class GeometryArena {
+public:
+    // Where a mesh lives in the shared buffers, in vertices and indices
+    struct Range {
+        std::uint32_t firstVertex = 0;
+        std::uint32_t vertexCount = 0;
+        std::uint32_t firstIndex = 0;
+        std::uint32_t indexCount = 0;
+
+        bool isEmpty() const { return vertexCount == 0 && indexCount == 0; }
+    };
+
+    struct FreeBlock {
+        std::uint32_t offset;
+        std::uint32_t count;
+    };
+
+    // Sub-allocation state of one buffer, in elements. Plain bookkeeping
+    // with no GL calls, so it can be used and tested on its own.
+    struct Space {
+        std::vector<FreeBlock> freeBlocks;  // sorted by offset, never adjacent
+        std::uint32_t end = 0;              // everything past here is free
+        std::uint32_t capacity = 0;
+
+        // Offset of `count` free elements, or capacity if they do not fit
+        std::uint32_t allocate(std::uint32_t count);
+        void release(std::uint32_t offset, std::uint32_t count);
+    };
+
+    GeometryArena(std::size_t vertexCapacity = 1 << 16, std::size_t indexCapacity = 1 << 18);
+    ~GeometryArena();
+
+    GeometryArena(const GeometryArena&) = delete;
+    GeometryArena& operator=(const GeometryArena&) = delete;
+
+    // Engine-wide arena used by Mesh. Never destroyed, since meshes owned
+    // by static caches may be released after it would have been.
+    static GeometryArena& getInstance();
+
+    // Copy a mesh into the buffers. Needs a GL context.
+    Range allocate(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
+
+    // Overwrite the vertices of a range with as many new ones
+    void updateVertices(const Range& range, const std::vector<Vertex>& vertices);
+
+    // Return a range for reuse; empty ranges are ignored
+    void release(const Range& range);
+
+    void bind() const;
+    unsigned int getVertexArray() const { return m_VAO; }
+
+    std::size_t getVertexCapacity() const { return m_vertices.capacity; }
+    std::size_t getIndexCapacity() const { return m_indices.capacity; }
+
+private:
+    unsigned int m_VAO = 0;
+    unsigned int m_VBO = 0;
+    unsigned int m_EBO = 0;
+    Space m_vertices;
+    Space m_indices;
+
+    void createBuffers();
+    void setupVertexArray();
+
+    // Allocate from `space`, doubling `buffer` until the range fits
+    std::uint32_t allocateIn(Space& space, unsigned int& buffer, std::size_t elementSize, std::uint32_t count);
+};
+
+} // namespace rendering
+} // namespace engine
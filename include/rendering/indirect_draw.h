@@ -0,0 +1,52 @@
+#pragma once
+
+#include "rendering/geometry_arena.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine {
+namespace rendering {
+
+// Layout glMultiDrawElementsIndirect reads from GL_DRAW_INDIRECT_BUFFER
+struct DrawElementsIndirectCommand {
+    std::uint32_t count;
+    std::uint32_t instanceCount;
+    std::uint32_t firstIndex;
+    std::int32_t baseVertex;
+    std::uint32_t baseInstance;
+};
+
+static_assert(sizeof(DrawElementsIndirectCommand) == 20, "GL expects tightly packed commands");
+
+// Builds indirect draw commands for meshes in the geometry arena. Each added
+// instance extends the last command if it draws the same range and its
+// instance follows on, so a sorted run of one mesh becomes one command.
+class IndirectDrawBuilder {
+public:
+    void clear() { m_commands.clear(); }
+
+    void add(const GeometryArena::Range& geometry, std::uint32_t instance) {
+        if (!m_commands.empty()) {
+            DrawElementsIndirectCommand& last = m_commands.back();
+            if (last.firstIndex == geometry.firstIndex && last.count == geometry.indexCount &&
+                last.baseVertex == static_cast<std::int32_t>(geometry.firstVertex) &&
+                last.baseInstance + last.instanceCount == instance) {
+                last.instanceCount++;
+                return;
+            }
+        }
+        m_commands.push_back({geometry.indexCount, 1, geometry.firstIndex,
+                              static_cast<std::int32_t>(geometry.firstVertex), instance});
+    }
+
+    std::size_t size() const { return m_commands.size(); }
+    const DrawElementsIndirectCommand& operator[](std::size_t i) const { return m_commands[i]; }
+    const std::vector<DrawElementsIndirectCommand>& getCommands() const { return m_commands; }
+
+private:
+    std::vector<DrawElementsIndirectCommand> m_commands;
+};
+
+} // namespace rendering
+} // namespace engine
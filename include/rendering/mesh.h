@@ -1,6 +1,8 @@
 #pragma once
 
 #include "rendering/shader.h"
+#include "rendering/geometry_arena.h"
+#include "ecs/math/Bounds.h"
 #include <vector>
 #include <glm/glm.hpp>
 #include <string>
@@ -36,10 +38,23 @@ public:
     // Render the mesh
     void render(Shader& shader);
     
+    // Bind the vertex array, then issue its draw; for submitting several
+    // draws without rebinding. All meshes share the arena's vertex array.
+    void bind() const;
+    void draw() const;
+    unsigned int getVertexArray() const { return GeometryArena::getInstance().getVertexArray(); }
+    
+    // Where the vertices and indices live in the geometry arena
+    const GeometryArena::Range& getGeometry() const { return m_geometry; }
+    
     // Getters
     const std::vector<Vertex>& getVertices() const { return m_vertices; }
     const std::vector<unsigned int>& getIndices() const { return m_indices; }
     
+    // Local-space bounds of the vertices, computed in setVertices()
+    const Engine::Math::AABB& getBounds() const { return m_bounds; }
+    const Engine::Math::BoundingSphere& getBoundingSphere() const { return m_boundingSphere; }
+    
     // Transform operations
     void setPosition(const glm::vec3& position) { m_position = position; }
     void setRotation(float angle, const glm::vec3& axis) { 
@@ -56,19 +71,22 @@ public:
     const std::string& getName() const { return m_name; }
     
 private:
-    // OpenGL objects
-    unsigned int m_VAO;
-    unsigned int m_VBO;
-    unsigned int m_EBO;
+    // Vertices and indices in the shared GPU buffers
+    GeometryArena::Range m_geometry;
     
     // Mesh data
     std::vector<Vertex> m_vertices;
     std::vector<unsigned int> m_indices;
     std::string m_name;
+    Engine::Math::AABB m_bounds;
+    Engine::Math::BoundingSphere m_boundingSphere;
     
-    // Set up mesh buffers
+    // Copy the mesh into the geometry arena
     void setupMesh();
     
+    // Recompute m_bounds and m_boundingSphere from m_vertices
+    void computeBounds();
+    
     // Transform properties
     glm::vec3 m_position = glm::vec3(0.0f);
     float m_rotationAngle = 0.0f;
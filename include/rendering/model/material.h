@@ -2,6 +2,7 @@
 
 #include "rendering/texture.h"
 #include "rendering/shader.h"
+#include "rendering/uniform_buffer.h"
 #include <memory>
 #include <string>
 #include <glm/glm.hpp>
@@ -14,19 +15,33 @@ public:
     Material();
     ~Material() = default;
     
-    // Apply material properties to a shader
+    // Apply material properties to a shader. Shaders with a MaterialData
+    // block get this material's uniform buffer, rebuilt only after a
+    // property changed; others get one uniform call per property.
     void apply(Shader& shader) const;
     
-    // Texture maps
-    void setDiffuseMap(std::shared_ptr<Texture> texture) { m_diffuseMap = texture; }
-    void setSpecularMap(std::shared_ptr<Texture> texture) { m_specularMap = texture; }
-    void setNormalMap(std::shared_ptr<Texture> texture) { m_normalMap = texture; }
+    // Texture maps; changing one also re-resolves the sampler handles
+    void setDiffuseMap(std::shared_ptr<Texture> texture) {
+        m_diffuseMap = texture;
+        m_uniformsDirty = true;
+        m_shaderUniforms.program = 0;
+    }
+    void setSpecularMap(std::shared_ptr<Texture> texture) {
+        m_specularMap = texture;
+        m_uniformsDirty = true;
+        m_shaderUniforms.program = 0;
+    }
+    void setNormalMap(std::shared_ptr<Texture> texture) {
+        m_normalMap = texture;
+        m_uniformsDirty = true;
+        m_shaderUniforms.program = 0;
+    }
     
     // Material properties
-    void setAmbient(const glm::vec3& ambient) { m_ambient = ambient; }
-    void setDiffuse(const glm::vec3& diffuse) { m_diffuse = diffuse; }
-    void setSpecular(const glm::vec3& specular) { m_specular = specular; }
-    void setShininess(float shininess) { m_shininess = shininess; }
+    void setAmbient(const glm::vec3& ambient) { m_ambient = ambient; m_uniformsDirty = true; }
+    void setDiffuse(const glm::vec3& diffuse) { m_diffuse = diffuse; m_uniformsDirty = true; }
+    void setSpecular(const glm::vec3& specular) { m_specular = specular; m_uniformsDirty = true; }
+    void setShininess(float shininess) { m_shininess = shininess; m_uniformsDirty = true; }
     
     // Getters
     const glm::vec3& getAmbient() const { return m_ambient; }
@@ -48,6 +63,29 @@ private:
     glm::vec3 m_diffuse;
     glm::vec3 m_specular;
     float m_shininess;
+    
+    // MaterialData block, built on first use after a change
+    mutable UniformBuffer m_uniformBuffer;
+    mutable bool m_uniformsDirty = true;
+    
+    // Uniform handles for shaders without the block, resolved for the
+    // program the material was last applied with
+    struct ShaderUniforms {
+        unsigned int program = 0;
+        Uniform ambient;
+        Uniform diffuse;
+        Uniform specular;
+        Uniform shininess;
+        Uniform hasDiffuseMap;
+        Uniform hasSpecularMap;
+        Uniform hasNormalMap;
+        Uniform diffuseMap;
+        Uniform specularMap;
+        Uniform normalMap;
+    };
+    mutable ShaderUniforms m_shaderUniforms;
+    
+    void bindTextures() const;
 
     static std::shared_ptr<Texture> m_fallbackTexture;
 };
@@ -4,6 +4,7 @@
 #include "rendering/texture.h"
 #include "rendering/model/material.h"
 #include "rendering/shader.h"
+#include "ecs/math/Bounds.h"
 #include <vector>
 #include <memory>
 #include <string>
@@ -26,10 +27,21 @@ public:
     // Getters
     const std::vector<std::shared_ptr<Mesh>>& getMeshes() const { return m_meshes; }
     
+    // Material loaded for mesh `index`, or null if it has none
+    Material* getMeshMaterial(size_t index) const {
+        return index < m_materials.size() ? m_materials[index].get() : nullptr;
+    }
+    
+    // Local-space bounds of all meshes, updated when the model is loaded
+    const Engine::Math::AABB& getBounds() const { return m_bounds; }
+    const Engine::Math::BoundingSphere& getBoundingSphere() const { return m_boundingSphere; }
+    
 private:
     // Model data
     std::vector<std::shared_ptr<Mesh>> m_meshes;
     std::vector<std::shared_ptr<Material>> m_materials;
+    Engine::Math::AABB m_bounds;
+    Engine::Math::BoundingSphere m_boundingSphere;
     
     // Helper methods for different file formats
     bool loadOBJ(const std::string& filePath);
@@ -41,6 +53,9 @@ private:
     
     // Process materials and textures
     void processMaterials(const std::string& directory);
+    
+    // Combine the mesh bounds into m_bounds and m_boundingSphere
+    void updateBounds();
 };
 
 } // namespace rendering
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "rendering/indirect_draw.h"
+#include "rendering/uniform_buffer.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Engine {
+namespace Math {
+class Matrix4x4;
+class Affine3x4;
+class Matrix3x3;
+} // namespace Math
+} // namespace Engine
+
+namespace engine {
+namespace rendering {
+
+class Shader;
+class Material;
+class Mesh;
+
+enum class RenderPass : std::uint8_t {
+    Opaque = 0,
+    Transparent = 1
+};
+
+// Collects the draws of a frame, sorts them by a 64-bit key and submits them
+// so that each shader, material and vertex array is bound once per run of
+// draws sharing it.
+//
+// Key layout, most significant bits first:
+//   pass (2) | shader (10) | material (14) | mesh (14) | depth (24)
+// Opaque draws are thereby grouped by state and drawn front to back within
+// a group. Transparent draws put their depth, inverted, above the state
+// fields so they come out back to front.
+//
+// Shaders can be given an instanced variant. Draws with such a shader are
+// then submitted with the variant, with each draw's matrices read from an
+// instance buffer instead of uniforms. Every run of draws sharing shader and
+// material becomes a list of indirect commands, one per mesh, issued with a
+// single glMultiDrawElementsIndirect on GL 4.3. On older contexts each
+// command is drawn with glDrawElementsInstancedBaseVertex instead.
+//
+// Shaders, materials and meshes get small ids the first time the queue sees
+// them. Once more objects than a field can tell apart have been seen, e.g.
+// after several scenes were loaded, clear() forgets them and hands out ids
+// from zero again. Ids past a field's width within one frame wrap around;
+// the only cost is a less effective grouping, since submit() compares the
+// objects themselves before binding anything.
+class RenderQueue {
+public:
+    // Vertex attributes an instanced variant reads its per-instance
+    // matrices from: "model" as a mat4 at locations 5-8 and "normalMatrix"
+    // as a mat3 at 9-11, laid out like the uniforms they replace
+    static constexpr unsigned int INSTANCE_MODEL_LOCATION = 5;
+    static constexpr unsigned int INSTANCE_NORMAL_LOCATION = 9;
+
+    // On GL 4.3 the same data is also bound as a std430 storage buffer of
+    // { mat4 model; mat3 normalMatrix; } (ObjectUniforms), for shaders that
+    // would rather index it with gl_BaseInstance + gl_InstanceID
+    static constexpr unsigned int INSTANCE_STORAGE_BINDING = 0;
+
+    // Draw calls and GL state changes made by the last submit()
+    struct Stats {
+        std::size_t draws = 0;
+        std::size_t instances = 0;
+        std::size_t indirectCommands = 0;
+        std::size_t shaderBinds = 0;
+        std::size_t materialBinds = 0;
+        std::size_t vertexArrayBinds = 0;
+    };
+
+    // Draws submitted together: one draw with uniforms, or a run sharing an
+    // instanced shader and material with its indirect commands
+    struct Batch {
+        std::uint32_t first;            // into the sorted draws
+        std::uint32_t count;
+        std::uint32_t firstCommand;     // into getIndirectCommands()
+        std::uint32_t commandCount;     // 0 if not instanced
+        std::uint32_t objectOffset;     // ObjectData in the uniform ring buffer
+    };
+
+    RenderQueue() = default;
+    ~RenderQueue();
+
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+
+    // Submit draws queued with `shader` through `variant` instead, batching
+    // repeated material and mesh pairs. Pass null to stop.
+    void setInstancedVariant(Shader& shader, Shader* variant);
+
+    // Drop the draws of the previous frame, keeping the storage
+    void clear();
+
+    // Queue one mesh. `depth` is the view-space distance in front of the
+    // camera; the matrices must stay alive until submit().
+    void add(RenderPass pass, Shader& shader, Material* material, Mesh& mesh, float depth,
+             const Engine::Math::Affine3x4& worldMatrix, const Engine::Math::Matrix3x3& normalMatrix);
+
+    // Sort the queued draws by key
+    void sort();
+
+    // Issue the sorted draws. Shaders without a FrameData block get view
+    // and projection as uniforms once per shader change. Draws that are not
+    // instanced bind their ObjectData range of a ring buffer, or upload
+    // "model" and "normalMatrix" as uniforms if the shader has no such
+    // block. Needs a GL context.
+    void submit(const Engine::Math::Matrix4x4& view, const Engine::Math::Matrix4x4& projection);
+
+    std::size_t size() const { return m_commands.size(); }
+    const Stats& getStats() const { return m_stats; }
+
+    // Key of the i-th draw in submission order, valid after sort()
+    std::uint64_t getSortedKey(std::size_t i) const { return m_sorted[i].key; }
+
+    // Position in add() order of the i-th draw in submission order
+    std::uint32_t getSortedIndex(std::size_t i) const { return m_sorted[i].command; }
+
+    // Group the sorted draws into batches and fill the instance data and
+    // indirect commands. Called by submit(); needs no GL context as long as
+    // no shader has an ObjectData block.
+    void buildBatches();
+
+    // Valid after buildBatches() or submit()
+    const std::vector<Batch>& getBatches() const { return m_batches; }
+    const IndirectDrawBuilder& getIndirectCommands() const { return m_indirect; }
+
+    static std::uint64_t makeKey(RenderPass pass, std::uint32_t shaderId, std::uint32_t materialId,
+                                 std::uint32_t meshId, float depth);
+
+private:
+    struct Command {
+        Shader* shader;
+        Shader* instancedShader;                // null to draw one at a time
+        Material* material;
+        Mesh* mesh;
+        const Engine::Math::Affine3x4* worldMatrix;
+        const Engine::Math::Matrix3x3* normalMatrix;
+    };
+
+    struct SortEntry {
+        std::uint64_t key;
+        std::uint32_t command;
+    };
+
+    std::vector<Command> m_commands;
+    std::vector<SortEntry> m_sorted;
+    std::vector<SortEntry> m_sortScratch;
+    Stats m_stats;
+
+    std::unordered_map<const Shader*, Shader*> m_instancedVariants;
+    std::vector<ObjectUniforms> m_instanceData;
+    UniformRingBuffer m_objectUniforms;
+    std::vector<Batch> m_batches;
+    IndirectDrawBuilder m_indirect;
+
+    unsigned int m_instanceBuffer = 0;
+    std::size_t m_instanceBufferCapacity = 0;  // bytes
+    unsigned int m_indirectBuffer = 0;
+    std::size_t m_indirectBufferCapacity = 0;
+
+    // Checked at the first submit(), which has a context
+    bool m_capabilitiesChecked = false;
+    bool m_multiDrawIndirect = false;
+
+    std::unordered_map<const void*, std::uint32_t> m_shaderIds;
+    std::unordered_map<const void*, std::uint32_t> m_materialIds;
+    std::unordered_map<const void*, std::uint32_t> m_meshIds;
+
+    void uploadBuffers();
+    static std::uint32_t idFor(std::unordered_map<const void*, std::uint32_t>& ids, const void* object);
+};
+
+} // namespace rendering
+} // namespace engine
@@ -1,12 +1,39 @@
 #pragma once
 
+#include "rendering/uniform_buffer.h"
 #include <string>
 #include <unordered_map>
 #include <glm/glm.hpp>
 
+namespace Engine {
+namespace Math {
+class Matrix4x4;
+class Affine3x4;
+class Matrix3x3;
+} // namespace Math
+} // namespace Engine
+
 namespace engine {
 namespace rendering {
 
+// Location of a uniform in one linked program. Resolve it once with
+// Shader::getUniform() and pass it to the setters, instead of a name that
+// has to be hashed on every call. A default handle, or one for a name the
+// program does not use, is ignored by the setters.
+class Uniform {
+public:
+    Uniform() = default;
+    
+    bool isValid() const { return m_location >= 0; }
+    int getLocation() const { return m_location; }
+    
+private:
+    friend class Shader;
+    explicit Uniform(int location) : m_location(location) {}
+    
+    int m_location = -1;
+};
+
 class Shader {
 public:
     Shader();
@@ -25,28 +52,73 @@ public:
     // Use this shader program
     void use();
     
-    // Uniform setters
-    void setFloat(const std::string& name, float value);
-    void setInt(const std::string& name, int value);
-    void setBool(const std::string& name, bool value);
-    void setVec2(const std::string& name, const glm::vec2& value);
-    void setVec3(const std::string& name, const glm::vec3& value);
-    void setVec4(const std::string& name, const glm::vec4& value);
-    void setMat2(const std::string& name, const glm::mat2& value);
-    void setMat3(const std::string& name, const glm::mat3& value);
-    void setMat4(const std::string& name, const glm::mat4& value);
+    // Handle for a uniform, looked up among the active uniforms reflected
+    // after linking. Handles stay valid until the shader is reloaded.
+    Uniform getUniform(const std::string& name);
+    
+    // Uniform setters taking a resolved handle; use these every frame
+    void setFloat(Uniform uniform, float value);
+    void setInt(Uniform uniform, int value);
+    void setBool(Uniform uniform, bool value);
+    void setVec2(Uniform uniform, const glm::vec2& value);
+    void setVec3(Uniform uniform, const glm::vec3& value);
+    void setVec4(Uniform uniform, const glm::vec4& value);
+    void setMat2(Uniform uniform, const glm::mat2& value);
+    void setMat3(Uniform uniform, const glm::mat3& value);
+    void setMat4(Uniform uniform, const glm::mat4& value);
+    
+    // Uploads the engine matrix straight from its storage, transposed by GL,
+    // so the shader sees the same values as setMat4(uniform, matrix.toGLM())
+    // without building a glm::mat4 per call
+    void setMat4(Uniform uniform, const Engine::Math::Matrix4x4& value);
+    
+    // Expands the affine matrix to a mat4 uniform, with the same result as
+    // setMat4(uniform, value.toMatrix4x4())
+    void setMat4(Uniform uniform, const Engine::Math::Affine3x4& value);
+    
+    // Uploaded transposed like setMat4(Matrix4x4)
+    void setMat3(Uniform uniform, const Engine::Math::Matrix3x3& value);
+    
+    // Same setters by name, for one-off uploads
+    void setFloat(const std::string& name, float value) { setFloat(getUniform(name), value); }
+    void setInt(const std::string& name, int value) { setInt(getUniform(name), value); }
+    void setBool(const std::string& name, bool value) { setBool(getUniform(name), value); }
+    void setVec2(const std::string& name, const glm::vec2& value) { setVec2(getUniform(name), value); }
+    void setVec3(const std::string& name, const glm::vec3& value) { setVec3(getUniform(name), value); }
+    void setVec4(const std::string& name, const glm::vec4& value) { setVec4(getUniform(name), value); }
+    void setMat2(const std::string& name, const glm::mat2& value) { setMat2(getUniform(name), value); }
+    void setMat3(const std::string& name, const glm::mat3& value) { setMat3(getUniform(name), value); }
+    void setMat4(const std::string& name, const glm::mat4& value) { setMat4(getUniform(name), value); }
+    void setMat4(const std::string& name, const Engine::Math::Matrix4x4& value) { setMat4(getUniform(name), value); }
+    void setMat4(const std::string& name, const Engine::Math::Affine3x4& value) { setMat4(getUniform(name), value); }
+    void setMat3(const std::string& name, const Engine::Math::Matrix3x3& value) { setMat3(getUniform(name), value); }
     
     // Get the program ID
     unsigned int getID() const { return m_programID; }
     
+    // Whether the program declares the engine uniform block, which is then
+    // bound to its binding point
+    bool hasUniformBlock(UniformBlock block) const {
+        return (m_uniformBlocks & (1u << static_cast<unsigned int>(block))) != 0;
+    }
+    
 private:
     unsigned int m_programID;
+    unsigned int m_uniformBlocks = 0;   // bit per UniformBlock
+    
+    // Active uniforms of the program by name, plus names asked for that it
+    // does not have (as -1, so they are reported once)
     std::unordered_map<std::string, int> m_uniformLocationCache;
     
     // Helper methods
     bool compileShader(unsigned int& shader, const std::string& source, unsigned int type);
     bool linkProgram(unsigned int vertexShader, unsigned int fragmentShader);
-    int getUniformLocation(const std::string& name);
+    
+    // Fill m_uniformLocationCache from the program's active uniforms
+    void reflectUniforms();
+    
+    // Bind the engine uniform blocks and texture samplers the program uses
+    void bindUniformBlocks();
     
     // Logging
     void logShaderError(unsigned int shader);
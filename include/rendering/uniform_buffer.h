@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+namespace Math {
+class Matrix4x4;
+class Affine3x4;
+class Matrix3x3;
+} // namespace Math
+} // namespace Engine
+
+namespace engine {
+namespace rendering {
+
+// Uniform blocks the engine fills, by binding point. Shader binds blocks
+// with these names to these points after linking:
+//
+//   layout(std140) uniform FrameData {
+//       mat4 view; mat4 projection; vec4 cameraPosition; float time;
+//   };
+//   layout(std140) uniform MaterialData {
+//       vec4 ambient; vec4 diffuse; vec4 specular; float shininess;
+//       int hasDiffuseMap; int hasSpecularMap; int hasNormalMap;
+//   } material;
+//   layout(std140) uniform ObjectData {
+//       mat4 model; mat3 normalMatrix;
+//   };
+//
+// Shaders using MaterialData read their textures from samplers named
+// diffuseMap, specularMap and normalMap, fixed to the units below.
+enum class UniformBlock : unsigned int {
+    Frame = 0,
+    Material = 1,
+    Object = 2
+};
+
+constexpr unsigned int UNIFORM_BLOCK_COUNT = 3;
+
+enum TextureUnit : int {
+    DIFFUSE_TEXTURE_UNIT = 0,
+    SPECULAR_TEXTURE_UNIT = 1,
+    NORMAL_TEXTURE_UNIT = 2
+};
+
+// std140 layouts of the blocks above. Matrices are stored like the
+// equivalent Shader::setMat4/setMat3 uploads, so both paths give a shader
+// the same values.
+struct FrameUniforms {
+    float view[16];
+    float projection[16];
+    float cameraPosition[4];
+    float time;
+    float padding[3];
+};
+
+struct MaterialUniforms {
+    float ambient[4];
+    float diffuse[4];
+    float specular[4];
+    float shininess;
+    std::int32_t hasDiffuseMap;
+    std::int32_t hasSpecularMap;
+    std::int32_t hasNormalMap;
+};
+
+// Also the per-instance layout of instanced draws
+struct ObjectUniforms {
+    float model[16];
+    float normalMatrix[12];     // columns padded to four floats
+};
+
+static_assert(sizeof(FrameUniforms) == 160, "std140 layout of FrameData");
+static_assert(sizeof(MaterialUniforms) == 64, "std140 layout of MaterialData");
+static_assert(sizeof(ObjectUniforms) == 112, "std140 layout of ObjectData");
+
+void storeMatrix(const Engine::Math::Matrix4x4& matrix, float (&out)[16]);
+void storeMatrix(const Engine::Math::Affine3x4& matrix, float (&out)[16]);
+void storeNormalMatrix(const Engine::Math::Matrix3x3& matrix, float (&out)[12]);
+
+// A uniform buffer holding one block, rewritten whenever its data changes
+class UniformBuffer {
+public:
+    UniformBuffer() = default;
+    ~UniformBuffer();
+
+    UniformBuffer(const UniformBuffer&) = delete;
+    UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+    // Upload a block, creating or growing the buffer as needed
+    void setData(const void* data, std::size_t size);
+
+    template <typename Block>
+    void setData(const Block& block) {
+        setData(&block, sizeof(Block));
+    }
+
+    void bind(UniformBlock block) const;
+    bool isCreated() const { return m_buffer != 0; }
+
+private:
+    unsigned int m_buffer = 0;
+    std::size_t m_size = 0;
+};
+
+// Uniform buffer split into one segment per frame in flight, for blocks
+// written many times per frame such as ObjectData. Each frame appends its
+// blocks to the next segment after waiting for the GPU to finish the
+// frame that last used it, so uploads never stall on draws in progress.
+class UniformRingBuffer {
+public:
+    static constexpr int FRAME_COUNT = 3;
+
+    explicit UniformRingBuffer(std::size_t segmentSize = 256 * 1024);
+    ~UniformRingBuffer();
+
+    UniformRingBuffer(const UniformRingBuffer&) = delete;
+    UniformRingBuffer& operator=(const UniformRingBuffer&) = delete;
+
+    // Start writing the next segment
+    void beginFrame();
+
+    // Stage a block, returning its offset for bindRange() once flushed
+    std::size_t write(const void* data, std::size_t size);
+
+    // Copy the staged blocks to the GPU
+    void flush();
+
+    // Mark the segment as in use by the draws issued since flush()
+    void endFrame();
+
+    void bindRange(UniformBlock block, std::size_t offset, std::size_t size) const;
+
+private:
+    unsigned int m_buffer = 0;
+    std::size_t m_segmentSize;
+    std::size_t m_alignment = 0;
+    int m_segment = 0;
+    void* m_fences[FRAME_COUNT] = {};
+    std::vector<std::uint8_t> m_staging;
+
+    void create();
+};
+
+} // namespace rendering
+} // namespace engine
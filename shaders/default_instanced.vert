@@ -0,0 +1,38 @@
+#version 330 core
+
+// Instanced variant of default.vert, used by RenderQueue for draws batched
+// with the default shader. Same inputs and outputs; only the per-object
+// matrices come from per-instance attributes instead of uniforms. Keep the
+// two in sync.
+
+layout (location = 0) in vec3 aPosition;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoord;
+layout (location = 3) in vec3 aTangent;
+layout (location = 4) in vec3 aBitangent;
+
+// RenderQueue::INSTANCE_MODEL_LOCATION and INSTANCE_NORMAL_LOCATION; a mat4
+// takes four locations and a mat3 three
+layout (location = 5) in mat4 model;
+layout (location = 9) in mat3 normalMatrix;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoords;
+out mat3 TBN;
+
+void main() {
+    vec4 worldPosition = model * vec4(aPosition, 1.0);
+    FragPos = worldPosition.xyz;
+    Normal = normalize(normalMatrix * aNormal);
+    TexCoords = aTexCoord;
+
+    vec3 T = normalize(normalMatrix * aTangent);
+    vec3 B = normalize(normalMatrix * aBitangent);
+    TBN = mat3(T, B, Normal);
+
+    gl_Position = projection * view * worldPosition;
+}
@@ -0,0 +1,183 @@
+#include "core/job_system.h"
+
+namespace engine {
+namespace core {
+
+namespace {
+
+// Identifies the pool and queue of the current worker thread
+thread_local const JobSystem* t_jobSystem = nullptr;
+thread_local int t_workerIndex = -1;
+
+} // namespace
+
+JobSystem::JobSystem(unsigned int workerCount) : m_running(true) {
+    if (workerCount == 0) {
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    m_queues.reserve(workerCount);
+    for (unsigned int i = 0; i < workerCount; i++) {
+        m_queues.push_back(std::make_unique<WorkQueue>());
+    }
+
+    m_workers.reserve(workerCount);
+    for (unsigned int i = 0; i < workerCount; i++) {
+        m_workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_running = false;
+    }
+    m_condition.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+JobSystem& JobSystem::getInstance() {
+    static JobSystem instance;
+    return instance;
+}
+
+int JobSystem::currentWorkerIndex() const {
+    return t_jobSystem == this ? t_workerIndex : -1;
+}
+
+void JobSystem::submit(Job job, JobCounter* counter) {
+    if (counter) {
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Workers push onto their own queue; other threads spread jobs round-robin
+    int worker = currentWorkerIndex();
+    std::size_t queueIndex = worker >= 0
+        ? static_cast<std::size_t>(worker)
+        : m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+
+    m_queuedJobs.fetch_add(1, std::memory_order_release);
+    {
+        WorkQueue& queue = *m_queues[queueIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.pushBack({std::move(job), counter});
+    }
+
+    // Taking the sleep mutex orders this wake-up after a sleeping worker's check
+    { std::lock_guard<std::mutex> lock(m_sleepMutex); }
+    m_condition.notify_one();
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    while (!counter.isDone()) {
+        if (!runPendingJob()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool JobSystem::runPendingJob() {
+    QueuedJob job;
+    int worker = currentWorkerIndex();
+    bool found = worker >= 0
+        ? popJob(static_cast<std::size_t>(worker), job) || stealJob(static_cast<std::size_t>(worker), job)
+        : stealJob(0, job);
+    if (!found) {
+        return false;
+    }
+    execute(job);
+    return true;
+}
+
+void JobSystem::workerLoop(std::size_t index) {
+    t_jobSystem = this;
+    t_workerIndex = static_cast<int>(index);
+
+    while (true) {
+        QueuedJob job;
+        if (popJob(index, job) || stealJob(index, job)) {
+            execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_condition.wait(lock, [this] {
+            return !m_running || m_queuedJobs.load(std::memory_order_acquire) > 0;
+        });
+        if (!m_running && m_queuedJobs.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+
+bool JobSystem::popJob(std::size_t queueIndex, QueuedJob& job) {
+    WorkQueue& queue = *m_queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    // Newest first: its data is most likely still in this core's cache
+    if (!queue.popBack(job)) {
+        return false;
+    }
+    m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool JobSystem::stealJob(std::size_t thiefIndex, QueuedJob& job) {
+    // Try every other queue once, starting next to the thief
+    for (std::size_t offset = 1; offset <= m_queues.size(); offset++) {
+        WorkQueue& queue = *m_queues[(thiefIndex + offset) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        // Oldest first: typically the largest remaining piece of work
+        if (queue.popFront(job)) {
+            m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::WorkQueue::pushBack(QueuedJob&& job) {
+    if (count == jobs.size()) {
+        // Unroll into a buffer twice the size, oldest job first
+        std::vector<QueuedJob> grown(std::max<std::size_t>(16, jobs.size() * 2));
+        for (std::size_t i = 0; i < count; i++) {
+            grown[i] = std::move(jobs[(head + i) % jobs.size()]);
+        }
+        jobs.swap(grown);
+        head = 0;
+    }
+    jobs[(head + count) % jobs.size()] = std::move(job);
+    count++;
+}
+
+bool JobSystem::WorkQueue::popBack(QueuedJob& job) {
+    if (count == 0) {
+        return false;
+    }
+    count--;
+    job = std::move(jobs[(head + count) % jobs.size()]);
+    return true;
+}
+
+bool JobSystem::WorkQueue::popFront(QueuedJob& job) {
+    if (count == 0) {
+        return false;
+    }
+    job = std::move(jobs[head]);
+    head = (head + 1) % jobs.size();
+    count--;
+    return true;
+}
+
+void JobSystem::execute(QueuedJob& job) {
+    job.job();
+    if (job.counter) {
+        job.counter->pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+} // namespace core
+} // namespace engine
@@ -0,0 +1,117 @@
+#include "core/memory/allocation_counter.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace engine {
+namespace core {
+
+namespace {
+
+std::atomic<std::uint64_t> g_allocationCount{0};
+std::atomic<std::uint64_t> g_allocationBytes{0};
+
+} // namespace
+
+bool AllocationCounter::isEnabled() {
+#ifdef ENGINE_TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::uint64_t AllocationCounter::getCount() {
+    return g_allocationCount.load(std::memory_order_relaxed);
+}
+
+std::uint64_t AllocationCounter::getBytes() {
+    return g_allocationBytes.load(std::memory_order_relaxed);
+}
+
+#ifdef ENGINE_TRACK_ALLOCATIONS
+
+namespace {
+
+void* countedAllocate(std::size_t size, std::size_t alignment) {
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    if (size == 0) {
+        size = 1;
+    }
+    void* memory = nullptr;
+    if (alignment <= alignof(std::max_align_t)) {
+        memory = std::malloc(size);
+    } else {
+#ifdef _MSC_VER
+        memory = _aligned_malloc(size, alignment);
+#else
+        // aligned_alloc wants the size to be a multiple of the alignment
+        memory = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+    }
+    return memory;
+}
+
+void countedFree(void* memory, std::size_t alignment) {
+#ifdef _MSC_VER
+    if (alignment > alignof(std::max_align_t)) {
+        _aligned_free(memory);
+        return;
+    }
+#endif
+    (void)alignment;
+    std::free(memory);
+}
+
+} // namespace
+
+#endif // ENGINE_TRACK_ALLOCATIONS
+
+} // namespace core
+} // namespace engine
+
+#ifdef ENGINE_TRACK_ALLOCATIONS
+
+// Replacements for the global allocation functions. The sized and nothrow
+// forms the standard library forwards to these are covered by the defaults.
+void* operator new(std::size_t size) {
+    if (void* memory = engine::core::countedAllocate(size, alignof(std::max_align_t))) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    if (void* memory = engine::core::countedAllocate(size, static_cast<std::size_t>(alignment))) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return ::operator new(size, alignment);
+}
+
+void operator delete(void* memory) noexcept {
+    engine::core::countedFree(memory, alignof(std::max_align_t));
+}
+
+void operator delete[](void* memory) noexcept {
+    ::operator delete(memory);
+}
+
+void operator delete(void* memory, std::align_val_t alignment) noexcept {
+    engine::core::countedFree(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* memory, std::align_val_t alignment) noexcept {
+    ::operator delete(memory, alignment);
+}
+
+#endif // ENGINE_TRACK_ALLOCATIONS
@@ -0,0 +1,77 @@
+#include "core/memory/frame_allocator.h"
+#include <cstdint>
+
+namespace engine {
+namespace core {
+
+namespace {
+
+std::size_t alignUp(std::size_t value, std::size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+FrameAllocator::FrameAllocator(std::size_t capacity) {
+    for (Buffer& buffer : m_buffers) {
+        buffer.memory = std::make_unique<std::byte[]>(capacity);
+        buffer.capacity = capacity;
+    }
+}
+
+FrameAllocator& FrameAllocator::getInstance() {
+    static FrameAllocator instance;
+    return instance;
+}
+
+void* FrameAllocator::allocate(std::size_t size, std::size_t alignment) {
+    Buffer& buffer = m_buffers[m_current];
+    std::uintptr_t base = reinterpret_cast<std::uintptr_t>(buffer.memory.get());
+
+    // Claim [start, start + size) by advancing the shared offset
+    std::size_t offset = buffer.offset.load(std::memory_order_relaxed);
+    std::size_t start;
+    do {
+        start = alignUp(base + offset, alignment) - base;
+        if (start + size > buffer.capacity) {
+            return allocateOverflow(buffer, size, alignment);
+        }
+    } while (!buffer.offset.compare_exchange_weak(offset, start + size, std::memory_order_relaxed));
+
+    return buffer.memory.get() + start;
+}
+
+void FrameAllocator::endFrame() {
+    m_current ^= 1;
+    reset(m_buffers[m_current]);
+}
+
+std::size_t FrameAllocator::getUsed() const {
+    const Buffer& buffer = m_buffers[m_current];
+    return buffer.offset.load(std::memory_order_relaxed) + buffer.overflowBytes;
+}
+
+void* FrameAllocator::allocateOverflow(Buffer& buffer, std::size_t size, std::size_t alignment) {
+    std::lock_guard<std::mutex> lock(buffer.overflowMutex);
+    buffer.overflow.push_back(std::make_unique<std::byte[]>(size + alignment));
+    buffer.overflowBytes += size + alignment;
+
+    std::uintptr_t address = reinterpret_cast<std::uintptr_t>(buffer.overflow.back().get());
+    return reinterpret_cast<void*>(alignUp(address, alignment));
+}
+
+void FrameAllocator::reset(Buffer& buffer) {
+    // Grow to what the last frame in this buffer needed, so it fits next time
+    if (buffer.overflowBytes > 0) {
+        std::size_t capacity = buffer.capacity + buffer.overflowBytes;
+        capacity += capacity / 4;
+        buffer.memory = std::make_unique<std::byte[]>(capacity);
+        buffer.capacity = capacity;
+        buffer.overflow.clear();
+        buffer.overflowBytes = 0;
+    }
+    buffer.offset.store(0, std::memory_order_relaxed);
+}
+
+} // namespace core
+} // namespace engine
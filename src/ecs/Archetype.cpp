@@ -0,0 +1,111 @@
+#include "ecs/Archetype.h"
+
+namespace Engine {
+namespace ECS {
+
+namespace {
+
+std::size_t alignUp(std::size_t value, std::size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+Archetype::Archetype(const ComponentMask& mask,
+                     const std::vector<std::pair<ComponentID, const ComponentTypeInfo*>>& componentTypes)
+    : mask(mask) {
+    columnIndex.fill(NO_COLUMN);
+    for (const auto& [id, type] : componentTypes) {
+        columnIndex[id] = columns.size();
+        columns.push_back({id, type, 0});
+    }
+
+    // Fit as many rows as possible into CHUNK_SIZE
+    std::size_t rowBytes = sizeof(Entity*);
+    for (const auto& column : columns) {
+        rowBytes += column.type->size;
+    }
+    chunkCapacity = std::max<std::size_t>(1, CHUNK_SIZE / rowBytes);
+    while (chunkCapacity > 1 && layoutColumns(chunkCapacity) > CHUNK_SIZE) {
+        chunkCapacity--;
+    }
+    chunkBytes = std::max(CHUNK_SIZE, layoutColumns(chunkCapacity));
+}
+
+Archetype::~Archetype() {
+    for (std::size_t row = 0; row < entityCount; row++) {
+        destroyRow(row);
+    }
+    for (unsigned char* chunk : chunks) {
+        ::operator delete(chunk, std::align_val_t(CHUNK_ALIGNMENT));
+    }
+}
+
+std::size_t Archetype::layoutColumns(std::size_t capacity) {
+    // The Entity* array always sits at the start of the chunk
+    std::size_t offset = sizeof(Entity*) * capacity;
+    for (auto& column : columns) {
+        offset = alignUp(offset, column.type->alignment);
+        column.offset = offset;
+        offset += column.type->size * capacity;
+    }
+    return offset;
+}
+
+std::size_t Archetype::allocateRow(Entity* entity) {
+    std::size_t row = entityCount;
+    if (row / chunkCapacity >= chunks.size()) {
+        chunks.push_back(static_cast<unsigned char*>(
+            ::operator new(chunkBytes, std::align_val_t(CHUNK_ALIGNMENT))));
+    }
+
+    getEntities(row / chunkCapacity)[row % chunkCapacity] = entity;
+    entityCount++;
+    return row;
+}
+
+void Archetype::destroyRow(std::size_t row) {
+    for (const auto& column : columns) {
+        column.type->destroy(getComponent(column.id, row));
+    }
+}
+
+Entity* Archetype::removeRow(std::size_t row) {
+    std::size_t last = entityCount - 1;
+    Entity* moved = nullptr;
+
+    if (row != last) {
+        // Fill the hole with the last row
+        for (const auto& column : columns) {
+            void* lastComponent = getComponent(column.id, last);
+            column.type->moveConstruct(getComponent(column.id, row), lastComponent);
+            column.type->destroy(lastComponent);
+        }
+        moved = getEntity(last);
+        getEntities(row / chunkCapacity)[row % chunkCapacity] = moved;
+    }
+
+    entityCount--;
+
+    // Keep at most one spare chunk around to avoid thrashing at a boundary
+    std::size_t usedChunks = (entityCount + chunkCapacity - 1) / chunkCapacity;
+    while (chunks.size() > usedChunks + 1) {
+        ::operator delete(chunks.back(), std::align_val_t(CHUNK_ALIGNMENT));
+        chunks.pop_back();
+    }
+
+    return moved;
+}
+
+void Archetype::moveRowTo(std::size_t row, Archetype& destination, std::size_t destinationRow) {
+    for (const auto& column : columns) {
+        void* component = getComponent(column.id, row);
+        if (destination.hasColumn(column.id)) {
+            column.type->moveConstruct(destination.getComponent(column.id, destinationRow), component);
+        }
+        column.type->destroy(component);
+    }
+}
+
+} // namespace ECS
+} // namespace Engine
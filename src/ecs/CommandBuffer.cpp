@@ -0,0 +1,230 @@
+#include "ecs/CommandBuffer.h"
+#include "ecs/ECSManager.h"
+#include "core/memory/frame_allocator.h"
+#include <algorithm>
+#include <array>
+
+namespace Engine {
+namespace ECS {
+
+CommandBuffer::~CommandBuffer() {
+    discardPayloads(commands);
+}
+
+EntityHandle CommandBuffer::createEntity() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return {createdCount++, 0};
+}
+
+void CommandBuffer::destroyEntity(EntityHandle handle) {
+    Command command;
+    command.type = CommandType::DestroyEntity;
+    command.target = handle;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    commands.push_back(command);
+}
+
+bool CommandBuffer::empty() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return commands.empty() && createdCount == 0;
+}
+
+void CommandBuffer::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    discardPayloads(commands);
+    commands.clear();
+    createdCount = 0;
+    blockIndex = 0;
+    blockOffset = 0;
+}
+
+Entity* CommandBuffer::getCreatedEntity(EntityHandle placeholder) const {
+    if (!isPlaceholder(placeholder) || placeholder.index >= createdEntities.size()) {
+        return nullptr;
+    }
+    return manager->getEntity(createdEntities[placeholder.index]);
+}
+
+void* CommandBuffer::allocatePayload(std::size_t size, std::size_t alignment) {
+    while (true) {
+        while (blockIndex < blocks.size()) {
+            Block& block = blocks[blockIndex];
+            void* pointer = block.data.get() + blockOffset;
+            std::size_t space = block.size - blockOffset;
+            if (std::align(alignment, size, pointer, space)) {
+                blockOffset = static_cast<unsigned char*>(pointer) - block.data.get() + size;
+                return pointer;
+            }
+            blockIndex++;
+            blockOffset = 0;
+        }
+
+        // Out of space: add a block, large enough for oversized components
+        std::size_t blockSize = std::max(BLOCK_SIZE, size + alignment);
+        blocks.push_back({std::make_unique<unsigned char[]>(blockSize), blockSize});
+    }
+}
+
+void CommandBuffer::playback() {
+    createdEntities.clear();
+
+    // Components initialised during playback may record further commands;
+    // keep going until the buffer is drained
+    while (true) {
+        std::uint32_t createdTotal;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            executing.swap(commands);
+            createdTotal = createdCount;
+        }
+        if (executing.empty() && createdTotal == createdEntities.size()) {
+            break;
+        }
+        apply(executing, createdTotal);
+    }
+
+    // Every payload has been moved out or destroyed, so the arena can be reused
+    std::lock_guard<std::mutex> lock(mutex);
+    createdCount = 0;
+    blockIndex = 0;
+    blockOffset = 0;
+}
+
+void CommandBuffer::apply(std::vector<Command>& batch, std::uint32_t createdTotal) {
+    while (createdEntities.size() < createdTotal) {
+        createdEntities.push_back(manager->createEntity()->getHandle());
+    }
+
+    // Resolve targets, dropping commands for stale handles, and group the
+    // commands by entity while keeping each entity's commands in order
+    struct Target {
+        Entity* entity;
+        std::size_t command;
+    };
+    engine::core::FrameVector<Target> targets;
+    targets.reserve(batch.size());
+    for (std::size_t i = 0; i < batch.size(); i++) {
+        EntityHandle handle = batch[i].target;
+        Entity* entity = isPlaceholder(handle) ? getCreatedEntity(handle) : manager->getEntity(handle);
+        if (entity && entity->isActive()) {
+            targets.push_back({entity, i});
+        }
+    }
+    std::stable_sort(targets.begin(), targets.end(), [](const Target& a, const Target& b) {
+        return a.entity->getID() < b.entity->getID();
+    });
+
+    engine::core::FrameVector<std::pair<Entity*, SystemMask>> membershipChanges;
+    membershipChanges.reserve(targets.size());
+
+    std::size_t end = 0;
+    for (std::size_t begin = 0; begin < targets.size(); begin = end) {
+        Entity* entity = targets[begin].entity;
+        for (end = begin; end < targets.size() && targets[end].entity == entity; end++) {
+        }
+
+        // Fold the entity's commands into its final mask; the last add of a
+        // component wins
+        ComponentMask oldMask = entity->componentMask;
+        SystemMask oldSystems = manager->getEntitySystems(entity);
+        ComponentMask mask = oldMask;
+        std::array<Command*, MAX_COMPONENTS> added{};
+        bool destroyed = false;
+        for (std::size_t i = begin; i < end && !destroyed; i++) {
+            Command& command = batch[targets[i].command];
+            switch (command.type) {
+                case CommandType::DestroyEntity:
+                    destroyed = true;
+                    break;
+                case CommandType::AddComponent:
+                    mask.set(command.component);
+                    added[command.component] = &command;
+                    break;
+                case CommandType::RemoveComponent:
+                    mask.reset(command.component);
+                    added[command.component] = nullptr;
+                    break;
+            }
+        }
+
+        if (destroyed) {
+            // Components are removed with the entity at the next refresh()
+            manager->markForDestruction(entity);
+            continue;
+        }
+
+        // One archetype move for all of the entity's changes; sparse-set
+        // components only touch their pools
+        for (ComponentID id = 0; id < COMPONENT_TYPE_COUNT; id++) {
+            if (added[id]) {
+                manager->componentTypes[id] = added[id]->typeInfo;
+            }
+        }
+        const ComponentMask& sparse = manager->sparseComponents;
+        ComponentMask removedSparse = oldMask & ~mask & sparse;
+        for (ComponentID id = 0; removedSparse.any() && id < COMPONENT_TYPE_COUNT; id++) {
+            if (removedSparse[id]) {
+                manager->pools[id]->remove(entity->getID());
+                removedSparse.reset(id);
+            }
+        }
+        if (((oldMask ^ mask) & sparse).any()) {
+            manager->structureVersion++;
+        }
+        Archetype* destination = manager->getArchetype(mask & ~sparse);
+        if (destination != entity->archetype) {
+            manager->moveEntity(entity, destination);
+        }
+
+        for (ComponentID id = 0; id < COMPONENT_TYPE_COUNT; id++) {
+            Command* command = added[id];
+            if (!command) {
+                continue;
+            }
+            if (sparse[id]) {
+                // The pool replaces an existing component itself
+                manager->pools[id]->insert(entity, command->payload);
+            } else {
+                void* slot = entity->archetype->getComponent(id, entity->archetypeRow);
+                if (oldMask[id]) {
+                    // Replaced: the old component was carried over by the move
+                    command->typeInfo->destroy(slot);
+                }
+                command->typeInfo->moveConstruct(slot, command->payload);
+            }
+            command->typeInfo->destroy(command->payload);
+            command->payload = nullptr;
+        }
+        entity->componentMask = mask;
+
+        // init() may change the entity again, so look each component up afresh
+        for (ComponentID id = 0; id < COMPONENT_TYPE_COUNT; id++) {
+            if (added[id] && entity->componentMask[id]) {
+                added[id]->attach(entity);
+            }
+        }
+
+        membershipChanges.emplace_back(entity, oldSystems);
+    }
+
+    // Membership is updated after every entity has been initialised
+    for (const auto& [entity, oldSystems] : membershipChanges) {
+        manager->updateSystemMembership(entity, oldSystems);
+    }
+
+    discardPayloads(batch);
+    batch.clear();
+}
+
+void CommandBuffer::discardPayloads(std::vector<Command>& batch) {
+    for (Command& command : batch) {
+        if (command.payload) {
+            command.typeInfo->destroy(command.payload);
+            command.payload = nullptr;
+        }
+    }
+}
+
+} // namespace ECS
+} // namespace Engine
@@ -2,61 +2,285 @@
 #include "core/resource_manager.h"
 #include "rendering/window.h"
 #include "ecs/components/CameraControllerComponent.h"
+#include "core/memory/allocation_counter.h"
+#include "core/memory/frame_allocator.h"
 #include <GLFW/glfw3.h>
 #include <iostream>
+#include <limits>
 
 namespace Engine {
 namespace ECS {
 
 engine::rendering::Window* ECSManager::window = nullptr;
 
-ECSManager::ECSManager() {
-    // Initialize free entity IDs
-    for (EntityID i = 0; i < MAX_ENTITIES; i++) {
-        freeEntities.push_back(i);
+ECSManager::ECSManager(std::size_t reserveHint) {
+    reserveEntities(reserveHint);
+    emptyArchetype = getArchetype(ComponentMask());
+}
+
+void ECSManager::reserveEntities(std::size_t count) {
+    entityVersions.reserve(count);
+    ensureEntityPages(count);
+}
+
+void ECSManager::ensureEntityPages(std::size_t count) {
+    std::size_t pageCount = (count + ENTITY_PAGE_SIZE - 1) >> ENTITY_PAGE_SHIFT;
+    while (entityPages.size() < pageCount) {
+        entityPages.push_back(std::make_unique<std::optional<Entity>[]>(ENTITY_PAGE_SIZE));
     }
 }
 
 Entity* ECSManager::createEntity() {
-    if (freeEntities.empty()) {
-        throw std::runtime_error("Maximum number of entities reached");
+    EntityID id;
+    if (!freeEntities.empty()) {
+        // Recycle the most recently freed ID
+        id = freeEntities.back();
+        freeEntities.pop_back();
+    } else {
+        // Grow: hand out the next unused ID
+        if (entityVersions.size() > std::numeric_limits<EntityID>::max()) {
+            throw std::runtime_error("Maximum number of entities reached");
+        }
+        id = static_cast<EntityID>(entityVersions.size());
+        entityVersions.push_back(1);
+        ensureEntityPages(entityVersions.size());
     }
-    
-    EntityID id = freeEntities.front();
-    freeEntities.erase(freeEntities.begin());
     livingEntityCount++;
     
-    entities[id] = std::make_unique<Entity>(id, this);
-    return entities[id].get();
+    Entity* entity = &entitySlot(id).emplace(id, this);
+    entity->version = entityVersions[id];
+    entity->archetype = emptyArchetype;
+    entity->archetypeRow = emptyArchetype->allocateRow(entity);
+    return entity;
+}
+
+Archetype* ECSManager::getArchetype(const ComponentMask& mask) {
+    auto it = archetypes.find(mask);
+    if (it != archetypes.end()) {
+        return it->second.get();
+    }
+    
+    std::vector<std::pair<ComponentID, const ComponentTypeInfo*>> types;
+    for (ComponentID id = 0; id < COMPONENT_TYPE_COUNT; id++) {
+        if (mask[id]) {
+            types.emplace_back(id, componentTypes[id]);
+        }
+    }
+    
+    auto archetype = std::make_unique<Archetype>(mask, types);
+    Archetype* archetypePtr = archetype.get();
+    for (std::size_t i = 0; i < systems.size(); i++) {
+        archetypePtr->systems[i] = archetypeMatches(*systems[i], mask);
+    }
+    archetypes.emplace(mask, std::move(archetype));
+    archetypeList.push_back(archetypePtr);
+    
+    // Keep cached queries up to date
+    for (auto& [queryMask, query] : queries) {
+        if (query->matches(*archetypePtr)) {
+            query->archetypes.push_back(archetypePtr);
+        }
+    }
+    
+    return archetypePtr;
+}
+
+const Query* ECSManager::getQuery(const ComponentMask& mask) {
+    std::lock_guard<std::mutex> lock(queryMutex);
+    auto it = queries.find(mask);
+    if (it != queries.end()) {
+        return it->second.get();
+    }
+    
+    auto query = std::make_unique<Query>();
+    query->mask = mask;
+    initQuery(*query);
+    
+    const Query* queryPtr = query.get();
+    queries.emplace(mask, std::move(query));
+    return queryPtr;
+}
+
+void ECSManager::initQuery(Query& query) {
+    query.archetypeMask = query.mask & ~sparseComponents;
+    for (ComponentID id = 0; id < COMPONENT_TYPE_COUNT; id++) {
+        query.pools[id] = query.mask[id] && sparseComponents[id] ? pools[id].get() : nullptr;
+    }
+    
+    query.archetypes.clear();
+    for (Archetype* archetype : archetypeList) {
+        if (query.matches(*archetype)) {
+            query.archetypes.push_back(archetype);
+        }
+    }
+}
+
+void ECSManager::applyStoragePolicies() {
+    sparseSystems.reset();
+    for (std::size_t i = 0; i < systems.size(); i++) {
+        sparseSystems[i] = (systems[i]->componentMask & sparseComponents).any();
+    }
+    for (Archetype* archetype : archetypeList) {
+        for (std::size_t i = 0; i < systems.size(); i++) {
+            archetype->systems[i] = archetypeMatches(*systems[i], archetype->getMask());
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(queryMutex);
+    for (auto& [mask, query] : queries) {
+        initQuery(*query);
+    }
+}
+
+Archetype* ECSManager::getArchetypeWith(Archetype* source, ComponentID id) {
+    if (!source->addEdges[id]) {
+        ComponentMask mask = source->getMask();
+        mask.set(id);
+        Archetype* destination = getArchetype(mask);
+        source->addEdges[id] = destination;
+        destination->removeEdges[id] = source;
+    }
+    return source->addEdges[id];
+}
+
+Archetype* ECSManager::getArchetypeWithout(Archetype* source, ComponentID id) {
+    if (!source->removeEdges[id]) {
+        ComponentMask mask = source->getMask();
+        mask.reset(id);
+        Archetype* destination = getArchetype(mask);
+        source->removeEdges[id] = destination;
+        destination->addEdges[id] = source;
+    }
+    return source->removeEdges[id];
+}
+
+void ECSManager::moveEntity(Entity* entity, Archetype* destination) {
+    structureVersion++;
+    Archetype* source = entity->archetype;
+    std::size_t sourceRow = entity->archetypeRow;
+    
+    std::size_t destinationRow = destination->allocateRow(entity);
+    source->moveRowTo(sourceRow, *destination, destinationRow);
+    
+    // The entity that filled the hole in the source archetype now lives at sourceRow
+    if (Entity* moved = source->removeRow(sourceRow)) {
+        moved->archetypeRow = sourceRow;
+    }
+    
+    entity->archetype = destination;
+    entity->archetypeRow = destinationRow;
+}
+
+void ECSManager::removeEntityFromArchetype(Entity* entity) {
+    Archetype* archetype = entity->archetype;
+    if (!archetype) {
+        return;
+    }
+    structureVersion++;
+    
+    ComponentMask sparse = entity->componentMask & sparseComponents;
+    for (ComponentID id = 0; sparse.any() && id < COMPONENT_TYPE_COUNT; id++) {
+        if (sparse[id]) {
+            pools[id]->remove(entity->id);
+            sparse.reset(id);
+        }
+    }
+    
+    archetype->destroyRow(entity->archetypeRow);
+    if (Entity* moved = archetype->removeRow(entity->archetypeRow)) {
+        moved->archetypeRow = entity->archetypeRow;
+    }
+    
+    entity->archetype = nullptr;
+    entity->componentMask.reset();
+}
+
+SystemMask ECSManager::getEntitySystems(const Entity* entity) const {
+    SystemMask result = entity->archetype->systems;
+    SystemMask unchecked = result & sparseSystems;
+    for (std::size_t i = 0; unchecked.any() && i < systems.size(); i++) {
+        if (unchecked[i]) {
+            unchecked.reset(i);
+            result[i] = systems[i]->isInterested(entity->componentMask);
+        }
+    }
+    return result;
+}
+
+void ECSManager::updateSystemMembership(Entity* entity, const SystemMask& oldSystems) {
+    SystemMask newSystems = getEntitySystems(entity);
+    SystemMask changed = oldSystems ^ newSystems;
+    for (std::size_t i = 0; changed.any() && i < systems.size(); i++) {
+        if (!changed[i]) {
+            continue;
+        }
+        changed.reset(i);
+        if (newSystems[i]) {
+            systems[i]->addEntity(entity);
+        } else {
+            systems[i]->removeEntity(entity);
+        }
+    }
 }
 
 void ECSManager::destroyEntity(EntityID id) {
-    if (id >= MAX_ENTITIES || !entities[id]) {
+    Entity* entity = getEntity(id);
+    if (entity) {
+        commandBuffer.destroyEntity(entity->getHandle());
+    }
+}
+
+void ECSManager::destroyEntity(EntityHandle handle) {
+    // Stale handles are dropped at playback
+    commandBuffer.destroyEntity(handle);
+}
+
+void ECSManager::markForDestruction(Entity* entity) {
+    if (!entity->active) {
         return;
     }
     
-    entities[id]->destroy();
+    entity->active = false;
+    pendingDestroy.push_back(entity->id);
 }
 
 Entity* ECSManager::getEntity(EntityID id) {
-    if (id >= MAX_ENTITIES) {
+    if (id >= entityVersions.size()) {
         return nullptr;
     }
-    return entities[id].get();
+    auto& slot = entitySlot(id);
+    return slot ? &*slot : nullptr;
+}
+
+Entity* ECSManager::getEntity(EntityHandle handle) {
+    return isValid(handle) ? &*entitySlot(handle.index) : nullptr;
+}
+
+bool ECSManager::isValid(EntityHandle handle) const {
+    return handle.index < entityVersions.size() &&
+           entityVersions[handle.index] == handle.version &&
+           entitySlot(handle.index).has_value();
 }
 
 void ECSManager::update(float deltaTime) {
-    std::cout << "ECSManager: update starting" << std::endl;
+    activeSystems.clear();
     for (auto& system : systems) {
         if (system->isActive()) {
+            activeSystems.push_back(system.get());
+        }
+    }
+    
+    if (parallelUpdates) {
+        scheduler.build(activeSystems);
+        scheduler.run(deltaTime, ::engine::core::JobSystem::getInstance());
+    } else {
+        for (System* system : activeSystems) {
             system->update(deltaTime);
         }
     }
-    std::cout << "ECSManager: update completed" << std::endl;
 }
 
 void ECSManager::render() {
-    std::cout << "ECSManager: render starting" << std::endl;
     int width = window->getWidth();
     int height = window->getHeight();
     glViewport(0, 0, width, height);
@@ -65,30 +289,50 @@ void ECSManager::render() {
             system->render();
         }
     }
-    std::cout << "ECSManager: render completed" << std::endl;
 }
 
 void ECSManager::refresh() {
-    for (std::size_t i = 0; i < MAX_ENTITIES; i++) {
-        if (entities[i] && !entities[i]->isActive()) {
-            // Remove entity from all systems
-            for (auto& system : systems) {
-                system->removeEntity(entities[i].get());
-            }
-            
-            // Reset components
-            for (std::size_t j = 0; j < MAX_COMPONENTS; j++) {
-                if (components[j].size() > i && components[j][i]) {
-                    components[j][i].reset();
-                }
+    // Apply the changes recorded during the frame; destroys recorded there
+    // are handled below
+    commandBuffer.playback();
+    
+    // Only entities destroyed since the last refresh are visited
+    for (EntityID id : pendingDestroy) {
+        Entity* entity = &*entitySlot(id);
+        
+        // Remove entity from the systems it belongs to
+        SystemMask memberOf = getEntitySystems(entity);
+        for (std::size_t i = 0; memberOf.any() && i < systems.size(); i++) {
+            if (memberOf[i]) {
+                systems[i]->removeEntity(entity);
             }
-            
-            // Free entity ID
-            entities[i].reset();
-            freeEntities.push_back(static_cast<EntityID>(i));
-            livingEntityCount--;
         }
+        
+        // Detach from the hierarchy so no one keeps a dangling pointer
+        entity->setParent(nullptr);
+        for (Entity* child : entity->children) {
+            child->parent = nullptr;
+            hierarchyVersion++;
+        }
+        
+        // Destroy components
+        removeEntityFromArchetype(entity);
+        
+        // Free entity ID; bumping the version invalidates outstanding handles
+        entitySlot(id).reset();
+        entityVersions[id]++;
+        freeEntities.push_back(id);
+        livingEntityCount--;
     }
+    pendingDestroy.clear();
+    
+    // End of the frame: scratch memory from the frame before is no longer
+    // referenced
+    ::engine::core::FrameAllocator::getInstance().endFrame();
+    
+    std::uint64_t allocationCount = ::engine::core::AllocationCounter::getCount();
+    lastFrameAllocations = allocationCount - frameAllocationStart;
+    frameAllocationStart = allocationCount;
 }
 
 void ECSManager::initialize(engine::rendering::Window* gameWindow) {
@@ -114,27 +358,25 @@ void ECSManager::runGameLoop() {
     
     // Main game loop / render loop
     while (!window->shouldClose()) {
-        std::cout << "Starting game loop" << std::endl;
         // Calculate delta time
         auto currentTime = std::chrono::high_resolution_clock::now();
         float deltaTime = std::chrono::duration<float>(currentTime - lastTime).count();
         lastTime = currentTime;
-        std::cout << "Processing input" << std::endl;
+        
+        // Heap allocations are counted from here to the end of refresh();
+        // swapping buffers and polling events belong to the driver and GLFW
+        frameAllocationStart = ::engine::core::AllocationCounter::getCount();
         
         // Process input
         processInput(deltaTime);
-
-        std::cout << "Updating systems" << std::endl;
         
         // Update all active systems
         update(deltaTime);
-
-        std::cout << "Rendering frame" << std::endl;
         
         // Render frame
         render();
         
-        // Clear inactive entities
+        // Clear inactive entities and end the frame
         refresh();
         
         // Swap buffers and poll events
@@ -150,38 +392,52 @@ void ECSManager::processInput(float deltaTime) {
     }
     
     // Process camera controller input for all camera controller entities
-    for (auto entity : getAllEntities()) {
-        if (entity && entity->isActive() && 
-            entity->hasComponent<CameraControllerComponent>()) {
-            auto& controller = entity->getComponent<CameraControllerComponent>();
+    auto controllers = view<CameraControllerComponent>();
+    for (auto it = controllers.begin(); it != controllers.end(); ++it) {
+        auto [controller] = *it;
+        if (it.getEntity()->isActive()) {
             controller.handleInput(window);
         }
     }
 }
 
 void ECSManager::shutdown() {
+    commandBuffer.clear();
+    
     // Clean up all entities and systems
+    scheduler.clear();
     for (auto& system : systems) {
         system.reset();
     }
     systems.clear();
+    sparseSystems.reset();
     
-    // Reset all entities
-    for (std::size_t i = 0; i < MAX_ENTITIES; i++) {
-        if (entities[i]) {
-            entities[i].reset();
+    // Reset all entities, invalidating their handles
+    for (EntityID i = 0; i < entityVersions.size(); i++) {
+        if (entitySlot(i)) {
+            entitySlot(i).reset();
+            entityVersions[i]++;
         }
     }
+    pendingDestroy.clear();
     
     // Reset components
-    for (std::size_t i = 0; i < MAX_COMPONENTS; i++) {
-        components[i].clear();
+    for (auto& [mask, query] : queries) {
+        query->archetypes.clear();
+    }
+    archetypeList.clear();
+    archetypes.clear();
+    emptyArchetype = getArchetype(ComponentMask());
+    for (auto& pool : pools) {
+        if (pool) {
+            pool->clear();
+        }
     }
     
-    // Reset free entities list
+    // Reset free entities list; versions are kept so old handles stay stale
     freeEntities.clear();
-    for (EntityID i = 0; i < MAX_ENTITIES; i++) {
-        freeEntities.push_back(i);
+    for (EntityID i = static_cast<EntityID>(entityVersions.size()); i > 0; i--) {
+        freeEntities.push_back(i - 1);
     }
     livingEntityCount = 0;
 }
@@ -209,10 +465,10 @@ std::shared_ptr<engine::rendering::Material> ECSManager::createMaterial(const st
 
 std::vector<Entity*> ECSManager::getAllEntities() const {
     std::vector<Entity*> result;
-    for (std::size_t i = 0; i < MAX_ENTITIES; i++) {
-        if (entities[i]) {
+    for (EntityID i = 0; i < entityVersions.size(); i++) {
+        if (entitySlot(i)) {
             std::cout << "Found valid entity ID: " << i << std::endl;
-            result.push_back(entities[i].get());
+            result.push_back(&*entitySlot(i));
         }
     }
     std::cout << "getAllEntities found " << result.size() << " entities" << std::endl;
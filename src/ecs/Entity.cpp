@@ -6,6 +6,9 @@
 namespace Engine {
 namespace ECS {
 
+void Entity::destroy() {
+    manager->destroyEntity(id);
+}
 
 void Entity::setParent(Entity* newParent) {
     // Remove from old parent
@@ -22,9 +25,12 @@ void Entity::setParent(Entity* newParent) {
         parent->children.push_back(this);
     }
     
-    // Mark transforms as dirty
+    manager->structureVersion++;
+    manager->hierarchyVersion++;
+    
+    // Mark transforms as dirty; TransformSystem carries this to the children
     if (hasComponent<TransformComponent>()) {
-        getComponent<TransformComponent>().worldMatrixDirty = true;
+        getComponent<TransformComponent>().markChanged();
     }
 }
 
@@ -0,0 +1,114 @@
+#include "ecs/SystemScheduler.h"
+#include <algorithm>
+#include <thread>
+
+namespace Engine {
+namespace ECS {
+
+void SystemScheduler::build(const std::vector<System*>& systems) {
+    if (systems == builtSystems) {
+        return;
+    }
+    builtSystems = systems;
+    nodes.clear();
+    nodes.reserve(systems.size());
+
+    for (System* system : systems) {
+        auto node = std::make_unique<Node>();
+        node->system = system;
+
+        // Depend on every earlier system we conflict with
+        std::size_t index = nodes.size();
+        for (std::size_t earlier = 0; earlier < index; earlier++) {
+            if (system->conflictsWith(*nodes[earlier]->system)) {
+                node->dependencies.push_back(earlier);
+                node->stage = std::max(node->stage, nodes[earlier]->stage + 1);
+                nodes[earlier]->dependents.push_back(index);
+            }
+        }
+
+        nodes.push_back(std::move(node));
+    }
+}
+
+void SystemScheduler::run(float deltaTime, engine::core::JobSystem& jobs) {
+    if (nodes.empty()) {
+        return;
+    }
+
+    engine::core::JobCounter frame;
+    frame.pending.store(nodes.size(), std::memory_order_relaxed);
+
+    for (auto& node : nodes) {
+        node->remaining.store(node->dependencies.size(), std::memory_order_relaxed);
+    }
+    for (std::size_t i = 0; i < nodes.size(); i++) {
+        if (nodes[i]->dependencies.empty()) {
+            schedule(i, deltaTime, jobs, frame);
+        }
+    }
+
+    // Run main-thread systems as they become ready and help with queued jobs
+    while (!frame.isDone()) {
+        // Swapping keeps both buffers' capacity across frames
+        mainThreadRunning.clear();
+        {
+            std::lock_guard<std::mutex> lock(mainThreadMutex);
+            mainThreadRunning.swap(mainThreadReady);
+        }
+
+        if (!mainThreadRunning.empty()) {
+            for (std::size_t index : mainThreadRunning) {
+                nodes[index]->system->update(deltaTime);
+                complete(index, deltaTime, jobs, frame);
+            }
+        } else if (!jobs.runPendingJob()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void SystemScheduler::schedule(std::size_t index, float deltaTime, engine::core::JobSystem& jobs,
+                               engine::core::JobCounter& counter) {
+    if (nodes[index]->system->isMainThreadOnly()) {
+        std::lock_guard<std::mutex> lock(mainThreadMutex);
+        mainThreadReady.push_back(index);
+        return;
+    }
+
+    jobs.submit([this, index, deltaTime, &jobs, &counter] {
+        nodes[index]->system->update(deltaTime);
+        complete(index, deltaTime, jobs, counter);
+    });
+}
+
+void SystemScheduler::complete(std::size_t index, float deltaTime, engine::core::JobSystem& jobs,
+                               engine::core::JobCounter& counter) {
+    for (std::size_t dependent : nodes[index]->dependents) {
+        if (nodes[dependent]->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            schedule(dependent, deltaTime, jobs, counter);
+        }
+    }
+    counter.pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void SystemScheduler::dump(std::ostream& out) const {
+    out << "System schedule (" << nodes.size() << " systems)" << std::endl;
+    for (std::size_t i = 0; i < nodes.size(); i++) {
+        const Node& node = *nodes[i];
+        out << "  [" << i << "] stage " << node.stage << "  " << node.system->getName();
+        if (node.system->isMainThreadOnly()) {
+            out << " (main thread)";
+        }
+        if (!node.dependencies.empty()) {
+            out << "  after";
+            for (std::size_t dependency : node.dependencies) {
+                out << " " << nodes[dependency]->system->getName();
+            }
+        }
+        out << std::endl;
+    }
+}
+
+} // namespace ECS
+} // namespace Engine
@@ -3,7 +3,6 @@
 #include "ecs/math/Matrix4x4.h"
 #include "ecs/Entity.h"
 #include <GL/glew.h>
-#include <iostream>
 
 namespace Engine {
 namespace ECS {
@@ -53,14 +52,7 @@ const Math::Matrix4x4& CameraComponent::getProjectionMatrix() const {
     return m_projectionMatrix;
 }
 const Math::Matrix4x4& CameraComponent::getViewMatrix() const {
-    std::cout << "View matrix position: " 
-              << getOwner()->getComponent<TransformComponent>().position.x << ", "
-              << getOwner()->getComponent<TransformComponent>().position.y << ", "
-              << getOwner()->getComponent<TransformComponent>().position.z << std::endl;
-
     if (m_viewDirty) {
-        std::cout << "Camera view matrix is dirty, recalculating" << std::endl;
-        
         if (getOwner()->hasComponent<TransformComponent>()) {
             const auto& transform = getOwner()->getComponent<TransformComponent>();
             
@@ -71,16 +63,17 @@ const Math::Matrix4x4& CameraComponent::getViewMatrix() const {
             Math::Vector3 up(0.0f, 1.0f, 0.0f);
             m_viewMatrix = Math::Matrix4x4::createLookAt(position, m_target, up);
             
-            std::cout << "View matrix created with position: " << position.x << "," 
-                      << position.y << "," << position.z << ", looking at target" << std::endl;
-            
             m_viewDirty = false;
         }
     }
     
     return m_viewMatrix;
-}Math::Matrix4x4 CameraComponent::getViewProjectionMatrix() const {
-    return getProjectionMatrix() * getViewMatrix();
+}
+
+Math::Matrix4x4 CameraComponent::getViewProjectionMatrix() const {
+    // The projection is stored in its uploaded (transposed) layout while the
+    // view matrix is not, so transpose it back before combining them
+    return getProjectionMatrix().transposed() * getViewMatrix();
 }
 
 void CameraComponent::clear() const {
@@ -34,14 +34,10 @@ void CameraControllerComponent::handleInput(engine::rendering::Window* window) {
 }
 
 void CameraControllerComponent::update(float deltaTime, TransformComponent& transform) {
-    // Get transform component
-    if (getOwner()->hasComponent<Engine::ECS::TransformComponent>()) {
-        auto& transform = getOwner()->getComponent<Engine::ECS::TransformComponent>();
-        // Apply movement based on direction and speed
-        Math::Vector3 movement = m_moveDirection * m_moveSpeed * deltaTime;
-        Math::Vector3 newPosition = transform.getPosition() + movement;
-        transform.setPosition(newPosition);
-    }
+    // Apply movement based on direction and speed
+    Math::Vector3 movement = m_moveDirection * m_moveSpeed * deltaTime;
+    Math::Vector3 newPosition = transform.getPosition() + movement;
+    transform.setPosition(newPosition);
 }
 
 } // namespace ECS
@@ -0,0 +1,163 @@
+#include "ecs/math/Affine3x4.h"
+#include "ecs/math/Matrix4x4.h"
+#include "ecs/math/Quaternion.h"
+#include <cmath>
+
+namespace Engine {
+namespace Math {
+
+Affine3x4::Affine3x4() {
+    data = {1.0f, 0.0f, 0.0f, 0.0f,
+            0.0f, 1.0f, 0.0f, 0.0f,
+            0.0f, 0.0f, 1.0f, 0.0f};
+}
+
+Affine3x4::Affine3x4(const Matrix4x4& m) {
+    for (int row = 0; row < 3; row++) {
+        for (int col = 0; col < 4; col++) {
+            (*this)(row, col) = m(row, col);
+        }
+    }
+}
+
+Affine3x4 Affine3x4::operator*(const Affine3x4& m) const {
+    Affine3x4 result;
+
+    // Each result row is our row weighting the rows of m, plus our
+    // translation, which meets m's implicit (0, 0, 0, 1) bottom row
+    Simd::Float4 b0 = Simd::load(&m.data[0]);
+    Simd::Float4 b1 = Simd::load(&m.data[4]);
+    Simd::Float4 b2 = Simd::load(&m.data[8]);
+    Simd::Float4 translationOnly = Simd::set(0.0f, 0.0f, 0.0f, 1.0f);
+    for (int row = 0; row < 3; row++) {
+        Simd::Float4 a = Simd::load(&data[row * 4]);
+        Simd::Float4 r = Simd::mul(a, translationOnly);
+        r = Simd::multiplyAdd(Simd::broadcast<0>(a), b0, r);
+        r = Simd::multiplyAdd(Simd::broadcast<1>(a), b1, r);
+        r = Simd::multiplyAdd(Simd::broadcast<2>(a), b2, r);
+        Simd::store(&result.data[row * 4], r);
+    }
+
+    return result;
+}
+
+Vector3 Affine3x4::transformPoint(const Vector3& p) const {
+    return Vector3(data[0] * p.x + data[1] * p.y + data[2] * p.z + data[3],
+                   data[4] * p.x + data[5] * p.y + data[6] * p.z + data[7],
+                   data[8] * p.x + data[9] * p.y + data[10] * p.z + data[11]);
+}
+
+Vector3 Affine3x4::transformVector(const Vector3& v) const {
+    return Vector3(data[0] * v.x + data[1] * v.y + data[2] * v.z,
+                   data[4] * v.x + data[5] * v.y + data[6] * v.z,
+                   data[8] * v.x + data[9] * v.y + data[10] * v.z);
+}
+
+Affine3x4 Affine3x4::inverse() const {
+    // Invert the 3x3 part by cofactors, then the translation is -inverse * t
+    const Affine3x4& m = *this;
+    float c00 = m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1);
+    float c01 = m(1, 2) * m(2, 0) - m(1, 0) * m(2, 2);
+    float c02 = m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0);
+
+    float det = m(0, 0) * c00 + m(0, 1) * c01 + m(0, 2) * c02;
+    if (det == 0.0f) {
+        return Affine3x4();
+    }
+    float invDet = 1.0f / det;
+
+    Affine3x4 result;
+    result(0, 0) = c00 * invDet;
+    result(1, 0) = c01 * invDet;
+    result(2, 0) = c02 * invDet;
+    result(0, 1) = (m(0, 2) * m(2, 1) - m(0, 1) * m(2, 2)) * invDet;
+    result(1, 1) = (m(0, 0) * m(2, 2) - m(0, 2) * m(2, 0)) * invDet;
+    result(2, 1) = (m(0, 1) * m(2, 0) - m(0, 0) * m(2, 1)) * invDet;
+    result(0, 2) = (m(0, 1) * m(1, 2) - m(0, 2) * m(1, 1)) * invDet;
+    result(1, 2) = (m(0, 2) * m(1, 0) - m(0, 0) * m(1, 2)) * invDet;
+    result(2, 2) = (m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0)) * invDet;
+
+    Vector3 t = result.transformVector(getTranslation());
+    result(0, 3) = -t.x;
+    result(1, 3) = -t.y;
+    result(2, 3) = -t.z;
+    return result;
+}
+
+Affine3x4 Affine3x4::inverseRigid() const {
+    Affine3x4 result;
+    for (int row = 0; row < 3; row++) {
+        for (int col = 0; col < 3; col++) {
+            result(row, col) = (*this)(col, row);
+        }
+    }
+
+    Vector3 t = result.transformVector(getTranslation());
+    result(0, 3) = -t.x;
+    result(1, 3) = -t.y;
+    result(2, 3) = -t.z;
+    return result;
+}
+
+Matrix3x3 Affine3x4::normalMatrix() const {
+    // The inverse transpose is the cofactor matrix over the determinant
+    const Affine3x4& m = *this;
+    Matrix3x3 result;
+    result(0, 0) = m(1, 1) * m(2, 2) - m(1, 2) * m(2, 1);
+    result(0, 1) = m(1, 2) * m(2, 0) - m(1, 0) * m(2, 2);
+    result(0, 2) = m(1, 0) * m(2, 1) - m(1, 1) * m(2, 0);
+
+    float det = m(0, 0) * result(0, 0) + m(0, 1) * result(0, 1) + m(0, 2) * result(0, 2);
+    if (det == 0.0f) {
+        return Matrix3x3();
+    }
+    float invDet = 1.0f / det;
+
+    result(1, 0) = m(0, 2) * m(2, 1) - m(0, 1) * m(2, 2);
+    result(1, 1) = m(0, 0) * m(2, 2) - m(0, 2) * m(2, 0);
+    result(1, 2) = m(0, 1) * m(2, 0) - m(0, 0) * m(2, 1);
+    result(2, 0) = m(0, 1) * m(1, 2) - m(0, 2) * m(1, 1);
+    result(2, 1) = m(0, 2) * m(1, 0) - m(0, 0) * m(1, 2);
+    result(2, 2) = m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0);
+    for (float& value : result.data) {
+        value *= invDet;
+    }
+    return result;
+}
+
+Affine3x4 Affine3x4::createTRS(const Vector3& position, const Quaternion& rotation, const Vector3& scale) {
+    // Same terms as Matrix4x4::createTRS, laid out by row
+    const Quaternion& q = rotation;
+    float xx = q.x * q.x;
+    float xy = q.x * q.y;
+    float xz = q.x * q.z;
+    float xw = q.x * q.w;
+    float yy = q.y * q.y;
+    float yz = q.y * q.z;
+    float yw = q.y * q.w;
+    float zz = q.z * q.z;
+    float zw = q.z * q.w;
+
+    Affine3x4 result;
+    result.data = {(1.0f - 2.0f * (yy + zz)) * scale.x, (2.0f * (xy - zw)) * scale.y, (2.0f * (xz + yw)) * scale.z, position.x,
+                   (2.0f * (xy + zw)) * scale.x, (1.0f - 2.0f * (xx + zz)) * scale.y, (2.0f * (yz - xw)) * scale.z, position.y,
+                   (2.0f * (xz - yw)) * scale.x, (2.0f * (yz + xw)) * scale.y, (1.0f - 2.0f * (xx + yy)) * scale.z, position.z};
+    return result;
+}
+
+Affine3x4 Affine3x4::identity() {
+    return Affine3x4();
+}
+
+Matrix4x4 Affine3x4::toMatrix4x4() const {
+    Matrix4x4 result;
+    for (int row = 0; row < 3; row++) {
+        for (int col = 0; col < 4; col++) {
+            result(row, col) = (*this)(row, col);
+        }
+    }
+    return result;
+}
+
+} // namespace Math
+} // namespace Engine
@@ -0,0 +1,90 @@
+#include "ecs/math/Frustum.h"
+#include "ecs/math/Simd.h"
+#include <limits>
+
+namespace Engine {
+namespace Math {
+
+Frustum::Frustum(const Matrix4x4& m) {
+    // Each plane is the last row of the matrix plus or minus one of the
+    // others (Gribb and Hartmann)
+    for (int i = 0; i < 3; i++) {
+        for (int side = 0; side < 2; side++) {
+            float sign = side == 0 ? 1.0f : -1.0f;
+            Plane& plane = planes[i * 2 + side];
+            plane.normal = Vector3(m(3, 0) + sign * m(i, 0),
+                                   m(3, 1) + sign * m(i, 1),
+                                   m(3, 2) + sign * m(i, 2));
+            plane.distance = m(3, 3) + sign * m(i, 3);
+
+            float length = plane.normal.magnitude();
+            if (length > 0.0f) {
+                plane.normal = plane.normal * (1.0f / length);
+                plane.distance /= length;
+            }
+        }
+    }
+}
+
+bool Frustum::intersects(const BoundingSphere& sphere) const {
+    for (const Plane& plane : planes) {
+        if (plane.distanceTo(sphere.center) < -sphere.radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::intersects(const AABB& box) const {
+    // Only the corner furthest along each plane normal needs testing
+    for (const Plane& plane : planes) {
+        Vector3 corner(plane.normal.x >= 0.0f ? box.max.x : box.min.x,
+                       plane.normal.y >= 0.0f ? box.max.y : box.min.y,
+                       plane.normal.z >= 0.0f ? box.max.z : box.min.z);
+        if (plane.distanceTo(corner) < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::size_t Frustum::cullSpheres(const float* centerX, const float* centerY, const float* centerZ,
+                                 const float* radius, std::size_t count, std::uint8_t* visible) const {
+    std::size_t visibleCount = 0;
+    std::size_t i = 0;
+
+    // Four spheres per step: the smallest signed distance over all planes,
+    // offset by the radius, is negative exactly when a sphere is outside
+    for (; i + 4 <= count; i += 4) {
+        Simd::Float4 x = Simd::loadUnaligned(centerX + i);
+        Simd::Float4 y = Simd::loadUnaligned(centerY + i);
+        Simd::Float4 z = Simd::loadUnaligned(centerZ + i);
+        Simd::Float4 r = Simd::loadUnaligned(radius + i);
+
+        Simd::Float4 nearest = Simd::splat(std::numeric_limits<float>::infinity());
+        for (const Plane& plane : planes) {
+            Simd::Float4 distance = Simd::add(Simd::splat(plane.distance), r);
+            distance = Simd::multiplyAdd(Simd::splat(plane.normal.x), x, distance);
+            distance = Simd::multiplyAdd(Simd::splat(plane.normal.y), y, distance);
+            distance = Simd::multiplyAdd(Simd::splat(plane.normal.z), z, distance);
+            nearest = Simd::min(nearest, distance);
+        }
+
+        float lanes[4];
+        Simd::storeUnaligned(lanes, nearest);
+        for (int lane = 0; lane < 4; lane++) {
+            visible[i + lane] = lanes[lane] >= 0.0f;
+            visibleCount += visible[i + lane];
+        }
+    }
+
+    for (; i < count; i++) {
+        visible[i] = intersects(BoundingSphere(Vector3(centerX[i], centerY[i], centerZ[i]), radius[i]));
+        visibleCount += visible[i];
+    }
+
+    return visibleCount;
+}
+
+} // namespace Math
+} // namespace Engine
@@ -1,5 +1,6 @@
 #include "ecs/math/Matrix4x4.h"
 #include "ecs/math/Quaternion.h"
+#include "ecs/math/Affine3x4.h"
 
 namespace Engine {
 namespace Math {
@@ -23,18 +24,90 @@ float Matrix4x4::operator()(int row, int col) const {
 Matrix4x4 Matrix4x4::operator*(const Matrix4x4& m) const {
     Matrix4x4 result;
     
+    // Each result column is a linear combination of our columns, weighted by
+    // the matching column of m
+    Simd::Float4 a0 = Simd::load(&data[0]);
+    Simd::Float4 a1 = Simd::load(&data[4]);
+    Simd::Float4 a2 = Simd::load(&data[8]);
+    Simd::Float4 a3 = Simd::load(&data[12]);
+    for (int col = 0; col < 4; col++) {
+        Simd::Float4 b = Simd::load(&m.data[col * 4]);
+        Simd::Float4 column = Simd::mul(a0, Simd::broadcast<0>(b));
+        column = Simd::multiplyAdd(a1, Simd::broadcast<1>(b), column);
+        column = Simd::multiplyAdd(a2, Simd::broadcast<2>(b), column);
+        column = Simd::multiplyAdd(a3, Simd::broadcast<3>(b), column);
+        Simd::store(&result.data[col * 4], column);
+    }
+    
+    return result;
+}
+
+Matrix4x4 Matrix4x4::transposed() const {
+    Matrix4x4 result;
     for (int row = 0; row < 4; row++) {
         for (int col = 0; col < 4; col++) {
-            result(row, col) = 0.0f;
-            for (int i = 0; i < 4; i++) {
-                result(row, col) += (*this)(row, i) * m(i, col);
-            }
+            result(row, col) = (*this)(col, row);
         }
     }
+    return result;
+}
+
+Matrix4x4 Matrix4x4::inverse() const {
+    // Cofactor expansion using the 2x2 determinants of the top two and
+    // bottom two rows
+    const Matrix4x4& m = *this;
+    float s0 = m(0, 0) * m(1, 1) - m(1, 0) * m(0, 1);
+    float s1 = m(0, 0) * m(1, 2) - m(1, 0) * m(0, 2);
+    float s2 = m(0, 0) * m(1, 3) - m(1, 0) * m(0, 3);
+    float s3 = m(0, 1) * m(1, 2) - m(1, 1) * m(0, 2);
+    float s4 = m(0, 1) * m(1, 3) - m(1, 1) * m(0, 3);
+    float s5 = m(0, 2) * m(1, 3) - m(1, 2) * m(0, 3);
+    
+    float c5 = m(2, 2) * m(3, 3) - m(3, 2) * m(2, 3);
+    float c4 = m(2, 1) * m(3, 3) - m(3, 1) * m(2, 3);
+    float c3 = m(2, 1) * m(3, 2) - m(3, 1) * m(2, 2);
+    float c2 = m(2, 0) * m(3, 3) - m(3, 0) * m(2, 3);
+    float c1 = m(2, 0) * m(3, 2) - m(3, 0) * m(2, 2);
+    float c0 = m(2, 0) * m(3, 1) - m(3, 0) * m(2, 1);
+    
+    float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    if (det == 0.0f) {
+        return Matrix4x4();
+    }
+    float invDet = 1.0f / det;
+    
+    Matrix4x4 result;
+    result(0, 0) = ( m(1, 1) * c5 - m(1, 2) * c4 + m(1, 3) * c3) * invDet;
+    result(0, 1) = (-m(0, 1) * c5 + m(0, 2) * c4 - m(0, 3) * c3) * invDet;
+    result(0, 2) = ( m(3, 1) * s5 - m(3, 2) * s4 + m(3, 3) * s3) * invDet;
+    result(0, 3) = (-m(2, 1) * s5 + m(2, 2) * s4 - m(2, 3) * s3) * invDet;
+    
+    result(1, 0) = (-m(1, 0) * c5 + m(1, 2) * c2 - m(1, 3) * c1) * invDet;
+    result(1, 1) = ( m(0, 0) * c5 - m(0, 2) * c2 + m(0, 3) * c1) * invDet;
+    result(1, 2) = (-m(3, 0) * s5 + m(3, 2) * s2 - m(3, 3) * s1) * invDet;
+    result(1, 3) = ( m(2, 0) * s5 - m(2, 2) * s2 + m(2, 3) * s1) * invDet;
+    
+    result(2, 0) = ( m(1, 0) * c4 - m(1, 1) * c2 + m(1, 3) * c0) * invDet;
+    result(2, 1) = (-m(0, 0) * c4 + m(0, 1) * c2 - m(0, 3) * c0) * invDet;
+    result(2, 2) = ( m(3, 0) * s4 - m(3, 1) * s2 + m(3, 3) * s0) * invDet;
+    result(2, 3) = (-m(2, 0) * s4 + m(2, 1) * s2 - m(2, 3) * s0) * invDet;
+    
+    result(3, 0) = (-m(1, 0) * c3 + m(1, 1) * c1 - m(1, 2) * c0) * invDet;
+    result(3, 1) = ( m(0, 0) * c3 - m(0, 1) * c1 + m(0, 2) * c0) * invDet;
+    result(3, 2) = (-m(3, 0) * s3 + m(3, 1) * s1 - m(3, 2) * s0) * invDet;
+    result(3, 3) = ( m(2, 0) * s3 - m(2, 1) * s1 + m(2, 2) * s0) * invDet;
     
     return result;
 }
 
+Matrix4x4 Matrix4x4::inverseAffine() const {
+    return Affine3x4(*this).inverse().toMatrix4x4();
+}
+
+Matrix4x4 Matrix4x4::inverseRigid() const {
+    return Affine3x4(*this).inverseRigid().toMatrix4x4();
+}
+
 Matrix4x4 Matrix4x4::createTranslation(const Vector3& position) {
     Matrix4x4 result;
     result(0, 3) = position.x;
@@ -82,11 +155,28 @@ Matrix4x4 Matrix4x4::createRotation(const Quaternion& q) {
 }
 
 Matrix4x4 Matrix4x4::createTRS(const Vector3& position, const Quaternion& rotation, const Vector3& scale) {
-    Matrix4x4 t = createTranslation(position);
-    Matrix4x4 r = createRotation(rotation);
-    Matrix4x4 s = createScale(scale);
+    // T * R * S written out directly: the rotation columns scaled by the
+    // matching scale component, with the translation as the last column
+    const Quaternion& q = rotation;
+    float xx = q.x * q.x;
+    float xy = q.x * q.y;
+    float xz = q.x * q.z;
+    float xw = q.x * q.w;
+    float yy = q.y * q.y;
+    float yz = q.y * q.z;
+    float yw = q.y * q.w;
+    float zz = q.z * q.z;
+    float zw = q.z * q.w;
     
-    return t * r * s;
+    Matrix4x4 result;
+    Simd::store(&result.data[0], Simd::mul(Simd::set(1.0f - 2.0f * (yy + zz), 2.0f * (xy + zw), 2.0f * (xz - yw), 0.0f),
+                                           Simd::splat(scale.x)));
+    Simd::store(&result.data[4], Simd::mul(Simd::set(2.0f * (xy - zw), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + xw), 0.0f),
+                                           Simd::splat(scale.y)));
+    Simd::store(&result.data[8], Simd::mul(Simd::set(2.0f * (xz + yw), 2.0f * (yz - xw), 1.0f - 2.0f * (xx + yy), 0.0f),
+                                           Simd::splat(scale.z)));
+    Simd::store(&result.data[12], Simd::set(position.x, position.y, position.z, 1.0f));
+    return result;
 }
 
 Matrix4x4 Matrix4x4::identity() {
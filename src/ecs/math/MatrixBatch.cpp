@@ -0,0 +1,293 @@
+#include "ecs/math/MatrixBatch.h"
+#include "ecs/math/Simd.h"
+#include <algorithm>
+
+namespace Engine {
+namespace Math {
+
+static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3 must be three packed floats");
+
+#if defined(ENGINE_SIMD_SSE)
+
+namespace {
+
+// Element-wise helpers so the rotation terms are written once for both
+// register widths
+inline __m128 vadd(__m128 a, __m128 b) { return _mm_add_ps(a, b); }
+inline __m128 vsub(__m128 a, __m128 b) { return _mm_sub_ps(a, b); }
+inline __m128 vmul(__m128 a, __m128 b) { return _mm_mul_ps(a, b); }
+inline __m128 vsplat(float value, __m128) { return _mm_set1_ps(value); }
+
+#if defined(ENGINE_SIMD_AVX2)
+inline __m256 vadd(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+inline __m256 vsub(__m256 a, __m256 b) { return _mm256_sub_ps(a, b); }
+inline __m256 vmul(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+inline __m256 vsplat(float value, __m256) { return _mm256_set1_ps(value); }
+#endif
+
+// The nine scaled rotation entries of a TRS matrix, one object per lane, in
+// column-major order, using the same operations in the same order as
+// createTRS.
+template <typename V>
+inline void rotationScale(V x, V y, V z, V w, V sx, V sy, V sz, V r[9]) {
+    V one = vsplat(1.0f, x);
+    V two = vsplat(2.0f, x);
+    V xx = vmul(x, x), xy = vmul(x, y), xz = vmul(x, z), xw = vmul(x, w);
+    V yy = vmul(y, y), yz = vmul(y, z), yw = vmul(y, w);
+    V zz = vmul(z, z), zw = vmul(z, w);
+
+    r[0] = vmul(vsub(one, vmul(two, vadd(yy, zz))), sx);
+    r[1] = vmul(vmul(two, vadd(xy, zw)), sx);
+    r[2] = vmul(vmul(two, vsub(xz, yw)), sx);
+    r[3] = vmul(vmul(two, vsub(xy, zw)), sy);
+    r[4] = vmul(vsub(one, vmul(two, vadd(xx, zz))), sy);
+    r[5] = vmul(vmul(two, vadd(yz, xw)), sy);
+    r[6] = vmul(vmul(two, vadd(xz, yw)), sz);
+    r[7] = vmul(vmul(two, vsub(yz, xw)), sz);
+    r[8] = vmul(vsub(one, vmul(two, vadd(xx, yy))), sz);
+}
+
+// Four packed Vector3s (exactly 12 floats, so nothing past the last one is
+// read) to one register per component
+inline void loadVector3x4(const Vector3* v, __m128& x, __m128& y, __m128& z) {
+    const float* p = &v->x;
+    __m128 a = _mm_loadu_ps(p);     // x0 y0 z0 x1
+    __m128 b = _mm_loadu_ps(p + 4); // y1 z1 x2 y2
+    __m128 c = _mm_loadu_ps(p + 8); // z2 x3 y3 z3
+    x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+    y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+                       _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+    z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+                       _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+inline void loadQuaternionx4(const Quaternion* q, __m128& x, __m128& y, __m128& z, __m128& w) {
+    x = _mm_loadu_ps(&q[0].x);
+    y = _mm_loadu_ps(&q[1].x);
+    z = _mm_loadu_ps(&q[2].x);
+    w = _mm_loadu_ps(&q[3].x);
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+}
+
+// Write four matrices from per-lane rotation entries and translations
+inline void storeTRSx4(Matrix4x4* out, const __m128 r[9], __m128 px, __m128 py, __m128 pz) {
+    __m128 zero = _mm_setzero_ps();
+    for (int col = 0; col < 3; col++) {
+        __m128 c0 = r[col * 3], c1 = r[col * 3 + 1], c2 = r[col * 3 + 2], c3 = zero;
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        _mm_store_ps(&out[0].data[col * 4], c0);
+        _mm_store_ps(&out[1].data[col * 4], c1);
+        _mm_store_ps(&out[2].data[col * 4], c2);
+        _mm_store_ps(&out[3].data[col * 4], c3);
+    }
+    __m128 w = _mm_set1_ps(1.0f);
+    _MM_TRANSPOSE4_PS(px, py, pz, w);
+    _mm_store_ps(&out[0].data[12], px);
+    _mm_store_ps(&out[1].data[12], py);
+    _mm_store_ps(&out[2].data[12], pz);
+    _mm_store_ps(&out[3].data[12], w);
+}
+
+inline void storeTRSx4(Affine3x4* out, const __m128 r[9], __m128 px, __m128 py, __m128 pz) {
+    __m128 rows[3] = {px, py, pz};
+    for (int row = 0; row < 3; row++) {
+        __m128 c0 = r[row], c1 = r[row + 3], c2 = r[row + 6], c3 = rows[row];
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        _mm_store_ps(&out[0].data[row * 4], c0);
+        _mm_store_ps(&out[1].data[row * 4], c1);
+        _mm_store_ps(&out[2].data[row * 4], c2);
+        _mm_store_ps(&out[3].data[row * 4], c3);
+    }
+}
+
+#if defined(ENGINE_SIMD_AVX2)
+inline __m256 combine(__m128 low, __m128 high) {
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1);
+}
+#endif
+
+// Same arithmetic as Matrix4x4::operator*, inlined for the batch loop
+inline void multiply(const Matrix4x4& a, const Matrix4x4& b, Matrix4x4& out) {
+#if defined(ENGINE_SIMD_AVX2)
+    // Two result columns per register
+    __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a.data[0]));
+    __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a.data[4]));
+    __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a.data[8]));
+    __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a.data[12]));
+    for (int half = 0; half < 2; half++) {
+        __m256 columns = _mm256_loadu_ps(&b.data[half * 8]);
+        __m256 result = _mm256_mul_ps(a0, _mm256_permute_ps(columns, 0x00));
+#if defined(ENGINE_SIMD_FMA)
+        result = _mm256_fmadd_ps(a1, _mm256_permute_ps(columns, 0x55), result);
+        result = _mm256_fmadd_ps(a2, _mm256_permute_ps(columns, 0xAA), result);
+        result = _mm256_fmadd_ps(a3, _mm256_permute_ps(columns, 0xFF), result);
+#else
+        result = _mm256_add_ps(_mm256_mul_ps(a1, _mm256_permute_ps(columns, 0x55)), result);
+        result = _mm256_add_ps(_mm256_mul_ps(a2, _mm256_permute_ps(columns, 0xAA)), result);
+        result = _mm256_add_ps(_mm256_mul_ps(a3, _mm256_permute_ps(columns, 0xFF)), result);
+#endif
+        _mm256_storeu_ps(&out.data[half * 8], result);
+    }
+#else
+    Simd::Float4 a0 = Simd::load(&a.data[0]);
+    Simd::Float4 a1 = Simd::load(&a.data[4]);
+    Simd::Float4 a2 = Simd::load(&a.data[8]);
+    Simd::Float4 a3 = Simd::load(&a.data[12]);
+    for (int col = 0; col < 4; col++) {
+        Simd::Float4 column = Simd::load(&b.data[col * 4]);
+        Simd::Float4 result = Simd::mul(a0, Simd::broadcast<0>(column));
+        result = Simd::multiplyAdd(a1, Simd::broadcast<1>(column), result);
+        result = Simd::multiplyAdd(a2, Simd::broadcast<2>(column), result);
+        result = Simd::multiplyAdd(a3, Simd::broadcast<3>(column), result);
+        Simd::store(&out.data[col * 4], result);
+    }
+#endif
+}
+
+template <typename Out>
+void composeTRSBatch(const Vector3* positions, const Quaternion* rotations, const Vector3* scales,
+                     Out* out, std::size_t count) {
+    std::size_t i = 0;
+
+#if defined(ENGINE_SIMD_AVX2)
+    for (; i + 8 <= count; i += 8) {
+        __m128 qx0, qy0, qz0, qw0, qx1, qy1, qz1, qw1;
+        loadQuaternionx4(rotations + i, qx0, qy0, qz0, qw0);
+        loadQuaternionx4(rotations + i + 4, qx1, qy1, qz1, qw1);
+        __m128 sx0, sy0, sz0, sx1, sy1, sz1;
+        loadVector3x4(scales + i, sx0, sy0, sz0);
+        loadVector3x4(scales + i + 4, sx1, sy1, sz1);
+
+        __m256 r[9];
+        rotationScale(combine(qx0, qx1), combine(qy0, qy1), combine(qz0, qz1), combine(qw0, qw1),
+                      combine(sx0, sx1), combine(sy0, sy1), combine(sz0, sz1), r);
+
+        __m128 low[9], high[9];
+        for (int k = 0; k < 9; k++) {
+            low[k] = _mm256_castps256_ps128(r[k]);
+            high[k] = _mm256_extractf128_ps(r[k], 1);
+        }
+
+        __m128 px, py, pz;
+        loadVector3x4(positions + i, px, py, pz);
+        storeTRSx4(out + i, low, px, py, pz);
+        loadVector3x4(positions + i + 4, px, py, pz);
+        storeTRSx4(out + i + 4, high, px, py, pz);
+    }
+#endif
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 qx, qy, qz, qw, sx, sy, sz, px, py, pz;
+        loadQuaternionx4(rotations + i, qx, qy, qz, qw);
+        loadVector3x4(scales + i, sx, sy, sz);
+        loadVector3x4(positions + i, px, py, pz);
+
+        __m128 r[9];
+        rotationScale(qx, qy, qz, qw, sx, sy, sz, r);
+        storeTRSx4(out + i, r, px, py, pz);
+    }
+
+    for (; i < count; i++) {
+        out[i] = Out::createTRS(positions[i], rotations[i], scales[i]);
+    }
+}
+
+} // namespace
+
+void composeTRS(const Vector3* positions, const Quaternion* rotations, const Vector3* scales,
+                Matrix4x4* out, std::size_t count) {
+    composeTRSBatch(positions, rotations, scales, out, count);
+}
+
+void composeTRS(const Vector3* positions, const Quaternion* rotations, const Vector3* scales,
+                Affine3x4* out, std::size_t count) {
+    composeTRSBatch(positions, rotations, scales, out, count);
+}
+
+void multiplyBatch(const Matrix4x4* parents, const Matrix4x4* locals, Matrix4x4* out, std::size_t count) {
+    for (std::size_t i = 0; i < count; i++) {
+        multiply(parents[i], locals[i], out[i]);
+    }
+}
+
+#else
+
+// NEON and scalar builds: the per-object functions already use the Float4
+// kernels, so the batch versions are plain loops over them
+
+void composeTRS(const Vector3* positions, const Quaternion* rotations, const Vector3* scales,
+                Matrix4x4* out, std::size_t count) {
+    for (std::size_t i = 0; i < count; i++) {
+        out[i] = Matrix4x4::createTRS(positions[i], rotations[i], scales[i]);
+    }
+}
+
+void composeTRS(const Vector3* positions, const Quaternion* rotations, const Vector3* scales,
+                Affine3x4* out, std::size_t count) {
+    for (std::size_t i = 0; i < count; i++) {
+        out[i] = Affine3x4::createTRS(positions[i], rotations[i], scales[i]);
+    }
+}
+
+void multiplyBatch(const Matrix4x4* parents, const Matrix4x4* locals, Matrix4x4* out, std::size_t count) {
+    for (std::size_t i = 0; i < count; i++) {
+        out[i] = parents[i] * locals[i];
+    }
+}
+
+#endif
+
+void multiplyBatch(const Affine3x4* parents, const Affine3x4* locals, Affine3x4* out, std::size_t count) {
+    // Same product as Affine3x4::operator*, inlined for the batch loop. Every
+    // input is loaded before anything is stored, so `out` may alias.
+    for (std::size_t i = 0; i < count; i++) {
+        const Affine3x4& a = parents[i];
+        const Affine3x4& b = locals[i];
+#if defined(ENGINE_SIMD_AVX2) && defined(ENGINE_SIMD_FMA)
+        // Rows 0 and 1 in one register, row 2 in another
+        __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&b.data[0]));
+        __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&b.data[4]));
+        __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&b.data[8]));
+        __m256 a01 = _mm256_loadu_ps(&a.data[0]);
+        __m128 a2 = _mm_load_ps(&a.data[8]);
+
+        __m256 r01 = _mm256_mul_ps(a01, _mm256_setr_ps(0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f));
+        r01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, 0x00), b0, r01);
+        r01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, 0x55), b1, r01);
+        r01 = _mm256_fmadd_ps(_mm256_permute_ps(a01, 0xAA), b2, r01);
+
+        __m128 r2 = _mm_mul_ps(a2, _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+        r2 = _mm_fmadd_ps(_mm_shuffle_ps(a2, a2, 0x00), _mm256_castps256_ps128(b0), r2);
+        r2 = _mm_fmadd_ps(_mm_shuffle_ps(a2, a2, 0x55), _mm256_castps256_ps128(b1), r2);
+        r2 = _mm_fmadd_ps(_mm_shuffle_ps(a2, a2, 0xAA), _mm256_castps256_ps128(b2), r2);
+
+        _mm256_storeu_ps(&out[i].data[0], r01);
+        _mm_store_ps(&out[i].data[8], r2);
+#elif defined(ENGINE_SIMD_SCALAR)
+        float r[12];
+        for (int row = 0; row < 3; row++) {
+            for (int col = 0; col < 4; col++) {
+                r[row * 4 + col] = a(row, 0) * b(0, col) + a(row, 1) * b(1, col) + a(row, 2) * b(2, col);
+            }
+            r[row * 4 + 3] += a(row, 3);
+        }
+        std::copy(r, r + 12, out[i].data.begin());
+#else
+        Simd::Float4 translationOnly = Simd::set(0.0f, 0.0f, 0.0f, 1.0f);
+        Simd::Float4 b0 = Simd::load(&b.data[0]);
+        Simd::Float4 b1 = Simd::load(&b.data[4]);
+        Simd::Float4 b2 = Simd::load(&b.data[8]);
+        Simd::Float4 rows[3] = {Simd::load(&a.data[0]), Simd::load(&a.data[4]), Simd::load(&a.data[8])};
+        for (int row = 0; row < 3; row++) {
+            Simd::Float4 r = Simd::mul(rows[row], translationOnly);
+            r = Simd::multiplyAdd(Simd::broadcast<0>(rows[row]), b0, r);
+            r = Simd::multiplyAdd(Simd::broadcast<1>(rows[row]), b1, r);
+            r = Simd::multiplyAdd(Simd::broadcast<2>(rows[row]), b2, r);
+            Simd::store(&out[i].data[row * 4], r);
+        }
+#endif
+    }
+}
+
+} // namespace Math
+} // namespace Engine
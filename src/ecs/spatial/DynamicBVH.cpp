@@ -0,0 +1,341 @@
+#include "ecs/spatial/DynamicBVH.h"
+#include <algorithm>
+#include <utility>
+
+namespace Engine {
+namespace ECS {
+
+namespace {
+
+float axisValue(const Math::Vector3& v, int axis) {
+    return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+} // namespace
+
+void DynamicBVH::insert(EntityID id, const Math::AABB& bounds) {
+    if (contains(id)) {
+        update(id, bounds);
+        return;
+    }
+
+    std::int32_t leaf = allocateNode();
+    nodes[leaf].bounds = bounds.expanded(margin);
+    nodes[leaf].id = id;
+    if (id >= leafOf.size()) {
+        leafOf.resize(std::max<std::size_t>(id + 1, leafOf.size() * 2), NULL_NODE);
+    }
+    leafOf[id] = leaf;
+    leafCount++;
+    insertLeaf(leaf);
+}
+
+bool DynamicBVH::update(EntityID id, const Math::AABB& bounds) {
+    std::int32_t leaf = leafOf[id];
+    if (nodes[leaf].bounds.contains(bounds)) {
+        return false;
+    }
+
+    Math::AABB fat = bounds.expanded(margin);
+    std::int32_t parent = nodes[leaf].parent;
+    if (parent != NULL_NODE && nodes[parent].bounds.contains(fat)) {
+        // Still inside its parent, so every ancestor stays valid: refit the
+        // leaf alone
+        nodes[leaf].bounds = fat;
+        return true;
+    }
+
+    // Otherwise move it to a better place; only its old and new paths to the
+    // root change
+    removeLeaf(leaf);
+    nodes[leaf].bounds = fat;
+    insertLeaf(leaf);
+    return true;
+}
+
+void DynamicBVH::remove(EntityID id) {
+    if (!contains(id)) {
+        return;
+    }
+    std::int32_t leaf = leafOf[id];
+    removeLeaf(leaf);
+    freeNode(leaf);
+    leafOf[id] = NULL_NODE;
+    leafCount--;
+}
+
+void DynamicBVH::clear() {
+    nodes.clear();
+    leafOf.clear();
+    root = NULL_NODE;
+    freeList = NULL_NODE;
+    leafCount = 0;
+}
+
+void DynamicBVH::rebuild() {
+    // Keep the leaves, drop every internal node
+    std::vector<std::int32_t> leaves;
+    leaves.reserve(leafCount);
+    for (std::size_t i = 0; i < leafOf.size(); i++) {
+        if (leafOf[i] != NULL_NODE) {
+            leaves.push_back(leafOf[i]);
+        }
+    }
+
+    std::vector<Node> leafNodes;
+    leafNodes.reserve(leaves.size());
+    for (std::int32_t leaf : leaves) {
+        leafNodes.push_back(nodes[leaf]);
+    }
+
+    nodes.clear();
+    nodes.reserve(leafNodes.size() * 2);
+    freeList = NULL_NODE;
+    for (std::size_t i = 0; i < leafNodes.size(); i++) {
+        Node& node = leafNodes[i];
+        node.parent = NULL_NODE;
+        leaves[i] = static_cast<std::int32_t>(nodes.size());
+        leafOf[node.id] = leaves[i];
+        nodes.push_back(node);
+    }
+
+    // The build partitions copies of the leaf boxes rather than indices into
+    // `nodes`, so each level reads contiguous memory
+    std::vector<BuildEntry> entries(leaves.size());
+    for (std::size_t i = 0; i < leaves.size(); i++) {
+        entries[i].bounds = nodes[leaves[i]].bounds;
+        entries[i].centroid = entries[i].bounds.center();
+        entries[i].node = leaves[i];
+    }
+    root = entries.empty() ? NULL_NODE : buildRange(entries.data(), entries.size());
+}
+
+std::size_t DynamicBVH::getHeight() const {
+    if (root == NULL_NODE) {
+        return 0;
+    }
+    std::size_t height = 0;
+    std::vector<std::pair<std::int32_t, std::size_t>> stack{{root, 1}};
+    while (!stack.empty()) {
+        auto [index, depth] = stack.back();
+        stack.pop_back();
+        height = std::max(height, depth);
+        if (!nodes[index].isLeaf()) {
+            stack.push_back({nodes[index].left, depth + 1});
+            stack.push_back({nodes[index].right, depth + 1});
+        }
+    }
+    return height;
+}
+
+std::int32_t DynamicBVH::allocateNode() {
+    if (freeList != NULL_NODE) {
+        std::int32_t node = freeList;
+        freeList = nodes[node].parent;
+        nodes[node] = Node();
+        return node;
+    }
+    nodes.emplace_back();
+    return static_cast<std::int32_t>(nodes.size() - 1);
+}
+
+void DynamicBVH::freeNode(std::int32_t node) {
+    nodes[node].parent = freeList;
+    nodes[node].left = NULL_NODE;
+    freeList = node;
+}
+
+void DynamicBVH::insertLeaf(std::int32_t leaf) {
+    if (root == NULL_NODE) {
+        root = leaf;
+        nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // Walk down to the sibling that adds the least surface area: stop where
+    // making a new parent is cheaper than pushing the leaf into either child
+    Math::AABB leafBounds = nodes[leaf].bounds;
+    std::int32_t index = root;
+    while (!nodes[index].isLeaf()) {
+        const Node& node = nodes[index];
+        float area = node.bounds.halfArea();
+        float combinedArea = Math::AABB::merged(node.bounds, leafBounds).halfArea();
+
+        float cost = 2.0f * combinedArea;
+        float inheritedCost = 2.0f * (combinedArea - area);
+
+        auto childCost = [&](std::int32_t child) {
+            const Math::AABB& childBounds = nodes[child].bounds;
+            float merged = Math::AABB::merged(childBounds, leafBounds).halfArea();
+            return (nodes[child].isLeaf() ? merged : merged - childBounds.halfArea()) + inheritedCost;
+        };
+        float leftCost = childCost(node.left);
+        float rightCost = childCost(node.right);
+
+        if (cost < leftCost && cost < rightCost) {
+            break;
+        }
+        index = leftCost < rightCost ? node.left : node.right;
+    }
+
+    std::int32_t sibling = index;
+    std::int32_t oldParent = nodes[sibling].parent;
+    std::int32_t newParent = allocateNode();
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].bounds = Math::AABB::merged(leafBounds, nodes[sibling].bounds);
+    nodes[newParent].left = sibling;
+    nodes[newParent].right = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent == NULL_NODE) {
+        root = newParent;
+    } else {
+        if (nodes[oldParent].left == sibling) {
+            nodes[oldParent].left = newParent;
+        } else {
+            nodes[oldParent].right = newParent;
+        }
+        refitAncestors(oldParent);
+    }
+}
+
+void DynamicBVH::removeLeaf(std::int32_t leaf) {
+    if (leaf == root) {
+        root = NULL_NODE;
+        return;
+    }
+
+    // The sibling takes the parent's place
+    std::int32_t parent = nodes[leaf].parent;
+    std::int32_t grandParent = nodes[parent].parent;
+    std::int32_t sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+    nodes[sibling].parent = grandParent;
+    if (grandParent == NULL_NODE) {
+        root = sibling;
+    } else {
+        if (nodes[grandParent].left == parent) {
+            nodes[grandParent].left = sibling;
+        } else {
+            nodes[grandParent].right = sibling;
+        }
+        refitAncestors(grandParent);
+    }
+    freeNode(parent);
+}
+
+void DynamicBVH::refitAncestors(std::int32_t node) {
+    while (node != NULL_NODE) {
+        Node& current = nodes[node];
+        current.bounds = Math::AABB::merged(nodes[current.left].bounds, nodes[current.right].bounds);
+        node = current.parent;
+    }
+}
+
+std::int32_t DynamicBVH::buildRange(BuildEntry* entries, std::size_t count) {
+    if (count == 1) {
+        return entries[0].node;
+    }
+
+    Math::AABB centroidBounds;
+    for (std::size_t i = 0; i < count; i++) {
+        centroidBounds.merge(entries[i].centroid);
+    }
+
+    // Split along the axis where the centroids spread the most
+    Math::Vector3 extent = centroidBounds.max - centroidBounds.min;
+    int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+    float axisMin = axisValue(centroidBounds.min, axis);
+    float axisExtent = axisValue(extent, axis);
+
+    std::size_t mid = count / 2;
+    if (axisExtent > 0.0f) {
+        // Bin the centroids and pick the bin boundary with the lowest
+        // surface area cost
+        constexpr int BIN_COUNT = 16;
+        Math::AABB binBounds[BIN_COUNT];
+        std::size_t binCount[BIN_COUNT] = {};
+        float scale = BIN_COUNT / axisExtent;
+        auto binOf = [&](const BuildEntry& entry) {
+            int bin = static_cast<int>((axisValue(entry.centroid, axis) - axisMin) * scale);
+            return std::min(bin, BIN_COUNT - 1);
+        };
+        for (std::size_t i = 0; i < count; i++) {
+            int bin = binOf(entries[i]);
+            binBounds[bin].merge(entries[i].bounds);
+            binCount[bin]++;
+        }
+
+        // rightCost[b]: cost of bins b and above
+        float rightCost[BIN_COUNT];
+        Math::AABB accumulated;
+        std::size_t accumulatedCount = 0;
+        for (int bin = BIN_COUNT - 1; bin > 0; bin--) {
+            accumulated.merge(binBounds[bin]);
+            accumulatedCount += binCount[bin];
+            rightCost[bin] = accumulatedCount > 0 ? accumulated.halfArea() * accumulatedCount : 0.0f;
+        }
+
+        int bestSplit = -1;
+        float bestCost = 0.0f;
+        accumulated = Math::AABB();
+        accumulatedCount = 0;
+        for (int split = 1; split < BIN_COUNT; split++) {
+            accumulated.merge(binBounds[split - 1]);
+            accumulatedCount += binCount[split - 1];
+            if (accumulatedCount == 0 || accumulatedCount == count) {
+                continue;
+            }
+            float cost = accumulated.halfArea() * accumulatedCount + rightCost[split];
+            if (bestSplit < 0 || cost < bestCost) {
+                bestSplit = split;
+                bestCost = cost;
+            }
+        }
+
+        if (bestSplit > 0) {
+            BuildEntry* middle = std::partition(entries, entries + count,
+                                                [&](const BuildEntry& entry) { return binOf(entry) < bestSplit; });
+            mid = static_cast<std::size_t>(middle - entries);
+        }
+    }
+    if (mid == 0 || mid == count) {
+        mid = count / 2;
+    }
+
+    std::int32_t left = buildRange(entries, mid);
+    std::int32_t right = buildRange(entries + mid, count - mid);
+
+    std::int32_t node = allocateNode();
+    nodes[node].left = left;
+    nodes[node].right = right;
+    nodes[node].bounds = Math::AABB::merged(nodes[left].bounds, nodes[right].bounds);
+    nodes[left].parent = node;
+    nodes[right].parent = node;
+    return node;
+}
+
+bool DynamicBVH::rayHits(const Math::Vector3& origin, const Math::Vector3& inverseDirection, float maxDistance,
+                         const Math::AABB& bounds) {
+    // Slab test; infinite inverse components handle axis-parallel rays
+    float t1 = (bounds.min.x - origin.x) * inverseDirection.x;
+    float t2 = (bounds.max.x - origin.x) * inverseDirection.x;
+    float tMin = std::min(t1, t2);
+    float tMax = std::max(t1, t2);
+
+    t1 = (bounds.min.y - origin.y) * inverseDirection.y;
+    t2 = (bounds.max.y - origin.y) * inverseDirection.y;
+    tMin = std::max(tMin, std::min(t1, t2));
+    tMax = std::min(tMax, std::max(t1, t2));
+
+    t1 = (bounds.min.z - origin.z) * inverseDirection.z;
+    t2 = (bounds.max.z - origin.z) * inverseDirection.z;
+    tMin = std::max(tMin, std::min(t1, t2));
+    tMax = std::min(tMax, std::max(t1, t2));
+
+    return tMax >= std::max(tMin, 0.0f) && tMin <= maxDistance;
+}
+
+} // namespace ECS
+} // namespace Engine
@@ -0,0 +1,385 @@
+#include "ecs/spatial/HashGrid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Engine {
+namespace ECS {
+
+namespace {
+
+// Keys pack three biased 20-bit cell coordinates and the level above them
+constexpr std::int32_t COORDINATE_BIAS = 1 << 19;
+constexpr std::uint64_t COORDINATE_MASK = (std::uint64_t(1) << 20) - 1;
+
+// Initial sphere capacity of a new cell
+constexpr std::size_t CELL_RESERVE = 4;
+
+// Half of the 26 neighbors, so each pair of neighboring cells is visited
+// once
+struct Offset {
+    std::int32_t x, y, z;
+};
+constexpr Offset FORWARD_NEIGHBORS[13] = {
+    {1, 0, 0},
+    {-1, 1, 0}, {0, 1, 0}, {1, 1, 0},
+    {-1, -1, 1}, {0, -1, 1}, {1, -1, 1},
+    {-1, 0, 1}, {0, 0, 1}, {1, 0, 1},
+    {-1, 1, 1}, {0, 1, 1}, {1, 1, 1},
+};
+
+} // namespace
+
+HashGrid::HashGrid(float cellSize) : cellSize(cellSize) {
+    for (int level = 0; level < LEVEL_COUNT; level++) {
+        inverseLevelSize[level] = 1.0f / levelCellSize(level);
+    }
+}
+
+void HashGrid::insert(EntityID id, const Math::Vector3& center, float radius) {
+    if (contains(id)) {
+        update(id, center, radius);
+        return;
+    }
+    if (id >= locationOf.size()) {
+        locationOf.resize(std::max<std::size_t>(id + 1, locationOf.size() * 2));
+    }
+    place(id, Proxy{center.x, center.y, center.z, radius, id});
+    proxyCount++;
+}
+
+void HashGrid::update(EntityID id, const Math::Vector3& center, float radius) {
+    Location& location = locationOf[id];
+    Proxy proxy{center.x, center.y, center.z, radius, id};
+
+    // Rewrite in place when it stays in the same cell
+    int level = levelFor(radius);
+    if (level == LEVEL_COUNT) {
+        if (location.cell == OVERSIZED) {
+            oversized[location.slot] = proxy;
+            return;
+        }
+    } else if (location.cell >= 0) {
+        std::uint64_t key = packKey(level, cellCoordinate(center.x, level), cellCoordinate(center.y, level),
+                                    cellCoordinate(center.z, level));
+        if (cells[location.cell].key == key) {
+            cells[location.cell].proxies[location.slot] = proxy;
+            return;
+        }
+    }
+
+    unplace(id);
+    place(id, proxy);
+}
+
+void HashGrid::remove(EntityID id) {
+    if (!contains(id)) {
+        return;
+    }
+    unplace(id);
+    proxyCount--;
+}
+
+void HashGrid::clear() {
+    cells.clear();
+    freeCells.clear();
+    oversized.clear();
+    locationOf.clear();
+    table.clear();
+    tableCount = 0;
+    for (int level = 0; level < LEVEL_COUNT; level++) {
+        levelCells[level].clear();
+        levelProxyCount[level] = 0;
+    }
+    proxyCount = 0;
+}
+
+void HashGrid::findPairs(std::vector<BroadphasePair>& pairs) const {
+    pairs.clear();
+
+    auto emit = [&pairs](EntityID a, EntityID b) {
+        pairs.push_back(a < b ? BroadphasePair{a, b} : BroadphasePair{b, a});
+    };
+    auto testAgainst = [&](const Proxy& proxy, const std::vector<Proxy>& others) {
+        for (const Proxy& other : others) {
+            if (proxy.overlaps(other.x, other.y, other.z, other.radius)) {
+                emit(proxy.id, other.id);
+            }
+        }
+    };
+
+    for (const Cell& cell : cells) {
+        if (cell.key == EMPTY_KEY) {
+            continue;
+        }
+        const std::vector<Proxy>& proxies = cell.proxies;
+
+        // Pairs inside the cell
+        for (std::size_t i = 0; i < proxies.size(); i++) {
+            const Proxy& proxy = proxies[i];
+            for (std::size_t j = i + 1; j < proxies.size(); j++) {
+                if (proxy.overlaps(proxies[j].x, proxies[j].y, proxies[j].z, proxies[j].radius)) {
+                    emit(proxy.id, proxies[j].id);
+                }
+            }
+        }
+
+        // Pairs with the forward half of the neighbors on the same level
+        for (const Offset& offset : FORWARD_NEIGHBORS) {
+            std::int32_t neighbor =
+                findCell(packKey(cell.level, cell.x + offset.x, cell.y + offset.y, cell.z + offset.z));
+            if (neighbor == ABSENT) {
+                continue;
+            }
+            for (const Proxy& proxy : proxies) {
+                testAgainst(proxy, cells[neighbor].proxies);
+            }
+        }
+    }
+
+    // Pairs across levels. Levels nest, so a fine cell falls in one cell of
+    // each coarser level and only the 27 around that can hold an overlapping
+    // sphere. When the coarse level holds few spheres it is cheaper to go the
+    // other way and look up the fine cells each coarse sphere can reach.
+    for (int fine = 0; fine < LEVEL_COUNT; fine++) {
+        if (levelCells[fine].empty()) {
+            continue;
+        }
+        float fineReach = levelCellSize(fine) * 0.5f;
+        for (int coarse = fine + 1; coarse < LEVEL_COUNT; coarse++) {
+            if (levelCells[coarse].empty()) {
+                continue;
+            }
+            int shift = coarse - fine;
+            std::size_t span = (std::size_t(1) << shift) + 2;
+            std::size_t fineLookups = levelCells[fine].size() * 27;
+            std::size_t coarseLookups = levelProxyCount[coarse] * span * span * span;
+
+            if (fineLookups <= coarseLookups) {
+                for (std::int32_t index : levelCells[fine]) {
+                    const Cell& cell = cells[index];
+                    std::int32_t x = cell.x >> shift, y = cell.y >> shift, z = cell.z >> shift;
+                    for (std::int32_t dz = -1; dz <= 1; dz++) {
+                        for (std::int32_t dy = -1; dy <= 1; dy++) {
+                            for (std::int32_t dx = -1; dx <= 1; dx++) {
+                                std::int32_t other = findCell(packKey(coarse, x + dx, y + dy, z + dz));
+                                if (other == ABSENT) {
+                                    continue;
+                                }
+                                for (const Proxy& proxy : cell.proxies) {
+                                    testAgainst(proxy, cells[other].proxies);
+                                }
+                            }
+                        }
+                    }
+                }
+            } else {
+                for (std::int32_t index : levelCells[coarse]) {
+                    for (const Proxy& proxy : cells[index].proxies) {
+                        float reach = proxy.radius + fineReach;
+                        std::int32_t loX = cellCoordinate(proxy.x - reach, fine);
+                        std::int32_t hiX = cellCoordinate(proxy.x + reach, fine);
+                        std::int32_t loY = cellCoordinate(proxy.y - reach, fine);
+                        std::int32_t hiY = cellCoordinate(proxy.y + reach, fine);
+                        std::int32_t loZ = cellCoordinate(proxy.z - reach, fine);
+                        std::int32_t hiZ = cellCoordinate(proxy.z + reach, fine);
+                        for (std::int32_t z = loZ; z <= hiZ; z++) {
+                            for (std::int32_t y = loY; y <= hiY; y++) {
+                                for (std::int32_t x = loX; x <= hiX; x++) {
+                                    std::int32_t other = findCell(packKey(fine, x, y, z));
+                                    if (other != ABSENT) {
+                                        testAgainst(proxy, cells[other].proxies);
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Large spheres against everything, and against each other once
+    for (std::size_t i = 0; i < oversized.size(); i++) {
+        const Proxy& proxy = oversized[i];
+        for (const Cell& cell : cells) {
+            testAgainst(proxy, cell.proxies);
+        }
+        for (std::size_t j = i + 1; j < oversized.size(); j++) {
+            if (proxy.overlaps(oversized[j].x, oversized[j].y, oversized[j].z, oversized[j].radius)) {
+                emit(proxy.id, oversized[j].id);
+            }
+        }
+    }
+}
+
+int HashGrid::levelFor(float radius) const {
+    int level = 0;
+    while (level < LEVEL_COUNT && radius > levelCellSize(level) * 0.5f) {
+        level++;
+    }
+    return level;
+}
+
+std::int32_t HashGrid::cellCoordinate(float value, int level) const {
+    float cell = std::floor(value * inverseLevelSize[level]);
+    cell = std::min(std::max(cell, -float(COORDINATE_BIAS)), float(COORDINATE_BIAS - 1));
+    return static_cast<std::int32_t>(cell);
+}
+
+std::uint64_t HashGrid::packKey(int level, std::int32_t x, std::int32_t y, std::int32_t z) {
+    return (std::uint64_t(x + COORDINATE_BIAS) & COORDINATE_MASK) |
+           ((std::uint64_t(y + COORDINATE_BIAS) & COORDINATE_MASK) << 20) |
+           ((std::uint64_t(z + COORDINATE_BIAS) & COORDINATE_MASK) << 40) |
+           (std::uint64_t(level) << 60);
+}
+
+std::size_t HashGrid::hashKey(std::uint64_t key) {
+    // 64-bit finalizer from MurmurHash3
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return static_cast<std::size_t>(key);
+}
+
+std::int32_t HashGrid::findCell(std::uint64_t key) const {
+    if (table.empty()) {
+        return ABSENT;
+    }
+    std::size_t mask = table.size() - 1;
+    for (std::size_t i = hashKey(key) & mask;; i = (i + 1) & mask) {
+        if (table[i].key == key) {
+            return table[i].cell;
+        }
+        if (table[i].key == EMPTY_KEY) {
+            return ABSENT;
+        }
+    }
+}
+
+std::int32_t HashGrid::acquireCell(int level, std::int32_t x, std::int32_t y, std::int32_t z, std::uint64_t key) {
+    // Keep the table at most half full so probes stay short
+    if ((tableCount + 1) * 2 > table.size()) {
+        growTable();
+    }
+
+    std::int32_t cell;
+    if (!freeCells.empty()) {
+        cell = freeCells.back();
+        freeCells.pop_back();
+    } else {
+        cell = static_cast<std::int32_t>(cells.size());
+        cells.emplace_back();
+        // Room for spheres passing through, so moves rarely grow the array
+        cells.back().proxies.reserve(CELL_RESERVE);
+    }
+    cells[cell].key = key;
+    cells[cell].level = level;
+    cells[cell].x = x;
+    cells[cell].y = y;
+    cells[cell].z = z;
+
+    std::size_t mask = table.size() - 1;
+    std::size_t i = hashKey(key) & mask;
+    while (table[i].key != EMPTY_KEY) {
+        i = (i + 1) & mask;
+    }
+    table[i] = Slot{key, cell};
+    tableCount++;
+    cells[cell].levelSlot = static_cast<std::uint32_t>(levelCells[level].size());
+    levelCells[level].push_back(cell);
+    return cell;
+}
+
+void HashGrid::releaseCell(std::int32_t cell) {
+    std::size_t mask = table.size() - 1;
+    std::size_t hole = hashKey(cells[cell].key) & mask;
+    while (table[hole].key != cells[cell].key) {
+        hole = (hole + 1) & mask;
+    }
+
+    // Backward-shift deletion: pull later entries of the probe run into the
+    // hole unless that would move them before their home slot
+    for (std::size_t i = (hole + 1) & mask; table[i].key != EMPTY_KEY; i = (i + 1) & mask) {
+        std::size_t home = hashKey(table[i].key) & mask;
+        bool homeInRange = hole <= i ? (home > hole && home <= i) : (home > hole || home <= i);
+        if (!homeInRange) {
+            table[hole] = table[i];
+            hole = i;
+        }
+    }
+    table[hole] = Slot();
+    tableCount--;
+
+    // Swap-remove from the level's list
+    std::vector<std::int32_t>& siblings = levelCells[cells[cell].level];
+    std::uint32_t levelSlot = cells[cell].levelSlot;
+    siblings[levelSlot] = siblings.back();
+    cells[siblings[levelSlot]].levelSlot = levelSlot;
+    siblings.pop_back();
+
+    // The proxy array keeps its capacity for the next cell to use this slot
+    cells[cell].key = EMPTY_KEY;
+    freeCells.push_back(cell);
+}
+
+void HashGrid::growTable() {
+    table.assign(std::max<std::size_t>(64, table.size() * 2), Slot());
+    std::size_t mask = table.size() - 1;
+    for (std::size_t cell = 0; cell < cells.size(); cell++) {
+        if (cells[cell].key == EMPTY_KEY) {
+            continue;
+        }
+        std::size_t i = hashKey(cells[cell].key) & mask;
+        while (table[i].key != EMPTY_KEY) {
+            i = (i + 1) & mask;
+        }
+        table[i] = Slot{cells[cell].key, static_cast<std::int32_t>(cell)};
+    }
+}
+
+void HashGrid::place(EntityID id, const Proxy& proxy) {
+    Location& location = locationOf[id];
+    int level = levelFor(proxy.radius);
+    if (level == LEVEL_COUNT) {
+        location.cell = OVERSIZED;
+        location.slot = static_cast<std::uint32_t>(oversized.size());
+        oversized.push_back(proxy);
+        return;
+    }
+
+    std::int32_t x = cellCoordinate(proxy.x, level);
+    std::int32_t y = cellCoordinate(proxy.y, level);
+    std::int32_t z = cellCoordinate(proxy.z, level);
+    std::uint64_t key = packKey(level, x, y, z);
+    std::int32_t cell = findCell(key);
+    if (cell == ABSENT) {
+        cell = acquireCell(level, x, y, z, key);
+    }
+    location.cell = cell;
+    location.slot = static_cast<std::uint32_t>(cells[cell].proxies.size());
+    cells[cell].proxies.push_back(proxy);
+    levelProxyCount[level]++;
+}
+
+void HashGrid::unplace(EntityID id) {
+    Location& location = locationOf[id];
+    std::vector<Proxy>& proxies = location.cell == OVERSIZED ? oversized : cells[location.cell].proxies;
+
+    // Swap-remove, fixing up the location of the proxy that moved
+    proxies[location.slot] = proxies.back();
+    locationOf[proxies[location.slot].id].slot = location.slot;
+    proxies.pop_back();
+
+    if (location.cell != OVERSIZED) {
+        levelProxyCount[cells[location.cell].level]--;
+        if (proxies.empty()) {
+            releaseCell(location.cell);
+        }
+    }
+    location.cell = ABSENT;
+}
+
+} // namespace ECS
+} // namespace Engine
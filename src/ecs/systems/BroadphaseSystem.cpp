@@ -0,0 +1,42 @@
+#include "ecs/systems/BroadphaseSystem.h"
+
+namespace Engine {
+namespace ECS {
+
+void BroadphaseSystem::update(float deltaTime) {
+    frame++;
+
+    for (Entity* entity : getEntities()) {
+        EntityID id = entity->getID();
+        if (id >= lastSeen.size()) {
+            lastSeen.resize(std::max<std::size_t>(id + 1, lastSeen.size() * 2), 0);
+        }
+        lastSeen[id] = frame;
+
+        // Entities are keyed by ID alone: a recycled ID is simply moved to
+        // the new entity's position
+        if (!grid.contains(id)) {
+            indexed.push_back(id);
+        }
+
+        const TransformComponent& transform = entity->getComponent<TransformComponent>();
+        const BroadphaseComponent& broadphase = entity->getComponent<BroadphaseComponent>();
+        grid.insert(id, transform.getWorldMatrix().getTranslation(), broadphase.getRadius());
+    }
+
+    // Drop entities that left the system
+    std::size_t kept = 0;
+    for (EntityID id : indexed) {
+        if (lastSeen[id] == frame) {
+            indexed[kept++] = id;
+        } else {
+            grid.remove(id);
+        }
+    }
+    indexed.resize(kept);
+
+    grid.findPairs(pairs);
+}
+
+} // namespace ECS
+} // namespace Engine
@@ -0,0 +1,63 @@
+#include "ecs/systems/SpatialIndexSystem.h"
+
+namespace Engine {
+namespace ECS {
+
+void SpatialIndexSystem::update(float deltaTime) {
+    frame++;
+    std::size_t inserted = 0;
+
+    for (Entity* entity : getEntities()) {
+        const auto& model = entity->getComponent<MeshRendererComponent>().getModel();
+        if (!model || model->getBounds().isEmpty()) {
+            continue;
+        }
+
+        EntityID id = entity->getID();
+        if (id >= entries.size()) {
+            entries.resize(std::max<std::size_t>(id + 1, entries.size() * 2));
+        }
+        Entry& entry = entries[id];
+        const TransformComponent& transform = entity->getComponent<TransformComponent>();
+
+        // A recycled ID is a different entity and starts over
+        bool known = tree.contains(id) && entry.handle == entity->getHandle();
+        entry.lastSeen = frame;
+        if (known && entry.transformVersion == transform.worldMatrixVersion) {
+            continue;
+        }
+
+        Math::AABB bounds = model->getBounds().transformed(transform.getWorldMatrix());
+        if (known) {
+            tree.update(id, bounds);
+        } else {
+            if (!tree.contains(id)) {
+                indexed.push_back(id);
+            }
+            tree.insert(id, bounds);
+            inserted++;
+        }
+        entry.handle = entity->getHandle();
+        entry.transformVersion = transform.worldMatrixVersion;
+    }
+
+    // Drop entities that left the system or lost their model
+    std::size_t kept = 0;
+    for (EntityID id : indexed) {
+        if (entries[id].lastSeen == frame) {
+            indexed[kept++] = id;
+        } else {
+            tree.remove(id);
+        }
+    }
+    indexed.resize(kept);
+
+    // One-at-a-time insertion builds a worse tree than a bulk SAH build, so
+    // rebuild when most of the tree is new
+    if (inserted > 0 && inserted * 2 >= tree.size()) {
+        tree.rebuild();
+    }
+}
+
+} // namespace ECS
+} // namespace Engine
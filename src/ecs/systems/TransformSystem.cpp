@@ -0,0 +1,198 @@
+#include "ecs/systems/TransformSystem.h"
+#include "ecs/math/MatrixBatch.h"
+#include "core/job_system.h"
+#include "core/memory/frame_allocator.h"
+#include <atomic>
+
+namespace Engine {
+namespace ECS {
+
+namespace {
+
+// Per-thread staging for one job's worth of changed transforms, gathered
+// into separate arrays for the batch math kernels. Kept per thread rather
+// than taken from the frame allocator: it is reused by every job, so it
+// stays a few kilobytes however many transforms change.
+struct BatchScratch {
+    std::vector<std::size_t> indices;
+    std::vector<Math::Vector3> positions;
+    std::vector<Math::Quaternion> rotations;
+    std::vector<Math::Vector3> scales;
+    std::vector<Math::Affine3x4> parentWorlds;
+    std::vector<Math::Affine3x4> matrices;
+};
+
+thread_local BatchScratch scratch;
+
+} // namespace
+
+void TransformSystem::update(float deltaTime) {
+    const ECSManager* manager = getManager();
+    bool rebuilt = !built || builtHierarchyVersion != manager->getHierarchyVersion() ||
+                   builtMembershipVersion != getMembershipVersion();
+    if (rebuilt) {
+        rebuild();
+    } else if (builtStructureVersion != manager->getStructureVersion()) {
+        relink();
+    }
+
+    // Parents are finished before their children because levels run in
+    // order; within a level every transform is independent
+    std::atomic<std::size_t> updated{0};
+    auto& jobs = ::engine::core::JobSystem::getInstance();
+    for (std::size_t level = 0; level + 1 < levels.size(); level++) {
+        std::size_t levelStart = levels[level];
+        std::size_t levelSize = levels[level + 1] - levelStart;
+
+        jobs.parallelFor(levelSize, GRAIN_SIZE, [&, level, levelStart, rebuilt](std::size_t begin, std::size_t end) {
+            BatchScratch& batch = scratch;
+            batch.indices.clear();
+            for (std::size_t i = levelStart + begin; i < levelStart + end; i++) {
+                std::int32_t parent = parents[i];
+                const TransformComponent* transform = transforms[i];
+                bool changed = rebuilt || transform->localChanged || transform->worldMatrixDirty ||
+                               (parent >= 0 && dirty[parent]);
+                dirty[i] = changed;
+                if (changed) {
+                    batch.indices.push_back(i);
+                }
+            }
+
+            std::size_t count = batch.indices.size();
+            if (count == 0) {
+                return;
+            }
+            batch.positions.resize(count);
+            batch.rotations.resize(count);
+            batch.scales.resize(count);
+            batch.matrices.resize(count);
+            for (std::size_t k = 0; k < count; k++) {
+                const TransformComponent* transform = transforms[batch.indices[k]];
+                batch.positions[k] = transform->position;
+                batch.rotations[k] = transform->rotation;
+                batch.scales[k] = transform->scale;
+            }
+            Math::composeTRS(batch.positions.data(), batch.rotations.data(), batch.scales.data(),
+                             batch.matrices.data(), count);
+
+            // Everything below the root level has a parent one level up
+            if (level > 0) {
+                batch.parentWorlds.resize(count);
+                for (std::size_t k = 0; k < count; k++) {
+                    batch.parentWorlds[k] = worldMatrices[parents[batch.indices[k]]];
+                }
+                Math::multiplyBatch(batch.parentWorlds.data(), batch.matrices.data(), batch.matrices.data(), count);
+            }
+
+            for (std::size_t k = 0; k < count; k++) {
+                std::size_t i = batch.indices[k];
+                worldMatrices[i] = batch.matrices[k];
+                transforms[i]->worldMatrix = batch.matrices[k];
+                transforms[i]->worldMatrixDirty = false;
+                transforms[i]->localChanged = false;
+                transforms[i]->worldMatrixVersion++;
+                transforms[i]->inverseMatricesDirty = true;
+            }
+            updated.fetch_add(count, std::memory_order_relaxed);
+        });
+    }
+    updatedCount = updated.load(std::memory_order_relaxed);
+}
+
+void TransformSystem::rebuild() {
+    // Scratch arrays come from the frame allocator
+    const std::vector<Entity*>& members = getEntities();
+    std::size_t count = members.size();
+
+    // Parent of each member among the members; a parent without a transform
+    // makes its child a root
+    EntityID maxID = 0;
+    for (Entity* entity : members) {
+        maxID = std::max(maxID, entity->getID());
+    }
+    engine::core::FrameVector<std::int32_t> memberIndex(count > 0 ? maxID + 1 : 0, -1);
+    for (std::size_t i = 0; i < count; i++) {
+        memberIndex[members[i]->getID()] = static_cast<std::int32_t>(i);
+    }
+    engine::core::FrameVector<std::int32_t> memberParent(count, -1);
+    for (std::size_t i = 0; i < count; i++) {
+        Entity* parent = members[i]->getParent();
+        if (parent && parent->getID() < memberIndex.size()) {
+            memberParent[i] = memberIndex[parent->getID()];
+        }
+    }
+
+    // Depth of each member, walking up to the nearest ancestor already known
+    engine::core::FrameVector<std::int32_t> depth(count, -1);
+    engine::core::FrameVector<std::size_t> chain;
+    std::int32_t maxDepth = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        std::size_t node = i;
+        chain.clear();
+        // The length check stops parent cycles, which become roots
+        while (depth[node] < 0 && memberParent[node] >= 0 && chain.size() <= count) {
+            chain.push_back(node);
+            node = static_cast<std::size_t>(memberParent[node]);
+        }
+        if (depth[node] < 0) {
+            depth[node] = 0;
+        }
+        while (!chain.empty()) {
+            std::size_t child = chain.back();
+            chain.pop_back();
+            if (depth[child] < 0) {
+                depth[child] = depth[memberParent[child]] + 1;
+            }
+        }
+        maxDepth = std::max(maxDepth, depth[i]);
+    }
+
+    // Counting sort by depth
+    levels.assign(static_cast<std::size_t>(maxDepth) + 2, 0);
+    for (std::size_t i = 0; i < count; i++) {
+        levels[depth[i] + 1]++;
+    }
+    for (std::size_t level = 1; level < levels.size(); level++) {
+        levels[level] += levels[level - 1];
+    }
+    if (count == 0) {
+        levels.clear();
+    }
+
+    engine::core::FrameVector<std::size_t> sortedIndex(count);
+    engine::core::FrameVector<std::size_t> next(levels.begin(), levels.end());
+    for (std::size_t i = 0; i < count; i++) {
+        sortedIndex[i] = next[depth[i]]++;
+    }
+
+    owners.resize(count);
+    transforms.resize(count);
+    parents.resize(count);
+    dirty.assign(count, 0);
+    worldMatrices.resize(count);
+    for (std::size_t i = 0; i < count; i++) {
+        std::size_t position = sortedIndex[i];
+        owners[position] = members[i];
+        transforms[position] = &members[i]->getComponent<TransformComponent>();
+        parents[position] = memberParent[i] >= 0 && depth[memberParent[i]] < depth[i]
+            ? static_cast<std::int32_t>(sortedIndex[memberParent[i]])
+            : -1;
+    }
+
+    builtStructureVersion = getManager()->getStructureVersion();
+    builtHierarchyVersion = getManager()->getHierarchyVersion();
+    builtMembershipVersion = getMembershipVersion();
+    built = true;
+}
+
+void TransformSystem::relink() {
+    // Same members and parents, so the order and parent indices still hold;
+    // only the component addresses may have changed
+    for (std::size_t i = 0; i < owners.size(); i++) {
+        transforms[i] = &owners[i]->getComponent<TransformComponent>();
+    }
+    builtStructureVersion = getManager()->getStructureVersion();
+}
+
+} // namespace ECS
+} // namespace Engine
@@ -12,6 +12,9 @@
 #include "ecs/components/OrbitCameraController.h"
 #include "ecs/components/CameraControllerComponent.h"
 #include "ecs/systems/CameraControllerSystem.h"
+#include "ecs/systems/TransformSystem.h"
+#include "ecs/systems/SpatialIndexSystem.h"
+#include "ecs/systems/BroadphaseSystem.h"
 
 void createScene(Engine::ECS::ECSManager& manager);
 void diagnoseCameraIssue(Engine::ECS::ECSManager& manager);
@@ -196,12 +199,21 @@ int main() {
         ecsManager.initialize(window.get());
         LOG_INFO("ECS manager initialized successfully");
         
+        // Only the camera has controllers; keep them out of archetype chunks
+        ecsManager.registerComponent<Engine::ECS::CameraControllerComponent>(Engine::ECS::StoragePolicy::SparseSet);
+        ecsManager.registerComponent<Engine::ECS::OrbitCameraController>(Engine::ECS::StoragePolicy::SparseSet);
+        
         // Register systems with logging checkpoints
         LOG_DEBUG("Registering RenderSystem");
         ecsManager.registerSystem<Engine::ECS::RenderSystem>();
 
         // In main.cpp after registering the RenderSystem
         ecsManager.registerSystem<Engine::ECS::CameraControllerSystem>();
+        
+        // After everything that moves transforms
+        ecsManager.registerSystem<Engine::ECS::TransformSystem>();
+        ecsManager.registerSystem<Engine::ECS::SpatialIndexSystem>();
+        ecsManager.registerSystem<Engine::ECS::BroadphaseSystem>();
 
         
         // Create scene entities with logging checkpoints
@@ -248,7 +260,8 @@ void createScene(Engine::ECS::ECSManager& manager) {
               << cameraEntity->getComponent<Engine::ECS::TransformComponent>().getPosition().x
               << ", " << cameraEntity->getComponent<Engine::ECS::TransformComponent>().getPosition().y
               << ", " << cameraEntity->getComponent<Engine::ECS::TransformComponent>().getPosition().z << ")\n";
-    std::cout << "Camera is main: " << camera.isMain() << "\n";
+    // Adding components moved the camera to a new archetype, so look it up again
+    std::cout << "Camera is main: " << cameraEntity->getComponent<Engine::ECS::CameraComponent>().isMain() << "\n";
     
     // Create a cube entity
     auto cubeEntity = manager.createEntity();
@@ -0,0 +1,189 @@
+#include "rendering/geometry_arena.h"
+#include "rendering/mesh.h"
+#include <GL/glew.h>
+#include <algorithm>
+
+namespace engine {
+namespace rendering {
+
+std::uint32_t GeometryArena::Space::allocate(std::uint32_t count) {
+    for (std::size_t i = 0; i < freeBlocks.size(); i++) {
+        FreeBlock& block = freeBlocks[i];
+        if (block.count >= count) {
+            std::uint32_t offset = block.offset;
+            block.offset += count;
+            block.count -= count;
+            if (block.count == 0) {
+                freeBlocks.erase(freeBlocks.begin() + i);
+            }
+            return offset;
+        }
+    }
+    if (count > capacity - end) {
+        return capacity;
+    }
+    std::uint32_t offset = end;
+    end += count;
+    return offset;
+}
+
+void GeometryArena::Space::release(std::uint32_t offset, std::uint32_t count) {
+    auto next = std::lower_bound(freeBlocks.begin(), freeBlocks.end(), offset,
+                                 [](const FreeBlock& block, std::uint32_t value) { return block.offset < value; });
+
+    // Merge with the neighbors it touches
+    if (next != freeBlocks.end() && offset + count == next->offset) {
+        count += next->count;
+        next = freeBlocks.erase(next);
+    }
+    if (next != freeBlocks.begin()) {
+        auto previous = next - 1;
+        if (previous->offset + previous->count == offset) {
+            offset = previous->offset;
+            count += previous->count;
+            next = freeBlocks.erase(previous);
+        }
+    }
+
+    if (offset + count == end) {
+        end = offset;
+    } else {
+        freeBlocks.insert(next, {offset, count});
+    }
+}
+
+GeometryArena::GeometryArena(std::size_t vertexCapacity, std::size_t indexCapacity) {
+    m_vertices.capacity = static_cast<std::uint32_t>(vertexCapacity);
+    m_indices.capacity = static_cast<std::uint32_t>(indexCapacity);
+}
+
+GeometryArena::~GeometryArena() {
+    if (m_VAO != 0) {
+        glDeleteVertexArrays(1, &m_VAO);
+        glDeleteBuffers(1, &m_VBO);
+        glDeleteBuffers(1, &m_EBO);
+    }
+}
+
+GeometryArena& GeometryArena::getInstance() {
+    static GeometryArena* instance = new GeometryArena();
+    return *instance;
+}
+
+GeometryArena::Range GeometryArena::allocate(const std::vector<Vertex>& vertices,
+                                             const std::vector<unsigned int>& indices) {
+    if (m_VAO == 0) {
+        createBuffers();
+    }
+
+    Range range;
+    range.vertexCount = static_cast<std::uint32_t>(vertices.size());
+    range.indexCount = static_cast<std::uint32_t>(indices.size());
+    range.firstVertex = allocateIn(m_vertices, m_VBO, sizeof(Vertex), range.vertexCount);
+    range.firstIndex = allocateIn(m_indices, m_EBO, sizeof(unsigned int), range.indexCount);
+
+    // Upload through the copy target, which is not vertex array state
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_VBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, range.firstVertex * sizeof(Vertex), vertices.size() * sizeof(Vertex),
+                    vertices.data());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_EBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, range.firstIndex * sizeof(unsigned int),
+                    indices.size() * sizeof(unsigned int), indices.data());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    return range;
+}
+
+void GeometryArena::updateVertices(const Range& range, const std::vector<Vertex>& vertices) {
+    std::size_t count = std::min<std::size_t>(range.vertexCount, vertices.size());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_VBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, range.firstVertex * sizeof(Vertex), count * sizeof(Vertex),
+                    vertices.data());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void GeometryArena::release(const Range& range) {
+    if (range.vertexCount > 0) {
+        m_vertices.release(range.firstVertex, range.vertexCount);
+    }
+    if (range.indexCount > 0) {
+        m_indices.release(range.firstIndex, range.indexCount);
+    }
+}
+
+void GeometryArena::bind() const {
+    glBindVertexArray(m_VAO);
+}
+
+void GeometryArena::createBuffers() {
+    glGenVertexArrays(1, &m_VAO);
+    glGenBuffers(1, &m_VBO);
+    glGenBuffers(1, &m_EBO);
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_VBO);
+    glBufferData(GL_COPY_WRITE_BUFFER, m_vertices.capacity * sizeof(Vertex), nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_EBO);
+    glBufferData(GL_COPY_WRITE_BUFFER, m_indices.capacity * sizeof(unsigned int), nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    setupVertexArray();
+}
+
+void GeometryArena::setupVertexArray() {
+    glBindVertexArray(m_VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+
+    // Position attribute
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+
+    // Normal attribute
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+
+    // Texture coordinate attribute
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoord));
+
+    // Tangent attribute
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tangent));
+
+    // Bitangent attribute
+    glEnableVertexAttribArray(4);
+    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, bitangent));
+
+    glBindVertexArray(0);
+}
+
+std::uint32_t GeometryArena::allocateIn(Space& space, unsigned int& buffer, std::size_t elementSize,
+                                        std::uint32_t count) {
+    std::uint32_t offset = space.allocate(count);
+    if (offset != space.capacity) {
+        return offset;
+    }
+
+    std::uint32_t capacity = space.capacity;
+    while (count > capacity - space.end) {
+        capacity *= 2;
+    }
+
+    // Copy into a larger buffer and point the vertex array at it
+    unsigned int grown = 0;
+    glGenBuffers(1, &grown);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, grown);
+    glBufferData(GL_COPY_WRITE_BUFFER, capacity * elementSize, nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, space.end * elementSize);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glDeleteBuffers(1, &buffer);
+    buffer = grown;
+    space.capacity = capacity;
+    setupVertexArray();
+
+    return space.allocate(count);
+}
+
+} // namespace rendering
+} // namespace engine
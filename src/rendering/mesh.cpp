@@ -2,34 +2,25 @@
 #include <GL/glew.h>
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
+#include <algorithm>
+#include <cmath>
 #include "rendering/debug/gl_debug.h"
 
 namespace engine {
 namespace rendering {
 
-Mesh::Mesh()
-    : m_VAO(0)
-    , m_VBO(0)
-    , m_EBO(0)
-{
+Mesh::Mesh() {
 }
 
 Mesh::~Mesh() {
-    // Clean up OpenGL resources
-    if (m_VAO != 0) {
-        glDeleteVertexArrays(1, &m_VAO);
-    }
-    if (m_VBO != 0) {
-        glDeleteBuffers(1, &m_VBO);
-    }
-    if (m_EBO != 0) {
-        glDeleteBuffers(1, &m_EBO);
-    }
+    // Hand the buffer ranges back to the arena
+    GeometryArena::getInstance().release(m_geometry);
 }
 
 void Mesh::setVertices(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices) {
     m_vertices = vertices;
     m_indices = indices;
+    computeBounds();
     
     // Set up the mesh with the new data
     setupMesh();
@@ -40,6 +31,29 @@ void Mesh::setVertices(const std::vector<Vertex>& vertices, const std::vector<un
     }
 }
 
+void Mesh::computeBounds() {
+    m_bounds = Engine::Math::AABB();
+    for (const Vertex& vertex : m_vertices) {
+        m_bounds.merge(Engine::Math::Vector3(vertex.position.x, vertex.position.y, vertex.position.z));
+    }
+    
+    if (m_bounds.isEmpty()) {
+        m_boundingSphere = Engine::Math::BoundingSphere();
+        return;
+    }
+    
+    // Centered on the box, just large enough for the furthest vertex; tighter
+    // than the box's half diagonal for most shapes
+    Engine::Math::Vector3 center = m_bounds.center();
+    float radiusSquared = 0.0f;
+    for (const Vertex& vertex : m_vertices) {
+        Engine::Math::Vector3 offset(vertex.position.x - center.x, vertex.position.y - center.y,
+                                     vertex.position.z - center.z);
+        radiusSquared = std::max(radiusSquared, offset.dot(offset));
+    }
+    m_boundingSphere = Engine::Math::BoundingSphere(center, std::sqrt(radiusSquared));
+}
+
 void Mesh::computeTangentBasis() {
     // Skip if we don't have enough indices for triangles
     if (m_indices.size() < 3) {
@@ -79,58 +93,14 @@ void Mesh::computeTangentBasis() {
     }
     
     // Re-upload the vertex data to the GPU
-    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-    glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(Vertex), m_vertices.data(), GL_STATIC_DRAW);
+    GeometryArena::getInstance().updateVertices(m_geometry, m_vertices);
 }
 
 void Mesh::setupMesh() {
-    // Clean up previous resources if they exist
-    if (m_VAO != 0) {
-        glDeleteVertexArrays(1, &m_VAO);
-        glDeleteBuffers(1, &m_VBO);
-        glDeleteBuffers(1, &m_EBO);
-    }
-    
-    // Create buffers/arrays
-    glGenVertexArrays(1, &m_VAO);
-    glGenBuffers(1, &m_VBO);
-    glGenBuffers(1, &m_EBO);
-    
-    // Bind VAO first
-    glBindVertexArray(m_VAO);
-    
-    // Load data into vertex buffer
-    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-    glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(Vertex), m_vertices.data(), GL_STATIC_DRAW);
-    
-    // Load data into index buffer
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(unsigned int), m_indices.data(), GL_STATIC_DRAW);
-    
-    // Set vertex attribute pointers
-    
-    // Position attribute
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
-    
-    // Normal attribute
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-    
-    // Texture coordinate attribute
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoord));
-    
-    // Tangent attribute
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tangent));
-    
-    // Bitangent attribute
-    glEnableVertexAttribArray(4);
-    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, bitangent));
-    
-    // Unbind VAO
-    glBindVertexArray(0);
+    // Release the previous data, then copy into the shared buffers
+    GeometryArena& arena = GeometryArena::getInstance();
+    arena.release(m_geometry);
+    m_geometry = arena.allocate(m_vertices, m_indices);
 }
 
 glm::mat4 Mesh::getModelMatrix() const {
@@ -146,9 +116,19 @@ glm::mat4 Mesh::getModelMatrix() const {
 
 void Mesh::render(Shader& shader) {
     // Just bind VAO and draw elements
-    glBindVertexArray(m_VAO);
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_indices.size()), GL_UNSIGNED_INT, 0);
+    bind();
+    draw();
     glBindVertexArray(0);
 }
+
+void Mesh::bind() const {
+    GeometryArena::getInstance().bind();
+}
+
+void Mesh::draw() const {
+    glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(m_geometry.indexCount), GL_UNSIGNED_INT,
+                             reinterpret_cast<void*>(m_geometry.firstIndex * sizeof(unsigned int)),
+                             static_cast<GLint>(m_geometry.firstVertex));
+}
 } // namespace rendering
 } // namespace engine
@@ -5,6 +5,18 @@ namespace rendering {
 
 std::shared_ptr<engine::rendering::Texture> engine::rendering::Material::m_fallbackTexture = nullptr;
 
+namespace {
+
+// std140 vec4 from a vec3
+void storeColor(const glm::vec3& color, float (&out)[4]) {
+    out[0] = color.x;
+    out[1] = color.y;
+    out[2] = color.z;
+    out[3] = 1.0f;
+}
+
+} // namespace
+
 Material::Material()
     : m_ambient(0.2f, 0.2f, 0.2f)
     , m_diffuse(0.8f, 0.8f, 0.8f)
@@ -20,43 +32,76 @@ Material::Material()
 }
 
 void Material::apply(Shader& shader) const {
+    if (shader.hasUniformBlock(UniformBlock::Material)) {
+        if (m_uniformsDirty || !m_uniformBuffer.isCreated()) {
+            MaterialUniforms block = {};
+            storeColor(m_ambient, block.ambient);
+            storeColor(m_diffuse, block.diffuse);
+            storeColor(m_specular, block.specular);
+            block.shininess = m_shininess;
+            block.hasDiffuseMap = hasDiffuseMap() ? 1 : 0;
+            block.hasSpecularMap = hasSpecularMap() ? 1 : 0;
+            block.hasNormalMap = hasNormalMap() ? 1 : 0;
+            m_uniformBuffer.setData(block);
+            m_uniformsDirty = false;
+        }
+        m_uniformBuffer.bind(UniformBlock::Material);
+        // The shader fixed its sampler units when it was linked
+        bindTextures();
+        return;
+    }
+    
+    ShaderUniforms& uniforms = m_shaderUniforms;
+    if (uniforms.program != shader.getID()) {
+        uniforms.program = shader.getID();
+        uniforms.ambient = shader.getUniform("material.ambient");
+        uniforms.diffuse = shader.getUniform("material.diffuse");
+        uniforms.specular = shader.getUniform("material.specular");
+        uniforms.shininess = shader.getUniform("material.shininess");
+        uniforms.hasDiffuseMap = shader.getUniform("material.hasDiffuseMap");
+        uniforms.hasSpecularMap = shader.getUniform("material.hasSpecularMap");
+        uniforms.hasNormalMap = shader.getUniform("material.hasNormalMap");
+        uniforms.diffuseMap = m_diffuseMap ? shader.getUniform("material.diffuseMap") : Uniform();
+        uniforms.specularMap = m_specularMap ? shader.getUniform("material.specularMap") : Uniform();
+        uniforms.normalMap = m_normalMap ? shader.getUniform("material.normalMap") : Uniform();
+    }
+    
     // Set material properties in the shader
-    shader.setVec3("material.ambient", m_ambient);
-    shader.setVec3("material.diffuse", m_diffuse);
-    shader.setVec3("material.specular", m_specular);
-    shader.setFloat("material.shininess", m_shininess);
+    shader.setVec3(uniforms.ambient, m_ambient);
+    shader.setVec3(uniforms.diffuse, m_diffuse);
+    shader.setVec3(uniforms.specular, m_specular);
+    shader.setFloat(uniforms.shininess, m_shininess);
     
     // Set texture usage flags
-    shader.setInt("material.hasDiffuseMap", hasDiffuseMap() ? 1 : 0);
-    shader.setInt("material.hasSpecularMap", hasSpecularMap() ? 1 : 0);
-    shader.setInt("material.hasNormalMap", hasNormalMap() ? 1 : 0);
+    shader.setInt(uniforms.hasDiffuseMap, hasDiffuseMap() ? 1 : 0);
+    shader.setInt(uniforms.hasSpecularMap, hasSpecularMap() ? 1 : 0);
+    shader.setInt(uniforms.hasNormalMap, hasNormalMap() ? 1 : 0);
     
-    // Bind textures if available
+    // Tell the shader which texture unit each map uses
+    if (m_diffuseMap) {
+        shader.setInt(uniforms.diffuseMap, DIFFUSE_TEXTURE_UNIT);
+    }
+    if (m_specularMap) {
+        shader.setInt(uniforms.specularMap, SPECULAR_TEXTURE_UNIT);
+    }
+    if (m_normalMap) {
+        shader.setInt(uniforms.normalMap, NORMAL_TEXTURE_UNIT);
+    }
+    bindTextures();
+}
+
+void Material::bindTextures() const {
+    // Bind textures if available. Texture::bind selects the unit itself.
     if (m_diffuseMap) {
-        // Activate texture unit 0
-        glActiveTexture(GL_TEXTURE0);
-        // Bind the diffuse texture
-        m_diffuseMap->bind();
-        // Tell the shader to use texture unit 0 for the diffuse map
-        shader.setInt("material.diffuseMap", 0);
+        m_diffuseMap->bind(DIFFUSE_TEXTURE_UNIT);
     }
     
     if (m_specularMap) {
-        // Activate texture unit 1
-        glActiveTexture(GL_TEXTURE1);
-        // Bind the specular texture
-        m_specularMap->bind();
-        // Tell the shader to use texture unit 1 for the specular map
-        shader.setInt("material.specularMap", 1);
+        m_specularMap->bind(SPECULAR_TEXTURE_UNIT);
     }
     
     if (m_normalMap) {
-        // Activate texture unit 2
-        glActiveTexture(GL_TEXTURE2);
-        // Bind the normal texture
-        m_normalMap->bind();
-        // Tell the shader to use texture unit 2 for the normal map
-        shader.setInt("material.normalMap", 2);
+        m_normalMap->bind(NORMAL_TEXTURE_UNIT);
     }
 }
 
@@ -5,12 +5,84 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>
-#include <map>
+#include <cstdlib>
 #include <filesystem>
+#include <iterator>
+#include <string_view>
+#include <unordered_map>
 
 namespace engine {
 namespace rendering {
 
+namespace {
+
+// Resolved 0-based indices of one face vertex; -1 where a field is absent
+struct ObjVertexKey {
+    int position = -1;
+    int texCoord = -1;
+    int normal = -1;
+    
+    bool operator==(const ObjVertexKey& other) const {
+        return position == other.position && texCoord == other.texCoord && normal == other.normal;
+    }
+};
+
+struct ObjVertexKeyHash {
+    std::size_t operator()(const ObjVertexKey& key) const {
+        std::size_t hash = static_cast<std::size_t>(key.position) * 73856093u;
+        hash ^= static_cast<std::size_t>(key.texCoord) * 19349663u;
+        hash ^= static_cast<std::size_t>(key.normal) * 83492791u;
+        return hash;
+    }
+};
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Next whitespace-separated token before `end`, or empty at the end of the line
+std::string_view nextToken(const char*& p, const char* end) {
+    while (p < end && isSpace(*p)) {
+        p++;
+    }
+    const char* start = p;
+    while (p < end && !isSpace(*p)) {
+        p++;
+    }
+    return std::string_view(start, static_cast<std::size_t>(p - start));
+}
+
+float parseFloat(const char*& p, const char* end) {
+    while (p < end && isSpace(*p)) {
+        p++;
+    }
+    if (p >= end) {
+        return 0.0f;
+    }
+    // The buffer is null-terminated and strtof stops at the newline
+    char* next = nullptr;
+    float value = std::strtof(p, &next);
+    p = next;
+    return value;
+}
+
+// OBJ index field: 1-based, or negative to count back from the latest
+// element. Returns the 0-based index, or -1 for an empty field.
+int parseIndex(const char*& p, const char* end, std::size_t count) {
+    if (p >= end || *p == '/') {
+        return -1;
+    }
+    char* next = nullptr;
+    long value = std::strtol(p, &next, 10);
+    p = std::min<const char*>(next, end);
+    if (value < 0) {
+        return static_cast<int>(static_cast<long>(count) + value);
+    }
+    return static_cast<int>(value - 1);
+}
+
+} // namespace
+
 Model::Model() {
 }
 
@@ -29,23 +101,45 @@ bool Model::loadFromFile(const std::string& filePath) {
     }
     
     // Use the appropriate loader based on file extension
+    bool loaded = false;
     if (extension == ".obj") {
-        return loadOBJ(filePath);
+        loaded = loadOBJ(filePath);
     } else if (extension == ".fbx") {
-        return loadFBX(filePath);
+        loaded = loadFBX(filePath);
     } else if (extension == ".gltf" || extension == ".glb") {
-        return loadGLTF(filePath);
+        loaded = loadGLTF(filePath);
     } else {
         std::cerr << "Unsupported model format: " << extension << std::endl;
-        return false;
     }
+    
+    updateBounds();
+    return loaded;
 }
 
-void Model::render(Shader& shader) {
-    std::cout << "Model::render - Meshes count: " << m_meshes.size() << std::endl;
+void Model::updateBounds() {
+    m_bounds = Engine::Math::AABB();
+    for (const auto& mesh : m_meshes) {
+        m_bounds.merge(mesh->getBounds());
+    }
     
+    // Centered on the combined box, reaching the far side of every mesh sphere
+    m_boundingSphere = Engine::Math::BoundingSphere();
+    if (m_bounds.isEmpty()) {
+        return;
+    }
+    Engine::Math::Vector3 center = m_bounds.center();
+    float radius = 0.0f;
+    for (const auto& mesh : m_meshes) {
+        const Engine::Math::BoundingSphere& sphere = mesh->getBoundingSphere();
+        if (!sphere.isEmpty()) {
+            radius = std::max(radius, (sphere.center - center).magnitude() + sphere.radius);
+        }
+    }
+    m_boundingSphere = Engine::Math::BoundingSphere(center, radius);
+}
+
+void Model::render(Shader& shader) {
     for (size_t i = 0; i < m_meshes.size(); i++) {
-        std::cout << "Rendering mesh " << i << std::endl;
         // Apply material if available
         if (i < m_materials.size() && m_materials[i]) {
             m_materials[i]->apply(shader);
@@ -59,111 +153,118 @@ void Model::render(Shader& shader) {
 bool Model::loadOBJ(const std::string& filePath) {
     std::cout << "Loading OBJ model: " << filePath << std::endl;
     
+    // Read the whole file at once and parse it in place, instead of a
+    // string and a stream per line and per face vertex
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to open file: " << filePath << std::endl;
+        return false;
+    }
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    
     std::vector<glm::vec3> positions;
     std::vector<glm::vec3> normals;
     std::vector<glm::vec2> texCoords;
     
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
+    std::vector<unsigned int> faceIndices;
     
     // Maps to track unique vertices
-    std::map<std::string, unsigned int> uniqueVertices;
+    std::unordered_map<ObjVertexKey, unsigned int, ObjVertexKeyHash> uniqueVertices;
     
-    // Current material
-    int currentMaterialIndex = -1;
     std::string materialLib;
     
-    std::ifstream file(filePath);
-    if (!file) {
-        std::cerr << "Failed to open file: " << filePath << std::endl;
-        return false;
-    }
-    
-    std::string line;
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string prefix;
-        iss >> prefix;
+    const char* cursor = text.data();
+    const char* textEnd = text.data() + text.size();
+    while (cursor < textEnd) {
+        const char* lineEnd = std::find(cursor, textEnd, '\n');
+        const char* p = cursor;
+        cursor = lineEnd + (lineEnd < textEnd ? 1 : 0);
         
+        std::string_view prefix = nextToken(p, lineEnd);
         if (prefix == "v") {
             // Vertex position
             glm::vec3 position;
-            iss >> position.x >> position.y >> position.z;
+            position.x = parseFloat(p, lineEnd);
+            position.y = parseFloat(p, lineEnd);
+            position.z = parseFloat(p, lineEnd);
             positions.push_back(position);
         } else if (prefix == "vn") {
             // Vertex normal
             glm::vec3 normal;
-            iss >> normal.x >> normal.y >> normal.z;
+            normal.x = parseFloat(p, lineEnd);
+            normal.y = parseFloat(p, lineEnd);
+            normal.z = parseFloat(p, lineEnd);
             normals.push_back(normal);
         } else if (prefix == "vt") {
             // Texture coordinate
             glm::vec2 texCoord;
-            iss >> texCoord.x >> texCoord.y;
+            texCoord.x = parseFloat(p, lineEnd);
+            texCoord.y = parseFloat(p, lineEnd);
             // OBJ format has origin at bottom-left, OpenGL expects top-left
             texCoord.y = 1.0f - texCoord.y;
             texCoords.push_back(texCoord);
         } else if (prefix == "f") {
             // Face definition
-            std::string vertexData;
-            std::vector<unsigned int> faceIndices;
+            faceIndices.clear();
             
-            // Process each vertex in the face
-            while (iss >> vertexData) {
-                // Format check: position/texcoord/normal
-                std::istringstream viss(vertexData);
-                std::string positionIndex, texCoordIndex, normalIndex;
-                
-                // Parse the vertex format (p/t/n, p//n, p/t, or p)
-                std::getline(viss, positionIndex, '/');
-                std::getline(viss, texCoordIndex, '/');
-                std::getline(viss, normalIndex, '/');
-                
-                // Create a unique string identifier for this vertex
-                std::string vertexKey = vertexData;
+            // Process each vertex in the face: p/t/n, p//n, p/t, or p
+            for (std::string_view vertexData = nextToken(p, lineEnd); !vertexData.empty();
+                 vertexData = nextToken(p, lineEnd)) {
+                const char* field = vertexData.data();
+                const char* fieldEnd = field + vertexData.size();
+                ObjVertexKey key;
+                key.position = parseIndex(field, fieldEnd, positions.size());
+                if (field < fieldEnd && *field == '/') {
+                    field++;
+                    key.texCoord = parseIndex(field, fieldEnd, texCoords.size());
+                    if (field < fieldEnd && *field == '/') {
+                        field++;
+                        key.normal = parseIndex(field, fieldEnd, normals.size());
+                    }
+                }
+                if (key.position < 0 || key.position >= static_cast<int>(positions.size())) {
+                    std::cerr << "Invalid OBJ face index in " << filePath << std::endl;
+                    continue;
+                }
                 
                 // Check if we've seen this vertex before
-                if (uniqueVertices.find(vertexKey) == uniqueVertices.end()) {
+                auto found = uniqueVertices.find(key);
+                if (found == uniqueVertices.end()) {
                     // New vertex - create and add it
                     Vertex vertex;
+                    vertex.position = positions[key.position];
                     
-                    // OBJ indices are 1-based, convert to 0-based
-                    int pIdx = std::stoi(positionIndex) - 1;
-                    vertex.position = positions[pIdx];
-                    
-                    // Only add texture coords if provided
-                    if (!texCoordIndex.empty()) {
-                        int tIdx = std::stoi(texCoordIndex) - 1;
-                        vertex.texCoord = texCoords[tIdx];
+                    // Only add texture coords and normals if provided
+                    if (key.texCoord >= 0 && key.texCoord < static_cast<int>(texCoords.size())) {
+                        vertex.texCoord = texCoords[key.texCoord];
                     }
-                    
-                    // Only add normals if provided
-                    if (!normalIndex.empty()) {
-                        int nIdx = std::stoi(normalIndex) - 1;
-                        vertex.normal = normals[nIdx];
+                    if (key.normal >= 0 && key.normal < static_cast<int>(normals.size())) {
+                        vertex.normal = normals[key.normal];
                     }
                     
                     // Add the vertex and record its index
-                    uniqueVertices[vertexKey] = static_cast<unsigned int>(vertices.size());
+                    found = uniqueVertices.emplace(key, static_cast<unsigned int>(vertices.size())).first;
                     vertices.push_back(vertex);
                 }
                 
                 // Add this vertex's index to our face indices
-                faceIndices.push_back(uniqueVertices[vertexKey]);
+                faceIndices.push_back(found->second);
             }
             
             // Triangulate the face (assuming convex)
-            for (size_t i = 1; i < faceIndices.size() - 1; i++) {
+            for (size_t i = 2; i < faceIndices.size(); i++) {
                 indices.push_back(faceIndices[0]);
+                indices.push_back(faceIndices[i - 1]);
                 indices.push_back(faceIndices[i]);
-                indices.push_back(faceIndices[i + 1]);
             }
         } else if (prefix == "mtllib") {
             // Material library
-            iss >> materialLib;
+            materialLib = std::string(nextToken(p, lineEnd));
         } else if (prefix == "usemtl") {
             // Material use
-            std::string materialName;
-            iss >> materialName;
+            std::string materialName(nextToken(p, lineEnd));
             
             // If we've accumulated vertices, create a mesh with the current material
             if (!vertices.empty()) {
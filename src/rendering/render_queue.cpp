@@ -0,0 +1,339 @@
+#include "rendering/render_queue.h"
+#include "rendering/shader.h"
+#include "rendering/mesh.h"
+#include "rendering/model/material.h"
+#include "ecs/math/Matrix4x4.h"
+#include "ecs/math/Affine3x4.h"
+#include "ecs/math/Matrix3x3.h"
+#include <GL/glew.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace engine {
+namespace rendering {
+
+namespace {
+
+constexpr int SHADER_BITS = 10;
+constexpr int MATERIAL_BITS = 14;
+constexpr int MESH_BITS = 14;
+constexpr int DEPTH_BITS = 24;
+constexpr int STATE_BITS = SHADER_BITS + MATERIAL_BITS + MESH_BITS;
+
+constexpr std::uint64_t mask(int bits) {
+    return (std::uint64_t(1) << bits) - 1;
+}
+
+// Depth as an unsigned integer with the same ordering. The bit pattern of a
+// non-negative float grows with its value, so its top bits are a quantized
+// depth with precision relative to the distance.
+std::uint64_t quantizeDepth(float depth) {
+    if (!(depth > 0.0f)) {
+        return 0;   // also NaN
+    }
+    std::uint32_t bits;
+    std::memcpy(&bits, &depth, sizeof(bits));
+    return bits >> (31 - DEPTH_BITS);
+}
+
+// Drop the ids of `ids` once it holds more objects than `bits` can number
+void forgetIfFull(std::unordered_map<const void*, std::uint32_t>& ids, int bits) {
+    if (ids.size() > mask(bits)) {
+        ids.clear();
+    }
+}
+
+// Point the instance attributes of the bound vertex array at `buffer`,
+// starting `offset` bytes in
+void setInstanceAttributes(unsigned int buffer, std::size_t offset, std::size_t stride, std::size_t normalOffset) {
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    for (unsigned int column = 0; column < 4; column++) {
+        GLuint location = RenderQueue::INSTANCE_MODEL_LOCATION + column;
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, static_cast<GLsizei>(stride),
+                              reinterpret_cast<void*>(offset + column * 4 * sizeof(float)));
+        glVertexAttribDivisor(location, 1);
+    }
+    for (unsigned int column = 0; column < 3; column++) {
+        GLuint location = RenderQueue::INSTANCE_NORMAL_LOCATION + column;
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, static_cast<GLsizei>(stride),
+                              reinterpret_cast<void*>(offset + normalOffset + column * 4 * sizeof(float)));
+        glVertexAttribDivisor(location, 1);
+    }
+}
+
+// Upload `bytes` to a stream buffer, growing it as needed. Orphans the
+// previous frame's storage rather than wait for the GPU to finish with it.
+void streamToBuffer(GLenum target, unsigned int& buffer, std::size_t& capacity, const void* data, std::size_t bytes) {
+    if (buffer == 0) {
+        glGenBuffers(1, &buffer);
+    }
+    if (bytes > capacity) {
+        capacity = bytes + bytes / 2;
+    }
+    glBindBuffer(target, buffer);
+    glBufferData(target, static_cast<GLsizeiptr>(capacity), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(target, 0, static_cast<GLsizeiptr>(bytes), data);
+}
+
+} // namespace
+
+RenderQueue::~RenderQueue() {
+    if (m_instanceBuffer != 0) {
+        glDeleteBuffers(1, &m_instanceBuffer);
+    }
+    if (m_indirectBuffer != 0) {
+        glDeleteBuffers(1, &m_indirectBuffer);
+    }
+}
+
+void RenderQueue::setInstancedVariant(Shader& shader, Shader* variant) {
+    if (variant) {
+        m_instancedVariants[&shader] = variant;
+    } else {
+        m_instancedVariants.erase(&shader);
+    }
+}
+
+std::uint64_t RenderQueue::makeKey(RenderPass pass, std::uint32_t shaderId, std::uint32_t materialId,
+                                   std::uint32_t meshId, float depth) {
+    std::uint64_t state = (std::uint64_t(shaderId) & mask(SHADER_BITS)) << (MATERIAL_BITS + MESH_BITS) |
+                          (std::uint64_t(materialId) & mask(MATERIAL_BITS)) << MESH_BITS |
+                          (std::uint64_t(meshId) & mask(MESH_BITS));
+    std::uint64_t quantized = quantizeDepth(depth);
+    std::uint64_t key = std::uint64_t(pass) << (STATE_BITS + DEPTH_BITS);
+
+    if (pass == RenderPass::Transparent) {
+        // Back to front first, state only breaks ties
+        return key | (mask(DEPTH_BITS) - quantized) << STATE_BITS | state;
+    }
+    return key | state << DEPTH_BITS | quantized;
+}
+
+std::uint32_t RenderQueue::idFor(std::unordered_map<const void*, std::uint32_t>& ids, const void* object) {
+    auto [it, inserted] = ids.try_emplace(object, static_cast<std::uint32_t>(ids.size()));
+    return it->second;
+}
+
+void RenderQueue::clear() {
+    m_commands.clear();
+    m_sorted.clear();
+
+    // Ids only need to be consistent within a frame. Objects are never
+    // forgotten otherwise, so without this, ids of new objects would alias
+    // older ones once a field is used up.
+    forgetIfFull(m_shaderIds, SHADER_BITS);
+    forgetIfFull(m_materialIds, MATERIAL_BITS);
+    forgetIfFull(m_meshIds, MESH_BITS);
+}
+
+void RenderQueue::add(RenderPass pass, Shader& shader, Material* material, Mesh& mesh, float depth,
+                      const Engine::Math::Affine3x4& worldMatrix, const Engine::Math::Matrix3x3& normalMatrix) {
+    std::uint64_t key = makeKey(pass, idFor(m_shaderIds, &shader), idFor(m_materialIds, material),
+                                idFor(m_meshIds, &mesh), depth);
+    m_sorted.push_back({key, static_cast<std::uint32_t>(m_commands.size())});
+    Shader* instancedShader = nullptr;
+    if (!m_instancedVariants.empty()) {
+        auto it = m_instancedVariants.find(&shader);
+        if (it != m_instancedVariants.end()) {
+            instancedShader = it->second;
+        }
+    }
+    m_commands.push_back({&shader, instancedShader, material, &mesh, &worldMatrix, &normalMatrix});
+}
+
+void RenderQueue::sort() {
+    // LSD radix sort on bytes. One pass over the keys builds all eight
+    // histograms; a byte that is the same in every key needs no pass, which
+    // skips most of them when few ids are in use.
+    std::size_t count = m_sorted.size();
+    if (count < 2) {
+        return;
+    }
+
+    std::size_t histograms[8][256] = {};
+    for (const SortEntry& entry : m_sorted) {
+        for (int byte = 0; byte < 8; byte++) {
+            histograms[byte][(entry.key >> (byte * 8)) & 0xff]++;
+        }
+    }
+
+    m_sortScratch.resize(count);
+    SortEntry* source = m_sorted.data();
+    SortEntry* destination = m_sortScratch.data();
+    for (int byte = 0; byte < 8; byte++) {
+        std::size_t* histogram = histograms[byte];
+        if (histogram[(source[0].key >> (byte * 8)) & 0xff] == count) {
+            continue;
+        }
+
+        std::size_t offset = 0;
+        for (int digit = 0; digit < 256; digit++) {
+            std::size_t digitCount = histogram[digit];
+            histogram[digit] = offset;
+            offset += digitCount;
+        }
+        for (std::size_t i = 0; i < count; i++) {
+            destination[histogram[(source[i].key >> (byte * 8)) & 0xff]++] = source[i];
+        }
+        std::swap(source, destination);
+    }
+
+    if (source != m_sorted.data()) {
+        m_sorted.swap(m_sortScratch);
+    }
+}
+
+void RenderQueue::buildBatches() {
+    m_batches.clear();
+    m_indirect.clear();
+    m_instanceData.clear();
+
+    std::size_t count = m_sorted.size();
+    for (std::size_t i = 0; i < count;) {
+        const Command& command = m_commands[m_sorted[i].command];
+        if (!command.instancedShader) {
+            Batch batch = {static_cast<std::uint32_t>(i), 1, 0, 0, 0};
+            if (command.shader->hasUniformBlock(UniformBlock::Object)) {
+                ObjectUniforms object;
+                storeMatrix(*command.worldMatrix, object.model);
+                storeNormalMatrix(*command.normalMatrix, object.normalMatrix);
+                batch.objectOffset = static_cast<std::uint32_t>(m_objectUniforms.write(&object, sizeof(object)));
+            }
+            m_batches.push_back(batch);
+            i++;
+            continue;
+        }
+
+        // Sorting put draws sharing shader and material next to each other,
+        // and within them draws of the same mesh
+        Batch batch = {static_cast<std::uint32_t>(i), 0, static_cast<std::uint32_t>(m_indirect.size()), 0, 0};
+        for (; i < count; i++) {
+            const Command& next = m_commands[m_sorted[i].command];
+            if (next.shader != command.shader || next.material != command.material) {
+                break;
+            }
+            m_indirect.add(next.mesh->getGeometry(), static_cast<std::uint32_t>(m_instanceData.size()));
+
+            ObjectUniforms& instance = m_instanceData.emplace_back();
+            storeMatrix(*next.worldMatrix, instance.model);
+            storeNormalMatrix(*next.normalMatrix, instance.normalMatrix);
+            batch.count++;
+        }
+        batch.commandCount = static_cast<std::uint32_t>(m_indirect.size()) - batch.firstCommand;
+        m_batches.push_back(batch);
+    }
+}
+
+void RenderQueue::uploadBuffers() {
+    m_objectUniforms.flush();
+    if (m_instanceData.empty()) {
+        return;
+    }
+    if (m_multiDrawIndirect) {
+        streamToBuffer(GL_DRAW_INDIRECT_BUFFER, m_indirectBuffer, m_indirectBufferCapacity,
+                       m_indirect.getCommands().data(), m_indirect.size() * sizeof(DrawElementsIndirectCommand));
+    }
+    streamToBuffer(GL_ARRAY_BUFFER, m_instanceBuffer, m_instanceBufferCapacity, m_instanceData.data(),
+                   m_instanceData.size() * sizeof(ObjectUniforms));
+    if (m_multiDrawIndirect) {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, INSTANCE_STORAGE_BINDING, m_instanceBuffer);
+    }
+}
+
+void RenderQueue::submit(const Engine::Math::Matrix4x4& view, const Engine::Math::Matrix4x4& projection) {
+    if (!m_capabilitiesChecked) {
+        // Base instance (4.2) and storage buffers come with 4.3 as well
+        m_multiDrawIndirect = GLEW_VERSION_4_3;
+        m_capabilitiesChecked = true;
+    }
+
+    m_stats = Stats();
+    m_objectUniforms.beginFrame();
+    buildBatches();
+    uploadBuffers();
+
+    Shader* shader = nullptr;
+    Material* material = nullptr;
+    unsigned int vertexArray = 0;
+    Uniform modelUniform;
+    Uniform normalMatrixUniform;
+    bool instanceAttributesSet = false;
+    for (const Batch& batch : m_batches) {
+        const Command& command = m_commands[m_sorted[batch.first].command];
+        Shader* batchShader = command.instancedShader ? command.instancedShader : command.shader;
+
+        if (batchShader != shader) {
+            shader = batchShader;
+            shader->use();
+            if (!shader->hasUniformBlock(UniformBlock::Frame)) {
+                shader->setMat4("view", view);
+                shader->setMat4("projection", projection);
+            }
+            // Resolved once per program switch rather than per draw
+            if (!shader->hasUniformBlock(UniformBlock::Object) && !command.instancedShader) {
+                modelUniform = shader->getUniform("model");
+                normalMatrixUniform = shader->getUniform("normalMatrix");
+            }
+            // Material uniforms belong to the previous program
+            material = nullptr;
+            m_stats.shaderBinds++;
+        }
+        if (command.material && command.material != material) {
+            material = command.material;
+            material->apply(*shader);
+            m_stats.materialBinds++;
+        }
+        if (command.mesh->getVertexArray() != vertexArray) {
+            vertexArray = command.mesh->getVertexArray();
+            command.mesh->bind();
+            instanceAttributesSet = false;
+            m_stats.vertexArrayBinds++;
+        }
+
+        if (batch.commandCount == 0) {
+            if (shader->hasUniformBlock(UniformBlock::Object)) {
+                m_objectUniforms.bindRange(UniformBlock::Object, batch.objectOffset, sizeof(ObjectUniforms));
+            } else {
+                shader->setMat4(modelUniform, *command.worldMatrix);
+                shader->setMat3(normalMatrixUniform, *command.normalMatrix);
+            }
+            command.mesh->draw();
+            m_stats.draws++;
+        } else if (m_multiDrawIndirect) {
+            // Base instances select each command's instance data, so the
+            // attributes point at the start of the buffer once
+            if (!instanceAttributesSet) {
+                setInstanceAttributes(m_instanceBuffer, 0, sizeof(ObjectUniforms), offsetof(ObjectUniforms, normalMatrix));
+                instanceAttributesSet = true;
+            }
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                                        reinterpret_cast<void*>(batch.firstCommand * sizeof(DrawElementsIndirectCommand)),
+                                        static_cast<GLsizei>(batch.commandCount), 0);
+            m_stats.draws++;
+        } else {
+            // GL 4.1 has no base instance: re-point the attributes per command
+            for (std::uint32_t i = 0; i < batch.commandCount; i++) {
+                const DrawElementsIndirectCommand& draw = m_indirect[batch.firstCommand + i];
+                setInstanceAttributes(m_instanceBuffer, draw.baseInstance * sizeof(ObjectUniforms), sizeof(ObjectUniforms),
+                                      offsetof(ObjectUniforms, normalMatrix));
+                glDrawElementsInstancedBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(draw.count), GL_UNSIGNED_INT,
+                                                  reinterpret_cast<void*>(draw.firstIndex * sizeof(unsigned int)),
+                                                  static_cast<GLsizei>(draw.instanceCount), draw.baseVertex);
+            }
+            m_stats.draws += batch.commandCount;
+        }
+        m_stats.instances += batch.count;
+        m_stats.indirectCommands += batch.commandCount;
+    }
+
+    if (vertexArray != 0) {
+        glBindVertexArray(0);
+    }
+    m_objectUniforms.endFrame();
+}
+
+} // namespace rendering
+} // namespace engine
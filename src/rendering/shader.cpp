@@ -2,9 +2,14 @@
 #include <GL/glew.h>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
+#include <vector>
 #include <iostream>
 #include <glm/gtc/type_ptr.hpp>
 #include "rendering/debug/gl_debug.h"
+#include "ecs/math/Matrix4x4.h"
+#include "ecs/math/Affine3x4.h"
+#include "ecs/math/Matrix3x3.h"
 
 namespace engine {
 namespace rendering {
@@ -81,6 +86,10 @@ bool Shader::loadFromSource(const std::string& vertexSource, const std::string&
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
     
+    if (success) {
+        reflectUniforms();
+        bindUniformBlocks();
+    }
     return success;
 }
 
@@ -122,77 +131,144 @@ bool Shader::linkProgram(unsigned int vertexShader, unsigned int fragmentShader)
     return true;
 }
 
+void Shader::bindUniformBlocks() {
+    static const char* const blockNames[UNIFORM_BLOCK_COUNT] = {"FrameData", "MaterialData", "ObjectData"};
+    
+    m_uniformBlocks = 0;
+    for (unsigned int block = 0; block < UNIFORM_BLOCK_COUNT; block++) {
+        GLuint index = glGetUniformBlockIndex(m_programID, blockNames[block]);
+        if (index != GL_INVALID_INDEX) {
+            glUniformBlockBinding(m_programID, index, block);
+            m_uniformBlocks |= 1u << block;
+        }
+    }
+    
+    // Sampler units never change, so set them once instead of per material
+    if (hasUniformBlock(UniformBlock::Material)) {
+        static const struct {
+            const char* name;
+            int unit;
+        } samplers[] = {
+            {"diffuseMap", DIFFUSE_TEXTURE_UNIT},
+            {"specularMap", SPECULAR_TEXTURE_UNIT},
+            {"normalMap", NORMAL_TEXTURE_UNIT},
+        };
+        glUseProgram(m_programID);
+        for (const auto& sampler : samplers) {
+            auto it = m_uniformLocationCache.find(sampler.name);
+            if (it != m_uniformLocationCache.end()) {
+                glUniform1i(it->second, sampler.unit);
+            }
+        }
+        glUseProgram(0);
+    }
+}
+
+void Shader::reflectUniforms() {
+    m_uniformLocationCache.clear();
+    
+    GLint count = 0;
+    GLint maxLength = 0;
+    glGetProgramiv(m_programID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(m_programID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    
+    std::vector<char> name(static_cast<std::size_t>(std::max(maxLength, 1)));
+    for (GLint i = 0; i < count; i++) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(m_programID, static_cast<GLuint>(i), static_cast<GLsizei>(name.size()), &length, &size,
+                           &type, name.data());
+        std::string uniformName(name.data(), static_cast<std::size_t>(length));
+        
+        // Members of uniform blocks have no location
+        GLint location = glGetUniformLocation(m_programID, uniformName.c_str());
+        if (location == -1) {
+            continue;
+        }
+        m_uniformLocationCache[uniformName] = location;
+        
+        // Arrays are reported as "name[0]"; also accept the bare name
+        std::size_t bracket = uniformName.find('[');
+        if (bracket != std::string::npos) {
+            m_uniformLocationCache.emplace(uniformName.substr(0, bracket), location);
+        }
+    }
+}
+
 void Shader::use() {
     glUseProgram(m_programID);
-    std::cout << "Binding shader program ID: " << m_programID << std::endl;
 }
 
-int Shader::getUniformLocation(const std::string& name) {
-    // Check if we've already retrieved this location
+Uniform Shader::getUniform(const std::string& name) {
     auto it = m_uniformLocationCache.find(name);
     if (it != m_uniformLocationCache.end()) {
-        return it->second;
-    }
-    
-    // Get the location and cache it
-    int location = glGetUniformLocation(m_programID, name.c_str());
-    m_uniformLocationCache[name] = location;
-    
-    if (location == -1) {
-        std::cerr << "WARNING: Uniform '" << name << "' doesn't exist or isn't used" << std::endl;
+        return Uniform(it->second);
     }
     
-    return location;
+    // Not an active uniform; remember it so the warning appears once
+    m_uniformLocationCache.emplace(name, -1);
+    std::cerr << "WARNING: Uniform '" << name << "' doesn't exist or isn't used" << std::endl;
+    return Uniform();
 }
 
-void Shader::setFloat(const std::string& name, float value) {
-    glUniform1f(getUniformLocation(name), value);
+void Shader::setFloat(Uniform uniform, float value) {
+    glUniform1f(uniform.getLocation(), value);
 }
 
-void Shader::setInt(const std::string& name, int value) {
-    glUniform1i(getUniformLocation(name), value);
+void Shader::setInt(Uniform uniform, int value) {
+    glUniform1i(uniform.getLocation(), value);
 }
 
-void Shader::setBool(const std::string& name, bool value) {
-    glUniform1i(getUniformLocation(name), static_cast<int>(value));
+void Shader::setBool(Uniform uniform, bool value) {
+    glUniform1i(uniform.getLocation(), static_cast<int>(value));
 }
 
-void Shader::setVec2(const std::string& name, const glm::vec2& value) {
-    glUniform2fv(getUniformLocation(name), 1, glm::value_ptr(value));
+void Shader::setVec2(Uniform uniform, const glm::vec2& value) {
+    glUniform2fv(uniform.getLocation(), 1, glm::value_ptr(value));
 }
 
-void Shader::setVec3(const std::string& name, const glm::vec3& value) {
-    glUniform3fv(getUniformLocation(name), 1, glm::value_ptr(value));
+void Shader::setVec3(Uniform uniform, const glm::vec3& value) {
+    glUniform3fv(uniform.getLocation(), 1, glm::value_ptr(value));
 }
 
-void Shader::setVec4(const std::string& name, const glm::vec4& value) {
-    glUniform4fv(getUniformLocation(name), 1, glm::value_ptr(value));
+void Shader::setVec4(Uniform uniform, const glm::vec4& value) {
+    glUniform4fv(uniform.getLocation(), 1, glm::value_ptr(value));
 }
 
-void Shader::setMat2(const std::string& name, const glm::mat2& value) {
-    glUniformMatrix2fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(value));
+void Shader::setMat2(Uniform uniform, const glm::mat2& value) {
+    glUniformMatrix2fv(uniform.getLocation(), 1, GL_FALSE, glm::value_ptr(value));
 }
 
-void Shader::setMat3(const std::string& name, const glm::mat3& value) {
-    glUniformMatrix3fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(value));
+void Shader::setMat3(Uniform uniform, const glm::mat3& value) {
+    glUniformMatrix3fv(uniform.getLocation(), 1, GL_FALSE, glm::value_ptr(value));
 }
 
-void Shader::setMat4(const std::string& name, const glm::mat4& value) {
-    unsigned int location = glGetUniformLocation(m_programID, name.c_str());
-    glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
-    
-    std::cout << "Set uniform '" << name << "' at location " << location << std::endl;
-    
-    // Print full matrix representation
-    std::cout << "  Matrix values: [" << std::endl;
-    for (int row = 0; row < 4; row++) {
-        std::cout << "    ";
-        for (int col = 0; col < 4; col++) {
-            std::cout << value[col][row] << " ";
-        }
-        std::cout << std::endl;
-    }
-    std::cout << "  ]" << std::endl;
+void Shader::setMat4(Uniform uniform, const glm::mat4& value) {
+    glUniformMatrix4fv(uniform.getLocation(), 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void Shader::setMat4(Uniform uniform, const Engine::Math::Matrix4x4& value) {
+    // toGLM() transposes, so uploading the raw data with transpose = GL_TRUE
+    // gives the shader identical values
+    glUniformMatrix4fv(uniform.getLocation(), 1, GL_TRUE, value.data.data());
+}
+
+void Shader::setMat4(Uniform uniform, const Engine::Math::Affine3x4& value) {
+    // Rows of the engine matrix are uploaded as GL columns, matching the
+    // transposed Matrix4x4 upload above. The affine rows followed by the
+    // implicit bottom row are exactly that layout.
+    float expanded[16];
+    std::copy(value.data.begin(), value.data.end(), expanded);
+    expanded[12] = 0.0f;
+    expanded[13] = 0.0f;
+    expanded[14] = 0.0f;
+    expanded[15] = 1.0f;
+    glUniformMatrix4fv(uniform.getLocation(), 1, GL_FALSE, expanded);
+}
+
+void Shader::setMat3(Uniform uniform, const Engine::Math::Matrix3x3& value) {
+    glUniformMatrix3fv(uniform.getLocation(), 1, GL_TRUE, value.data.data());
 }
 
 void Shader::logShaderError(unsigned int shader) {
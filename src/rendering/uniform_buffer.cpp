@@ -0,0 +1,159 @@
+#include "rendering/uniform_buffer.h"
+#include "ecs/math/Matrix4x4.h"
+#include "ecs/math/Affine3x4.h"
+#include "ecs/math/Matrix3x3.h"
+#include <GL/glew.h>
+#include <algorithm>
+#include <cstring>
+
+namespace engine {
+namespace rendering {
+
+namespace {
+
+std::size_t alignUp(std::size_t value, std::size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+void storeMatrix(const Engine::Math::Matrix4x4& matrix, float (&out)[16]) {
+    // Shader::setMat4 uploads the storage with transpose = GL_TRUE
+    for (int row = 0; row < 4; row++) {
+        for (int col = 0; col < 4; col++) {
+            out[col * 4 + row] = matrix.data[row * 4 + col];
+        }
+    }
+}
+
+void storeMatrix(const Engine::Math::Affine3x4& matrix, float (&out)[16]) {
+    // Rows become columns, as in Shader::setMat4(Affine3x4)
+    std::copy(matrix.data.begin(), matrix.data.end(), out);
+    out[12] = 0.0f;
+    out[13] = 0.0f;
+    out[14] = 0.0f;
+    out[15] = 1.0f;
+}
+
+void storeNormalMatrix(const Engine::Math::Matrix3x3& matrix, float (&out)[12]) {
+    // Shader::setMat3 uploads with transpose = GL_TRUE: rows become columns
+    for (int row = 0; row < 3; row++) {
+        for (int col = 0; col < 3; col++) {
+            out[row * 4 + col] = matrix(row, col);
+        }
+        out[row * 4 + 3] = 0.0f;
+    }
+}
+
+UniformBuffer::~UniformBuffer() {
+    if (m_buffer != 0) {
+        glDeleteBuffers(1, &m_buffer);
+    }
+}
+
+void UniformBuffer::setData(const void* data, std::size_t size) {
+    if (m_buffer == 0) {
+        glGenBuffers(1, &m_buffer);
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    if (size > m_size) {
+        glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(size), data, GL_DYNAMIC_DRAW);
+        m_size = size;
+    } else {
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, static_cast<GLsizeiptr>(size), data);
+    }
+}
+
+void UniformBuffer::bind(UniformBlock block) const {
+    glBindBufferBase(GL_UNIFORM_BUFFER, static_cast<GLuint>(block), m_buffer);
+}
+
+UniformRingBuffer::UniformRingBuffer(std::size_t segmentSize) : m_segmentSize(segmentSize) {
+}
+
+UniformRingBuffer::~UniformRingBuffer() {
+    for (void*& fence : m_fences) {
+        if (fence) {
+            glDeleteSync(static_cast<GLsync>(fence));
+        }
+    }
+    if (m_buffer != 0) {
+        glDeleteBuffers(1, &m_buffer);
+    }
+}
+
+void UniformRingBuffer::create() {
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    m_alignment = std::max<std::size_t>(static_cast<std::size_t>(alignment), 16);
+    m_segmentSize = alignUp(m_segmentSize, m_alignment);
+
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(m_segmentSize * FRAME_COUNT), nullptr, GL_DYNAMIC_DRAW);
+}
+
+void UniformRingBuffer::beginFrame() {
+    if (m_buffer == 0) {
+        create();
+    }
+    m_segment = (m_segment + 1) % FRAME_COUNT;
+    m_staging.clear();
+
+    // Wait until the GPU is done with the frame that last used the segment
+    if (void* fence = m_fences[m_segment]) {
+        glClientWaitSync(static_cast<GLsync>(fence), GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        glDeleteSync(static_cast<GLsync>(fence));
+        m_fences[m_segment] = nullptr;
+    }
+}
+
+std::size_t UniformRingBuffer::write(const void* data, std::size_t size) {
+    std::size_t offset = alignUp(m_staging.size(), m_alignment);
+    m_staging.resize(offset + size);
+    std::memcpy(m_staging.data() + offset, data, size);
+    return offset;
+}
+
+void UniformRingBuffer::flush() {
+    if (m_staging.empty()) {
+        return;
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+
+    if (m_staging.size() > m_segmentSize) {
+        // Fresh, larger storage; draws still using the old one keep it alive
+        m_segmentSize = alignUp(m_staging.size() + m_staging.size() / 2, m_alignment);
+        glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(m_segmentSize * FRAME_COUNT), nullptr,
+                     GL_DYNAMIC_DRAW);
+        for (void*& fence : m_fences) {
+            if (fence) {
+                glDeleteSync(static_cast<GLsync>(fence));
+                fence = nullptr;
+            }
+        }
+    }
+
+    // The fence wait in beginFrame() makes the segment safe to overwrite
+    void* mapped = glMapBufferRange(GL_UNIFORM_BUFFER, static_cast<GLintptr>(m_segment * m_segmentSize),
+                                    static_cast<GLsizeiptr>(m_staging.size()),
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if (mapped) {
+        std::memcpy(mapped, m_staging.data(), m_staging.size());
+        glUnmapBuffer(GL_UNIFORM_BUFFER);
+    }
+}
+
+void UniformRingBuffer::endFrame() {
+    if (m_buffer != 0 && !m_staging.empty()) {
+        m_fences[m_segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+}
+
+void UniformRingBuffer::bindRange(UniformBlock block, std::size_t offset, std::size_t size) const {
+    glBindBufferRange(GL_UNIFORM_BUFFER, static_cast<GLuint>(block), m_buffer,
+                      static_cast<GLintptr>(m_segment * m_segmentSize + offset), static_cast<GLsizeiptr>(size));
+}
+
+} // namespace rendering
+} // namespace engine
@@ -0,0 +1,69 @@
+#include "core/memory/allocation_counter.h"
+#include "core/memory/frame_allocator.h"
+#include "ecs/ECSManager.h"
+#include "ecs/components/TransformComponent.h"
+#include "ecs/components/BroadphaseComponent.h"
+#include "ecs/systems/TransformSystem.h"
+#include "ecs/systems/BroadphaseSystem.h"
+#include <catch2/catch_test_macros.hpp>
+
+using namespace Engine::ECS;
+using Engine::Math::Vector3;
+
+namespace {
+
+constexpr int ENTITY_COUNT = 2000;
+constexpr int WARMUP_FRAMES = 5;
+constexpr int MEASURED_FRAMES = 30;
+
+// One frame as runGameLoop drives it, minus input and rendering: gameplay
+// moves every root entity back and forth, then the systems run and
+// refresh() ends the frame
+void runFrame(ECSManager& manager, int frame) {
+    float step = frame % 2 == 0 ? 0.25f : -0.25f;
+    manager.view<TransformComponent>().each([step](TransformComponent& transform) {
+        if (transform.getOwner()->getParent() == nullptr) {
+            transform.setPosition(transform.position + Vector3(step, 0.0f, 0.0f));
+        }
+    });
+    manager.update(1.0f / 60.0f);
+    manager.refresh();
+}
+
+} // namespace
+
+TEST_CASE("Steady-state frames make no heap allocations", "[core][memory]") {
+    // Built into engine_allocation_tests with the counter compiled in
+    REQUIRE(engine::core::AllocationCounter::isEnabled());
+
+    ECSManager manager(ENTITY_COUNT);
+    manager.registerSystem<TransformSystem>();
+    auto* broadphase = manager.registerSystem<BroadphaseSystem>();
+
+    // Roots with a child each, all in the broadphase
+    for (int i = 0; i < ENTITY_COUNT; i += 2) {
+        Entity* root = manager.createEntity();
+        root->addComponent<TransformComponent>(Vector3(float(i % 50), 0.0f, float(i / 50)));
+        root->addComponent<BroadphaseComponent>(0.5f);
+
+        Entity* child = manager.createEntity();
+        child->addComponent<TransformComponent>(Vector3(0.0f, 1.0f, 0.0f));
+        child->addComponent<BroadphaseComponent>(0.25f);
+        child->setParent(root);
+    }
+
+    // Caches, pools and the frame allocator's buffers fill up first
+    for (int frame = 0; frame < WARMUP_FRAMES; frame++) {
+        runFrame(manager, frame);
+    }
+    REQUIRE_FALSE(broadphase->getPairs().empty());
+
+    for (int frame = WARMUP_FRAMES; frame < WARMUP_FRAMES + MEASURED_FRAMES; frame++) {
+        runFrame(manager, frame);
+        CAPTURE(frame);
+        REQUIRE(manager.getLastFrameAllocations() == 0);
+    }
+
+    // refresh() also reset the frame allocator
+    REQUIRE(engine::core::FrameAllocator::getInstance().getUsed() == 0);
+}
@@ -0,0 +1,225 @@
+#include "ecs/ECSManager.h"
+#include "ecs/Archetype.h"
+#include "ecs/components/TransformComponent.h"
+#include "ecs/components/BroadphaseComponent.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+using namespace Engine::ECS;
+using Engine::Math::Vector3;
+
+namespace {
+
+// Counts live instances, so leaks and double destruction show up
+struct Tracked {
+    static int live;
+    int value;
+
+    explicit Tracked(int value) : value(value) { live++; }
+    Tracked(Tracked&& other) noexcept : value(other.value) { live++; other.value = -1; }
+    ~Tracked() { live--; }
+};
+int Tracked::live = 0;
+
+struct Payload {
+    float data[15] = {};
+};
+
+struct Oversized {
+    unsigned char data[20000];
+};
+
+constexpr ComponentID TRACKED_ID = 0;
+constexpr ComponentID PAYLOAD_ID = 1;
+
+std::unique_ptr<Archetype> makeArchetype(bool withPayload) {
+    ComponentMask mask;
+    std::vector<std::pair<ComponentID, const ComponentTypeInfo*>> types;
+    mask.set(TRACKED_ID);
+    types.emplace_back(TRACKED_ID, &getComponentTypeInfo<Tracked>());
+    if (withPayload) {
+        mask.set(PAYLOAD_ID);
+        types.emplace_back(PAYLOAD_ID, &getComponentTypeInfo<Payload>());
+    }
+    return std::make_unique<Archetype>(mask, types);
+}
+
+std::size_t addRow(Archetype& archetype, Entity* entity, int value) {
+    std::size_t row = archetype.allocateRow(entity);
+    new (archetype.getComponent(TRACKED_ID, row)) Tracked(value);
+    if (archetype.hasColumn(PAYLOAD_ID)) {
+        new (archetype.getComponent(PAYLOAD_ID, row)) Payload();
+    }
+    return row;
+}
+
+int valueAt(const Archetype& archetype, std::size_t row) {
+    return static_cast<Tracked*>(archetype.getComponent(TRACKED_ID, row))->value;
+}
+
+} // namespace
+
+TEST_CASE("Archetype rows move between archetypes and fill holes from the end", "[ecs][archetype]") {
+    std::vector<Entity> entities;
+    for (EntityID id = 0; id < 4; id++) {
+        entities.emplace_back(id, nullptr);
+    }
+
+    {
+        auto source = makeArchetype(true);
+        auto destination = makeArchetype(false);
+        for (int i = 0; i < 3; i++) {
+            addRow(*source, &entities[i], i);
+        }
+        REQUIRE(Tracked::live == 3);
+
+        // Move row 0 out; the last row takes its place
+        std::size_t destinationRow = destination->allocateRow(&entities[0]);
+        source->moveRowTo(0, *destination, destinationRow);
+        REQUIRE(source->removeRow(0) == &entities[2]);
+
+        REQUIRE(source->size() == 2);
+        REQUIRE(destination->size() == 1);
+        REQUIRE(source->getEntity(0) == &entities[2]);
+        REQUIRE(valueAt(*source, 0) == 2);
+        REQUIRE(valueAt(*source, 1) == 1);
+        REQUIRE(valueAt(*destination, destinationRow) == 0);
+        REQUIRE(Tracked::live == 3);
+
+        // Removing the last row moves nothing
+        source->destroyRow(1);
+        REQUIRE(source->removeRow(1) == nullptr);
+        REQUIRE(source->size() == 1);
+        REQUIRE(Tracked::live == 2);
+    }
+
+    // Archetypes destroy the rows they still hold
+    REQUIRE(Tracked::live == 0);
+}
+
+TEST_CASE("Archetype chunks fit in 16 KiB and split rows at the boundary", "[ecs][archetype]") {
+    auto archetype = makeArchetype(true);
+    std::size_t capacity = archetype->getChunkCapacity();
+    std::size_t rowBytes = sizeof(Entity*) + sizeof(Tracked) + sizeof(Payload);
+    REQUIRE(capacity == Archetype::CHUNK_SIZE / rowBytes);
+
+    std::vector<Entity> entities;
+    entities.reserve(2 * capacity + 1);
+    for (std::size_t i = 0; i < 2 * capacity + 1; i++) {
+        entities.emplace_back(static_cast<EntityID>(i), nullptr);
+        addRow(*archetype, &entities.back(), static_cast<int>(i));
+    }
+    REQUIRE(archetype->getChunkCount() == 3);
+    REQUIRE(archetype->getChunkSize(0) == capacity);
+    REQUIRE(archetype->getChunkSize(2) == 1);
+
+    // Every column of a chunk ends inside its 16 KiB
+    auto* chunkStart = reinterpret_cast<unsigned char*>(archetype->getEntities(0));
+    auto* payloadEnd = reinterpret_cast<unsigned char*>(archetype->getColumn<Payload>(0, PAYLOAD_ID) + capacity);
+    auto* trackedEnd = reinterpret_cast<unsigned char*>(archetype->getColumn<Tracked>(0, TRACKED_ID) + capacity);
+    REQUIRE(payloadEnd <= chunkStart + Archetype::CHUNK_SIZE);
+    REQUIRE(trackedEnd <= chunkStart + Archetype::CHUNK_SIZE);
+
+    // Row `capacity` is the first row of the second chunk
+    REQUIRE(archetype->getComponent(TRACKED_ID, capacity) == archetype->getColumn<Tracked>(1, TRACKED_ID));
+    REQUIRE(archetype->getEntity(capacity) == &entities[capacity]);
+    REQUIRE(valueAt(*archetype, capacity) == static_cast<int>(capacity));
+
+    // Filling a hole in the first chunk from the last one
+    archetype->destroyRow(0);
+    REQUIRE(archetype->removeRow(0) == &entities[2 * capacity]);
+    REQUIRE(valueAt(*archetype, 0) == static_cast<int>(2 * capacity));
+    REQUIRE(archetype->getChunkSize(2) == 0);
+
+    // Emptying keeps one spare chunk
+    while (!archetype->empty()) {
+        std::size_t last = archetype->size() - 1;
+        archetype->destroyRow(last);
+        archetype->removeRow(last);
+    }
+    REQUIRE(archetype->getChunkCount() == 1);
+    REQUIRE(Tracked::live == 0);
+
+    // Rows larger than a chunk get one row per chunk
+    ComponentMask mask;
+    mask.set(0);
+    Archetype large(mask, {{0, &getComponentTypeInfo<Oversized>()}});
+    REQUIRE(large.getChunkCapacity() == 1);
+}
+
+TEST_CASE("getComponent follows entities through archetype moves", "[ecs][archetype]") {
+    ECSManager manager(16);
+    std::vector<Entity*> entities;
+    for (int i = 0; i < 3; i++) {
+        Entity* entity = manager.createEntity();
+        entity->addComponent<TransformComponent>(Vector3(float(i), 0.0f, 0.0f));
+        entities.push_back(entity);
+    }
+    Archetype* transforms = entities[0]->getArchetype();
+    REQUIRE(transforms->size() == 3);
+
+    // Entity 0 moves out and entity 2 fills its row
+    entities[0]->addComponent<BroadphaseComponent>(4.0f);
+    REQUIRE(entities[0]->getArchetype() != transforms);
+    REQUIRE(entities[2]->getArchetype() == transforms);
+    REQUIRE(entities[2]->getArchetypeRow() == 0);
+    REQUIRE(transforms->getEntity(0) == entities[2]);
+
+    for (int i = 0; i < 3; i++) {
+        REQUIRE(entities[i]->getComponent<TransformComponent>().position.x == float(i));
+        REQUIRE(entities[i]->getComponent<TransformComponent>().getOwner() == entities[i]);
+    }
+    REQUIRE(entities[0]->getComponent<BroadphaseComponent>().getRadius() == 4.0f);
+
+    // Removing the component the entity started with keeps the other
+    entities[0]->removeComponent<TransformComponent>();
+    REQUIRE_FALSE(entities[0]->hasComponent<TransformComponent>());
+    REQUIRE_THROWS(entities[0]->getComponent<TransformComponent>());
+    REQUIRE(entities[0]->getComponent<BroadphaseComponent>().getRadius() == 4.0f);
+
+    // And back: the entity returns to the Transform-only archetype
+    entities[0]->removeComponent<BroadphaseComponent>();
+    entities[0]->addComponent<TransformComponent>(Vector3(7.0f, 0.0f, 0.0f));
+    REQUIRE(entities[0]->getArchetype() == transforms);
+    REQUIRE(entities[0]->getComponent<TransformComponent>().position.x == 7.0f);
+    REQUIRE(entities[1]->getComponent<TransformComponent>().position.x == 1.0f);
+    REQUIRE(entities[2]->getComponent<TransformComponent>().position.x == 2.0f);
+}
+
+TEST_CASE("Component values survive moves across chunk boundaries", "[ecs][archetype]") {
+    ECSManager manager(4096);
+    Entity* first = manager.createEntity();
+    first->addComponent<TransformComponent>(Vector3(0.0f, 0.0f, 0.0f));
+    std::size_t count = 2 * first->getArchetype()->getChunkCapacity() + 5;
+
+    std::vector<Entity*> entities = {first};
+    for (std::size_t i = 1; i < count; i++) {
+        Entity* entity = manager.createEntity();
+        entity->addComponent<TransformComponent>(Vector3(float(i), 0.0f, 0.0f));
+        entities.push_back(entity);
+    }
+
+    // Every third entity moves out and back, reordering the rows of both
+    // archetypes through swap-removes
+    for (std::size_t i = 0; i < count; i += 3) {
+        entities[i]->addComponent<BroadphaseComponent>(float(i));
+    }
+    for (std::size_t i = 0; i < count; i += 6) {
+        entities[i]->removeComponent<BroadphaseComponent>();
+    }
+
+    for (std::size_t i = 0; i < count; i++) {
+        CAPTURE(i);
+        Entity* entity = entities[i];
+        REQUIRE(entity->getArchetype()->getEntity(entity->getArchetypeRow()) == entity);
+        REQUIRE(entity->getComponent<TransformComponent>().position.x == float(i));
+        bool hasBroadphase = i % 3 == 0 && i % 6 != 0;
+        REQUIRE(entity->hasComponent<BroadphaseComponent>() == hasBroadphase);
+        if (hasBroadphase) {
+            REQUIRE(entity->getComponent<BroadphaseComponent>().getRadius() == float(i));
+        }
+    }
+}
@@ -0,0 +1,215 @@
+#include "ecs/ECSManager.h"
+#include "ecs/CommandBuffer.h"
+#include "ecs/components/TransformComponent.h"
+#include "ecs/components/BroadphaseComponent.h"
+#include "ecs/components/CameraComponent.h"
+#include "ecs/components/MeshRendererComponent.h"
+#include "core/job_system.h"
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <vector>
+
+using namespace Engine::ECS;
+using Engine::Math::Vector3;
+using engine::rendering::Material;
+
+namespace {
+
+class BroadphaseMembers : public System {
+public:
+    BroadphaseMembers() {
+        setComponentMask<const TransformComponent, const BroadphaseComponent>();
+    }
+
+    void init() override {}
+};
+
+// A Material handle sharing `token`'s reference count, so the number of
+// live MeshRendererComponent copies shows in token.use_count() without
+// creating any GL resources
+std::shared_ptr<Material> trackedMaterial(const std::shared_ptr<int>& token) {
+    return std::shared_ptr<Material>(token, nullptr);
+}
+
+MeshRendererComponent rendererWith(const std::shared_ptr<int>& token) {
+    MeshRendererComponent renderer;
+    renderer.setMaterial(trackedMaterial(token));
+    return renderer;
+}
+
+} // namespace
+
+TEST_CASE("Commands on a placeholder handle apply to the entity created for it", "[ecs][commands]") {
+    ECSManager manager(16);
+    auto* members = manager.registerSystem<BroadphaseMembers>();
+    CommandBuffer& commands = manager.getCommandBuffer();
+
+    EntityHandle placeholder = commands.createEntity();
+    REQUIRE(CommandBuffer::isPlaceholder(placeholder));
+    commands.addComponent<TransformComponent>(placeholder, Vector3(1.0f, 2.0f, 3.0f));
+    commands.addComponent<BroadphaseComponent>(placeholder, 2.0f);
+    REQUIRE(manager.getLivingEntityCount() == 0);
+
+    manager.refresh();
+
+    Entity* entity = commands.getCreatedEntity(placeholder);
+    REQUIRE(entity != nullptr);
+    REQUIRE(manager.getLivingEntityCount() == 1);
+    REQUIRE(entity->getComponent<TransformComponent>().position.y == 2.0f);
+    REQUIRE(entity->getComponent<TransformComponent>().getOwner() == entity);
+    REQUIRE(entity->getComponent<BroadphaseComponent>().getRadius() == 2.0f);
+    REQUIRE(entity->getComponent<BroadphaseComponent>().getOwner() == entity);
+
+    REQUIRE(members->getEntities().size() == 1);
+    REQUIRE(members->hasEntity(entity));
+    REQUIRE(commands.empty());
+}
+
+TEST_CASE("An entity's commands fold into one archetype move", "[ecs][commands]") {
+    ECSManager manager(16);
+    auto* members = manager.registerSystem<BroadphaseMembers>();
+    CommandBuffer& commands = manager.getCommandBuffer();
+
+    Entity* entity = manager.createEntity();
+    entity->addComponent<TransformComponent>();
+    Archetype* start = entity->getArchetype();
+    EntityHandle handle = entity->getHandle();
+
+    // Add then remove cancels out: no move and no membership change
+    std::uint64_t version = manager.getStructureVersion();
+    commands.addComponent<BroadphaseComponent>(handle, 1.0f);
+    commands.removeComponent<BroadphaseComponent>(handle);
+    manager.refresh();
+    REQUIRE(entity->getArchetype() == start);
+    REQUIRE(manager.getStructureVersion() == version);
+    REQUIRE_FALSE(entity->hasComponent<BroadphaseComponent>());
+    REQUIRE(members->getEntities().empty());
+
+    // Two adds and a replacement are a single move
+    commands.addComponent<BroadphaseComponent>(handle, 1.0f);
+    commands.addComponent<CameraComponent>(handle);
+    commands.addComponent<BroadphaseComponent>(handle, 5.0f);
+    manager.refresh();
+    REQUIRE(manager.getStructureVersion() == version + 1);
+    REQUIRE(entity->getComponent<BroadphaseComponent>().getRadius() == 5.0f);
+    REQUIRE(entity->hasComponent<CameraComponent>());
+    REQUIRE(members->getEntities().size() == 1);
+    REQUIRE(members->hasEntity(entity));
+
+    // Removing what was just added and adding it back is no move either
+    commands.removeComponent<CameraComponent>(handle);
+    commands.addComponent<CameraComponent>(handle);
+    manager.refresh();
+    REQUIRE(manager.getStructureVersion() == version + 1);
+    REQUIRE(members->getEntities().size() == 1);
+}
+
+TEST_CASE("Component payloads are moved in or destroyed exactly once", "[ecs][commands]") {
+    ECSManager manager(16);
+    CommandBuffer& commands = manager.getCommandBuffer();
+    auto first = std::make_shared<int>(1);
+    auto second = std::make_shared<int>(2);
+
+    Entity* entity = manager.createEntity();
+    EntityHandle handle = entity->getHandle();
+
+    // Moved into the entity: only the stored component holds a reference
+    commands.addComponent<MeshRendererComponent>(handle, rendererWith(first));
+    REQUIRE(first.use_count() == 2);
+    manager.refresh();
+    REQUIRE(first.use_count() == 2);
+    REQUIRE(entity->getComponent<MeshRendererComponent>().getMaterial() == trackedMaterial(first));
+
+    // Replacing destroys the old component
+    commands.addComponent<MeshRendererComponent>(handle, rendererWith(second));
+    manager.refresh();
+    REQUIRE(first.use_count() == 1);
+    REQUIRE(second.use_count() == 2);
+
+    // A later add of the same component wins; the earlier payload is dropped
+    auto third = std::make_shared<int>(3);
+    commands.addComponent<MeshRendererComponent>(handle, rendererWith(first));
+    commands.addComponent<MeshRendererComponent>(handle, rendererWith(third));
+    REQUIRE(first.use_count() == 2);
+    manager.refresh();
+    REQUIRE(first.use_count() == 1);
+    REQUIRE(second.use_count() == 1);
+    REQUIRE(third.use_count() == 2);
+
+    // Cleared commands and commands left at destruction release their payloads
+    commands.addComponent<MeshRendererComponent>(handle, rendererWith(first));
+    commands.clear();
+    REQUIRE(first.use_count() == 1);
+    {
+        CommandBuffer local(&manager);
+        local.addComponent<MeshRendererComponent>(handle, rendererWith(first));
+        REQUIRE(first.use_count() == 2);
+    }
+    REQUIRE(first.use_count() == 1);
+
+    // Destroying the entity destroys its component at refresh()
+    entity->destroy();
+    manager.refresh();
+    REQUIRE(third.use_count() == 1);
+}
+
+TEST_CASE("A destroy after an add drops the payload with the entity", "[ecs][commands]") {
+    ECSManager manager(16);
+    auto* members = manager.registerSystem<BroadphaseMembers>();
+    CommandBuffer& commands = manager.getCommandBuffer();
+    auto token = std::make_shared<int>(0);
+
+    EntityHandle placeholder = commands.createEntity();
+    commands.addComponent<TransformComponent>(placeholder);
+    commands.addComponent<BroadphaseComponent>(placeholder);
+    commands.addComponent<MeshRendererComponent>(placeholder, rendererWith(token));
+    commands.destroyEntity(placeholder);
+    manager.refresh();
+
+    REQUIRE(commands.getCreatedEntity(placeholder) == nullptr);
+    REQUIRE(manager.getLivingEntityCount() == 0);
+    REQUIRE(token.use_count() == 1);
+    REQUIRE(members->getEntities().empty());
+
+    // Commands after a destroy in the same buffer are ignored
+    Entity* entity = manager.createEntity();
+    EntityHandle handle = entity->getHandle();
+    commands.destroyEntity(handle);
+    commands.addComponent<MeshRendererComponent>(handle, rendererWith(token));
+    manager.refresh();
+    REQUIRE_FALSE(manager.isValid(handle));
+    REQUIRE(token.use_count() == 1);
+}
+
+TEST_CASE("Entities destroyed from worker threads are removed at refresh", "[ecs][commands]") {
+    constexpr std::size_t COUNT = 1000;
+    ECSManager manager(COUNT);
+    auto* members = manager.registerSystem<BroadphaseMembers>();
+    std::vector<Entity*> entities;
+    for (std::size_t i = 0; i < COUNT; i++) {
+        Entity* entity = manager.createEntity();
+        entity->addComponent<TransformComponent>();
+        entity->addComponent<BroadphaseComponent>();
+        entities.push_back(entity);
+    }
+
+    engine::core::JobSystem jobs(3);
+    jobs.parallelFor(COUNT, 16, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            if (i % 2 == 0) {
+                entities[i]->destroy();
+            }
+        }
+    });
+
+    // Nothing changes until the frame sync point
+    REQUIRE(manager.getLivingEntityCount() == COUNT);
+    REQUIRE(entities[0]->isActive());
+
+    manager.refresh();
+    REQUIRE(manager.getLivingEntityCount() == COUNT / 2);
+    REQUIRE(members->getEntities().size() == COUNT / 2);
+    for (std::size_t i = 1; i < COUNT; i += 2) {
+        REQUIRE(members->hasEntity(entities[i]));
+    }
+}
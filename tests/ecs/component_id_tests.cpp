@@ -0,0 +1,40 @@
+#include "ecs/ECSManager.h"
+#include "ecs/components/TransformComponent.h"
+#include "ecs/components/MeshRendererComponent.h"
+#include "ecs/components/CameraComponent.h"
+#include "ecs/components/CameraControllerComponent.h"
+#include "ecs/components/OrbitCameraController.h"
+#include "ecs/components/BroadphaseComponent.h"
+#include <catch2/catch_test_macros.hpp>
+
+using namespace Engine::ECS;
+
+// Component IDs are the positions in ComponentTypeList: fixed, contiguous
+// and constant expressions. These fail to compile if that changes.
+static_assert(getComponentID<TransformComponent>() == 0, "IDs follow ComponentTypeList");
+static_assert(getComponentID<MeshRendererComponent>() == 1, "IDs follow ComponentTypeList");
+static_assert(getComponentID<CameraComponent>() == 2, "IDs follow ComponentTypeList");
+static_assert(getComponentID<CameraControllerComponent>() == 3, "IDs follow ComponentTypeList");
+static_assert(getComponentID<OrbitCameraController>() == 4, "IDs follow ComponentTypeList");
+static_assert(getComponentID<BroadphaseComponent>() == 5, "IDs follow ComponentTypeList");
+static_assert(COMPONENT_TYPE_COUNT == 6, "A new component type needs its ID checked above");
+
+// Masks from type packs are constants, with const qualifiers ignored
+constexpr ComponentMask CAMERA_MASK = makeComponentMask<const TransformComponent, CameraComponent>();
+static_assert(CAMERA_MASK[0] && CAMERA_MASK[2], "makeComponentMask sets the bit of each type");
+static_assert(!CAMERA_MASK[1] && !CAMERA_MASK[3] && !CAMERA_MASK[4] && !CAMERA_MASK[5],
+              "makeComponentMask sets no other bits");
+constexpr ComponentMask EMPTY_MASK = makeComponentMask<>();
+static_assert(!EMPTY_MASK[0], "An empty pack gives an empty mask");
+
+TEST_CASE("Entity masks use the compile-time component IDs", "[ecs][component]") {
+    ECSManager manager(4);
+    Entity* entity = manager.createEntity();
+    entity->addComponent<TransformComponent>();
+    entity->addComponent<CameraComponent>();
+    REQUIRE(entity->getComponentMask() == CAMERA_MASK);
+    REQUIRE(entity->getArchetype()->getMask() == CAMERA_MASK);
+
+    entity->removeComponent<CameraComponent>();
+    REQUIRE(entity->getComponentMask() == makeComponentMask<TransformComponent>());
+}
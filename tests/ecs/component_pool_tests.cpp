@@ -0,0 +1,152 @@
+#include "ecs/ECSManager.h"
+#include "ecs/ComponentPool.h"
+#include "ecs/components/TransformComponent.h"
+#include "ecs/components/BroadphaseComponent.h"
+#include "ecs/components/CameraComponent.h"
+#include <catch2/catch_test_macros.hpp>
+#include <set>
+#include <vector>
+
+using namespace Engine::ECS;
+using Engine::Math::Vector3;
+
+namespace {
+
+struct Value {
+    int value;
+    explicit Value(int value) : value(value) {}
+};
+
+} // namespace
+
+TEST_CASE("Removing from a pool moves the last component into the hole", "[ecs][pool]") {
+    std::vector<Entity> entities;
+    for (EntityID id = 0; id < 4; id++) {
+        entities.emplace_back(id * 10, nullptr);
+    }
+
+    ComponentPool<Value> pool;
+    for (int i = 0; i < 4; i++) {
+        pool.emplace(&entities[i], i);
+    }
+    REQUIRE(pool.size() == 4);
+    REQUIRE(pool.get(30).value == 3);
+
+    pool.remove(10);
+    REQUIRE(pool.size() == 3);
+    REQUIRE_FALSE(pool.contains(10));
+    REQUIRE(pool.tryGet(10) == nullptr);
+    // Entity 30 filled position 1, in both dense arrays and the sparse index
+    REQUIRE(pool.getEntities()[1] == &entities[3]);
+    REQUIRE(pool.data()[1].value == 3);
+    REQUIRE(pool.get(30).value == 3);
+    REQUIRE(pool.get(0).value == 0);
+    REQUIRE(pool.get(20).value == 2);
+
+    // Removing the last component moves nothing; removing twice is a no-op
+    pool.remove(20);
+    pool.remove(20);
+    REQUIRE(pool.size() == 2);
+    REQUIRE(pool.get(0).value == 0);
+    REQUIRE(pool.get(30).value == 3);
+
+    // Emplacing again replaces in place
+    pool.emplace(&entities[3], 7);
+    REQUIRE(pool.size() == 2);
+    REQUIRE(pool.getEntities()[1] == &entities[3]);
+    REQUIRE(pool.get(30).value == 7);
+
+    pool.clear();
+    REQUIRE(pool.size() == 0);
+    REQUIRE_FALSE(pool.contains(0));
+}
+
+TEST_CASE("Sparse-set components are reached through their pool", "[ecs][pool]") {
+    ECSManager manager(16);
+    manager.registerComponent<BroadphaseComponent>(StoragePolicy::SparseSet);
+    std::vector<Entity*> entities;
+    for (int i = 0; i < 4; i++) {
+        Entity* entity = manager.createEntity();
+        entity->addComponent<TransformComponent>();
+        entities.push_back(entity);
+    }
+    Archetype* archetype = entities[0]->getArchetype();
+
+    for (int i = 0; i < 4; i++) {
+        entities[i]->addComponent<BroadphaseComponent>(float(i + 1));
+    }
+    // Archetypes never hold sparse-set components
+    REQUIRE(entities[0]->getArchetype() == archetype);
+    REQUIRE_FALSE(archetype->getMask()[getComponentID<BroadphaseComponent>()]);
+    REQUIRE(entities[2]->getComponent<BroadphaseComponent>().getRadius() == 3.0f);
+    REQUIRE(entities[2]->getComponent<BroadphaseComponent>().getOwner() == entities[2]);
+
+    // The last component fills the hole and is still found by its entity
+    entities[0]->removeComponent<BroadphaseComponent>();
+    REQUIRE(entities[0]->getArchetype() == archetype);
+    REQUIRE_FALSE(entities[0]->hasComponent<BroadphaseComponent>());
+    REQUIRE_THROWS(entities[0]->getComponent<BroadphaseComponent>());
+    REQUIRE(entities[3]->getComponent<BroadphaseComponent>().getRadius() == 4.0f);
+    REQUIRE(entities[3]->getComponent<BroadphaseComponent>().getOwner() == entities[3]);
+
+    // Replacing keeps the pool the same size
+    entities[1]->addComponent<BroadphaseComponent>(9.0f);
+    REQUIRE(entities[1]->getComponent<BroadphaseComponent>().getRadius() == 9.0f);
+    REQUIRE(manager.view<const BroadphaseComponent>().size() == 3);
+
+    // Destroying an entity removes its pooled component
+    entities[3]->destroy();
+    manager.refresh();
+    REQUIRE(manager.view<const BroadphaseComponent>().size() == 2);
+    REQUIRE(entities[2]->getComponent<BroadphaseComponent>().getRadius() == 3.0f);
+
+    // The policy is fixed once the component is in use
+    REQUIRE_THROWS(manager.registerComponent<BroadphaseComponent>(StoragePolicy::Archetype));
+}
+
+TEST_CASE("Views join sparse-set and archetype components", "[ecs][pool]") {
+    ECSManager manager(64);
+    manager.registerComponent<BroadphaseComponent>(StoragePolicy::SparseSet);
+
+    // Transforms in two archetypes; pooled components on some entities of
+    // each and on one entity without a transform
+    std::vector<Entity*> entities;
+    for (int i = 0; i < 12; i++) {
+        Entity* entity = manager.createEntity();
+        entity->addComponent<TransformComponent>(Vector3(float(i), 0.0f, 0.0f));
+        if (i % 2 == 0) {
+            entity->addComponent<CameraComponent>();
+        }
+        if (i % 3 == 0) {
+            entity->addComponent<BroadphaseComponent>(float(i));
+        }
+        entities.push_back(entity);
+    }
+    Entity* loose = manager.createEntity();
+    loose->addComponent<BroadphaseComponent>(100.0f);
+
+    auto view = manager.view<const TransformComponent, const BroadphaseComponent>();
+    REQUIRE(view.size() == 4);
+
+    std::set<Entity*> visited;
+    view.each([&](Entity* entity, const TransformComponent& transform, const BroadphaseComponent& broadphase) {
+        REQUIRE(transform.getOwner() == entity);
+        REQUIRE(broadphase.getOwner() == entity);
+        REQUIRE(transform.position.x == broadphase.getRadius());
+        visited.insert(entity);
+    });
+    REQUIRE(visited == std::set<Entity*>{entities[0], entities[3], entities[6], entities[9]});
+
+    // Iterators see the same entities
+    std::set<Entity*> iterated;
+    for (auto it = view.begin(); it != view.end(); ++it) {
+        auto [transform, broadphase] = *it;
+        REQUIRE(transform.position.x == broadphase.getRadius());
+        iterated.insert(it.getEntity());
+    }
+    REQUIRE(iterated == visited);
+
+    // Three components, one of them only in some archetypes
+    auto cameras = manager.view<const TransformComponent, const CameraComponent, const BroadphaseComponent>();
+    REQUIRE(cameras.size() == 2);
+}
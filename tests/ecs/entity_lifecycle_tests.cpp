@@ -0,0 +1,106 @@
+#include "ecs/ECSManager.h"
+#include "ecs/components/TransformComponent.h"
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <vector>
+
+using namespace Engine::ECS;
+
+TEST_CASE("Stale handles are rejected after destroy and slot reuse", "[ecs][entity]") {
+    ECSManager manager(16);
+    Entity* entity = manager.createEntity();
+    EntityHandle handle = entity->getHandle();
+    REQUIRE(manager.isValid(handle));
+    REQUIRE(manager.getEntity(handle) == entity);
+
+    // Destruction takes effect at refresh()
+    entity->destroy();
+    REQUIRE(manager.isValid(handle));
+    manager.refresh();
+    REQUIRE_FALSE(manager.isValid(handle));
+    REQUIRE(manager.getEntity(handle) == nullptr);
+
+    // The slot is reused under a new version
+    Entity* reused = manager.createEntity();
+    EntityHandle reusedHandle = reused->getHandle();
+    REQUIRE(reusedHandle.index == handle.index);
+    REQUIRE(reusedHandle.version != handle.version);
+    REQUIRE(manager.isValid(reusedHandle));
+    REQUIRE_FALSE(manager.isValid(handle));
+    REQUIRE(manager.getEntity(handle) == nullptr);
+    REQUIRE(manager.getEntity(reusedHandle) == reused);
+
+    // Destroying through the stale handle leaves the new entity alone
+    manager.destroyEntity(handle);
+    manager.refresh();
+    REQUIRE(manager.isValid(reusedHandle));
+
+    REQUIRE_FALSE(manager.isValid(EntityHandle{1000, 1}));
+}
+
+TEST_CASE("Destroyed entity IDs are recycled instead of growing", "[ecs][entity]") {
+    constexpr std::size_t COUNT = 2000;
+    ECSManager manager(COUNT);
+    std::vector<Entity*> first;
+    for (std::size_t i = 0; i < COUNT; i++) {
+        Entity* entity = manager.createEntity();
+        entity->addComponent<TransformComponent>();
+        first.push_back(entity);
+    }
+
+    for (int round = 0; round < 3; round++) {
+        for (std::size_t i = 0; i < COUNT; i++) {
+            manager.getEntity(static_cast<EntityID>(i))->destroy();
+        }
+        manager.refresh();
+        REQUIRE(manager.getLivingEntityCount() == 0);
+
+        std::vector<EntityID> ids;
+        for (std::size_t i = 0; i < COUNT; i++) {
+            Entity* entity = manager.createEntity();
+            entity->addComponent<TransformComponent>();
+            ids.push_back(entity->getID());
+            // Entities live in stable pages, so a recycled ID is the same slot
+            REQUIRE(entity == first[entity->getID()]);
+        }
+        std::sort(ids.begin(), ids.end());
+        REQUIRE(ids.front() == 0);
+        REQUIRE(ids.back() == COUNT - 1);
+        REQUIRE(std::adjacent_find(ids.begin(), ids.end()) == ids.end());
+        REQUIRE(manager.getLivingEntityCount() == COUNT);
+    }
+}
+
+TEST_CASE("refresh() handles only the entities destroyed since the last call", "[ecs][entity]") {
+    ECSManager manager(16);
+    std::vector<Entity*> entities;
+    for (int i = 0; i < 8; i++) {
+        Entity* entity = manager.createEntity();
+        entity->addComponent<TransformComponent>();
+        entities.push_back(entity);
+    }
+
+    // Nothing pending: nothing changes
+    std::uint64_t version = manager.getStructureVersion();
+    manager.refresh();
+    REQUIRE(manager.getStructureVersion() == version);
+    REQUIRE(manager.getLivingEntityCount() == 8);
+
+    // A repeated destroy is handled once, and only the freed IDs come back
+    entities[5]->destroy();
+    entities[2]->destroy();
+    entities[2]->destroy();
+    manager.refresh();
+    REQUIRE(manager.getLivingEntityCount() == 6);
+    REQUIRE(entities[0]->hasComponent<TransformComponent>());
+    EntityID a = manager.createEntity()->getID();
+    EntityID b = manager.createEntity()->getID();
+    REQUIRE(std::min(a, b) == 2);
+    REQUIRE(std::max(a, b) == 5);
+
+    // Already handled: a second refresh destroys nothing more
+    version = manager.getStructureVersion();
+    manager.refresh();
+    REQUIRE(manager.getStructureVersion() == version);
+    REQUIRE(manager.getLivingEntityCount() == 8);
+}
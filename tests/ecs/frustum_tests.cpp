@@ -0,0 +1,132 @@
+#include "ecs/ECSManager.h"
+#include "ecs/components/TransformComponent.h"
+#include "ecs/components/CameraComponent.h"
+#include "ecs/math/Frustum.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include <cstdint>
+#include <vector>
+
+using namespace Engine::ECS;
+using namespace Engine::Math;
+
+namespace {
+
+// Camera at (0, 0, 10) looking at the origin with a 90 degree field of view,
+// so at the origin (depth 10) the frustum spans -10..10 on x and y
+struct CameraScene {
+    ECSManager manager{4};
+    Entity* entity = nullptr;
+
+    CameraScene() {
+        entity = manager.createEntity();
+        entity->addComponent<TransformComponent>(Vector3(0.0f, 0.0f, 10.0f));
+        entity->addComponent<CameraComponent>().setPerspective(90.0f, 1.0f, 1.0f, 100.0f);
+    }
+
+    const CameraComponent& camera() const { return entity->getComponent<CameraComponent>(); }
+    Frustum frustum() const { return Frustum(camera().getViewProjectionMatrix()); }
+};
+
+// clip = m * (point, 1)
+float clipComponent(const Matrix4x4& m, int row, const Vector3& point) {
+    return m(row, 0) * point.x + m(row, 1) * point.y + m(row, 2) * point.z + m(row, 3);
+}
+
+} // namespace
+
+TEST_CASE("getViewProjectionMatrix maps world space to clip space", "[ecs][culling]") {
+    CameraScene scene;
+    Matrix4x4 viewProjection = scene.camera().getViewProjectionMatrix();
+
+    // w is the depth in front of the camera, and the near and far planes
+    // land on z = -w and z = w
+    Vector3 origin(0.0f, 0.0f, 0.0f);
+    REQUIRE(clipComponent(viewProjection, 3, origin) == Catch::Approx(10.0f).margin(1e-3));
+
+    Vector3 onNear(0.0f, 0.0f, 9.0f);
+    REQUIRE(clipComponent(viewProjection, 2, onNear) == Catch::Approx(-clipComponent(viewProjection, 3, onNear)).margin(1e-3));
+
+    Vector3 onFar(0.0f, 0.0f, -90.0f);
+    REQUIRE(clipComponent(viewProjection, 2, onFar) == Catch::Approx(clipComponent(viewProjection, 3, onFar)).margin(1e-2));
+
+    // The right edge at depth 10 is x = 10
+    Vector3 onRight(10.0f, 0.0f, 0.0f);
+    REQUIRE(clipComponent(viewProjection, 0, onRight) == Catch::Approx(clipComponent(viewProjection, 3, onRight)).margin(1e-2));
+}
+
+TEST_CASE("Frustum planes of a perspective camera", "[ecs][culling]") {
+    Frustum frustum = CameraScene().frustum();
+
+    const Plane& nearPlane = frustum.getPlane(Frustum::Near);
+    REQUIRE(nearPlane.normal.z == Catch::Approx(-1.0f).margin(1e-4));
+    REQUIRE(nearPlane.distanceTo(Vector3(0.0f, 0.0f, 9.0f)) == Catch::Approx(0.0f).margin(1e-3));
+
+    const Plane& farPlane = frustum.getPlane(Frustum::Far);
+    REQUIRE(farPlane.normal.z == Catch::Approx(1.0f).margin(1e-4));
+    REQUIRE(farPlane.distanceTo(Vector3(0.0f, 0.0f, -90.0f)) == Catch::Approx(0.0f).margin(1e-2));
+
+    // Side planes are 45 degrees off the view axis and meet at the camera
+    const Plane& left = frustum.getPlane(Frustum::Left);
+    REQUIRE(left.normal.x == Catch::Approx(0.7071f).margin(1e-3));
+    REQUIRE(left.normal.z == Catch::Approx(-0.7071f).margin(1e-3));
+    REQUIRE(left.distanceTo(Vector3(0.0f, 0.0f, 10.0f)) == Catch::Approx(0.0f).margin(1e-3));
+    REQUIRE(left.distanceTo(Vector3(-10.0f, 0.0f, 0.0f)) == Catch::Approx(0.0f).margin(1e-3));
+
+    const Plane& top = frustum.getPlane(Frustum::Top);
+    REQUIRE(top.normal.y == Catch::Approx(-0.7071f).margin(1e-3));
+    REQUIRE(top.distanceTo(Vector3(0.0f, 10.0f, 0.0f)) == Catch::Approx(0.0f).margin(1e-3));
+
+    for (int i = 0; i < Frustum::PLANE_COUNT; i++) {
+        REQUIRE(frustum.getPlane(i).distanceTo(Vector3(0.0f, 0.0f, 0.0f)) > 0.0f);
+    }
+}
+
+TEST_CASE("Frustum sphere and AABB tests: inside, outside and straddling", "[ecs][culling]") {
+    Frustum frustum = CameraScene().frustum();
+
+    struct Case {
+        Vector3 center;
+        float radius;
+        bool visible;
+    };
+    // Seven spheres, so cullSpheres takes both its four-wide and its scalar path
+    std::vector<Case> cases = {
+        {Vector3(0.0f, 0.0f, 0.0f), 1.0f, true},      // inside
+        {Vector3(0.0f, 0.0f, 20.0f), 1.0f, false},    // behind the camera
+        {Vector3(-10.5f, 0.0f, 0.0f), 1.0f, true},    // straddles the left plane
+        {Vector3(-14.0f, 0.0f, 0.0f), 1.0f, false},   // left of the frustum
+        {Vector3(0.0f, 0.0f, -90.5f), 1.0f, true},    // straddles the far plane
+        {Vector3(0.0f, 0.0f, -95.0f), 1.0f, false},   // beyond the far plane
+        {Vector3(0.0f, 13.0f, 0.0f), 2.5f, true},     // straddles the top plane
+    };
+
+    std::vector<float> x, y, z, radius;
+    for (const Case& c : cases) {
+        x.push_back(c.center.x);
+        y.push_back(c.center.y);
+        z.push_back(c.center.z);
+        radius.push_back(c.radius);
+    }
+
+    std::vector<std::uint8_t> visible(cases.size(), 2);
+    std::size_t visibleCount = frustum.cullSpheres(x.data(), y.data(), z.data(), radius.data(),
+                                                   cases.size(), visible.data());
+    REQUIRE(visibleCount == 4);
+
+    for (std::size_t i = 0; i < cases.size(); i++) {
+        CAPTURE(i);
+        BoundingSphere sphere(cases[i].center, cases[i].radius);
+        REQUIRE(frustum.intersects(sphere) == cases[i].visible);
+        REQUIRE(bool(visible[i]) == cases[i].visible);
+
+        // The box around the sphere agrees for these cases
+        Vector3 extent(cases[i].radius, cases[i].radius, cases[i].radius);
+        REQUIRE(frustum.intersects(AABB(cases[i].center - extent, cases[i].center + extent)) == cases[i].visible);
+    }
+
+    // A box larger than the frustum cross-section straddles every side plane
+    REQUIRE(frustum.intersects(AABB(Vector3(-50.0f, -50.0f, -1.0f), Vector3(50.0f, 50.0f, 1.0f))));
+    // Outside only the right plane, while overlapping the others' half-spaces
+    REQUIRE_FALSE(frustum.intersects(AABB(Vector3(11.5f, -1.0f, -1.0f), Vector3(13.0f, 1.0f, 1.0f))));
+}
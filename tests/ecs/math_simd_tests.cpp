@@ -0,0 +1,130 @@
+#include "ecs/math/Matrix4x4.h"
+#include "ecs/math/Quaternion.h"
+#include "ecs/math/Vector.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include <cstddef>
+#include <vector>
+
+using namespace Engine::Math;
+
+// Built twice: into engine_tests with the platform's SIMD path, and into
+// engine_math_scalar_tests with ENGINE_MATH_SCALAR, so both paths are held to
+// the same plain scalar arithmetic.
+
+namespace {
+
+namespace reference {
+
+Matrix4x4 multiply(const Matrix4x4& a, const Matrix4x4& b) {
+    Matrix4x4 result;
+    for (int row = 0; row < 4; row++) {
+        for (int col = 0; col < 4; col++) {
+            result(row, col) = 0.0f;
+            for (int i = 0; i < 4; i++) {
+                result(row, col) += a(row, i) * b(i, col);
+            }
+        }
+    }
+    return result;
+}
+
+Matrix4x4 createTRS(const Vector3& position, const Quaternion& rotation, const Vector3& scale) {
+    Matrix4x4 t = Matrix4x4::createTranslation(position);
+    Matrix4x4 r = Matrix4x4::createRotation(rotation);
+    Matrix4x4 s = Matrix4x4::createScale(scale);
+    return multiply(multiply(t, r), s);
+}
+
+Quaternion multiply(const Quaternion& a, const Quaternion& q) {
+    return Quaternion(
+        a.w * q.x + a.x * q.w + a.y * q.z - a.z * q.y,
+        a.w * q.y - a.x * q.z + a.y * q.w + a.z * q.x,
+        a.w * q.z + a.x * q.y - a.y * q.x + a.z * q.w,
+        a.w * q.w - a.x * q.x - a.y * q.y - a.z * q.z
+    );
+}
+
+Vector3 rotateVector(const Quaternion& q, const Vector3& v) {
+    Vector3 qvec(q.x, q.y, q.z);
+    Vector3 uv = qvec.cross(v);
+    Vector3 uuv = qvec.cross(uv);
+    return v + (uv * q.w + uuv) * 2.0f;
+}
+
+} // namespace reference
+
+constexpr float TOLERANCE = 1e-5f;
+
+// Within TOLERANCE, relative to the magnitude for values above 1
+bool near(float actual, float expected) {
+    return actual == Catch::Approx(expected).epsilon(TOLERANCE).margin(TOLERANCE);
+}
+
+// Transforms with translations up to 10 units and scales up to 2
+struct Inputs {
+    static constexpr std::size_t COUNT = 256;
+
+    std::vector<Vector3> positions;
+    std::vector<Quaternion> rotations;
+    std::vector<Vector3> scales;
+    std::vector<Matrix4x4> matrices;
+
+    Inputs() {
+        for (std::size_t i = 0; i < COUNT; i++) {
+            float f = static_cast<float>(i);
+            positions.emplace_back(f * 0.04f - 5.0f, f * 0.02f, 10.0f - f * 0.07f);
+            rotations.push_back(Quaternion::fromEulerAngles(f * 0.1f, f * 0.2f, f * 0.3f));
+            scales.emplace_back(1.0f + f * 0.004f, 0.5f, 2.0f);
+            matrices.push_back(reference::createTRS(positions.back(), rotations.back(), scales.back()));
+        }
+    }
+};
+
+} // namespace
+
+TEST_CASE("createTRS matches T * R * S computed in scalar code", "[math][simd]") {
+    Inputs in;
+    for (std::size_t i = 0; i < Inputs::COUNT; i++) {
+        Matrix4x4 actual = Matrix4x4::createTRS(in.positions[i], in.rotations[i], in.scales[i]);
+        Matrix4x4 expected = reference::createTRS(in.positions[i], in.rotations[i], in.scales[i]);
+        for (int element = 0; element < 16; element++) {
+            CAPTURE(i, element);
+            REQUIRE(near(actual.data[element], expected.data[element]));
+        }
+    }
+}
+
+TEST_CASE("Matrix multiplication matches the scalar triple loop", "[math][simd]") {
+    Inputs in;
+    for (std::size_t i = 0; i < Inputs::COUNT; i++) {
+        std::size_t j = Inputs::COUNT - 1 - i;
+        Matrix4x4 actual = in.matrices[i] * in.matrices[j];
+        Matrix4x4 expected = reference::multiply(in.matrices[i], in.matrices[j]);
+        for (int element = 0; element < 16; element++) {
+            CAPTURE(i, element);
+            REQUIRE(near(actual.data[element], expected.data[element]));
+        }
+    }
+}
+
+TEST_CASE("Quaternion multiplication and rotation match the scalar formulas", "[math][simd]") {
+    Inputs in;
+    for (std::size_t i = 0; i < Inputs::COUNT; i++) {
+        std::size_t j = Inputs::COUNT - 1 - i;
+        CAPTURE(i);
+
+        Quaternion product = in.rotations[i] * in.rotations[j];
+        Quaternion expected = reference::multiply(in.rotations[i], in.rotations[j]);
+        REQUIRE(near(product.x, expected.x));
+        REQUIRE(near(product.y, expected.y));
+        REQUIRE(near(product.z, expected.z));
+        REQUIRE(near(product.w, expected.w));
+
+        Vector3 rotated = in.rotations[i].rotateVector(in.positions[j]);
+        Vector3 expectedRotated = reference::rotateVector(in.rotations[i], in.positions[j]);
+        REQUIRE(near(rotated.x, expectedRotated.x));
+        REQUIRE(near(rotated.y, expectedRotated.y));
+        REQUIRE(near(rotated.z, expectedRotated.z));
+    }
+}
@@ -0,0 +1,140 @@
+#include "ecs/SystemScheduler.h"
+#include "ecs/components/TransformComponent.h"
+#include "ecs/components/BroadphaseComponent.h"
+#include "core/job_system.h"
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Engine::ECS;
+
+namespace {
+
+// Begin and end of every update, in the order they happened
+struct EventLog {
+    std::mutex mutex;
+    std::vector<std::string> events;
+
+    void record(const std::string& event) {
+        std::lock_guard<std::mutex> lock(mutex);
+        events.push_back(event);
+    }
+
+    std::size_t indexOf(const std::string& event) const {
+        return std::find(events.begin(), events.end(), event) - events.begin();
+    }
+
+    // `first` finished before `second` started
+    bool ranBefore(const std::string& first, const std::string& second) const {
+        return indexOf(first + " end") < indexOf(second + " begin");
+    }
+};
+
+class LoggingSystem : public System {
+public:
+    LoggingSystem(std::string name, EventLog& log) : name(std::move(name)), log(log) {}
+
+    const char* getName() const override { return name.c_str(); }
+
+    void update(float) override {
+        log.record(name + " begin");
+        // Give a concurrently scheduled system the chance to start
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        log.record(name + " end");
+    }
+
+private:
+    std::string name;
+    EventLog& log;
+};
+
+// Waits inside update() until `expected` systems are in update() at once
+class RendezvousSystem : public System {
+public:
+    RendezvousSystem(std::atomic<int>& arrived, int expected) : arrived(arrived), expected(expected) {
+        setComponentMask<const TransformComponent>();
+    }
+
+    void update(float) override {
+        arrived.fetch_add(1);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (arrived.load() < expected && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        metOthers = arrived.load() >= expected;
+    }
+
+    bool metOthers = false;
+
+private:
+    std::atomic<int>& arrived;
+    int expected;
+};
+
+} // namespace
+
+TEST_CASE("Systems that only read the same components run concurrently", "[ecs][scheduler]") {
+    std::atomic<int> arrived{0};
+    RendezvousSystem a(arrived, 2);
+    RendezvousSystem b(arrived, 2);
+    REQUIRE_FALSE(a.conflictsWith(b));
+
+    engine::core::JobSystem jobs(2);
+    SystemScheduler scheduler;
+    scheduler.build({&a, &b});
+    scheduler.run(0.0f, jobs);
+
+    REQUIRE(a.metOthers);
+    REQUIRE(b.metOthers);
+}
+
+TEST_CASE("A writer and a reader run in registration order", "[ecs][scheduler]") {
+    EventLog log;
+    LoggingSystem writer("writer", log);
+    writer.setComponentMask<TransformComponent>();
+    LoggingSystem reader("reader", log);
+    reader.setComponentMask<const TransformComponent>();
+    REQUIRE(writer.conflictsWith(reader));
+    REQUIRE(reader.conflictsWith(writer));
+
+    engine::core::JobSystem jobs(2);
+    SystemScheduler scheduler;
+
+    scheduler.build({&writer, &reader});
+    scheduler.run(0.0f, jobs);
+    REQUIRE(log.ranBefore("writer", "reader"));
+
+    log.events.clear();
+    scheduler.build({&reader, &writer});
+    scheduler.run(0.0f, jobs);
+    REQUIRE(log.ranBefore("reader", "writer"));
+}
+
+TEST_CASE("A system with no declared access conflicts with every system", "[ecs][scheduler]") {
+    EventLog log;
+    LoggingSystem transforms("transforms", log);
+    transforms.setComponentMask<TransformComponent>();
+    LoggingSystem undeclared("undeclared", log);
+    LoggingSystem broadphase("broadphase", log);
+    broadphase.setComponentMask<const BroadphaseComponent>();
+
+    REQUIRE_FALSE(undeclared.hasDeclaredAccess());
+    REQUIRE(undeclared.conflictsWith(transforms));
+    REQUIRE(transforms.conflictsWith(undeclared));
+    REQUIRE(undeclared.conflictsWith(broadphase));
+    REQUIRE_FALSE(transforms.conflictsWith(broadphase));
+
+    engine::core::JobSystem jobs(2);
+    SystemScheduler scheduler;
+    scheduler.build({&transforms, &undeclared, &broadphase});
+    scheduler.run(0.0f, jobs);
+
+    // Independent of each other, but both ordered around the undeclared one
+    REQUIRE(log.ranBefore("transforms", "undeclared"));
+    REQUIRE(log.ranBefore("undeclared", "broadphase"));
+}
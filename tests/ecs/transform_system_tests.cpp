@@ -0,0 +1,108 @@
+#include "ecs/ECSManager.h"
+#include "ecs/components/TransformComponent.h"
+#include "ecs/components/BroadphaseComponent.h"
+#include "ecs/components/CameraComponent.h"
+#include "ecs/systems/TransformSystem.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <vector>
+
+using namespace Engine::ECS;
+using Engine::Math::Vector3;
+
+namespace {
+
+// The matrix TransformSystem stored, without the on-demand recomputation
+// getWorldMatrix() would do
+Vector3 storedTranslation(Entity* entity) {
+    return entity->getComponent<TransformComponent>().worldMatrix.getTranslation();
+}
+
+bool near(const Vector3& a, const Vector3& b) {
+    return std::abs(a.x - b.x) < 1e-5f && std::abs(a.y - b.y) < 1e-5f && std::abs(a.z - b.z) < 1e-5f;
+}
+
+} // namespace
+
+TEST_CASE("A moved parent updates its children's world matrices in the same frame", "[ecs][transform]") {
+    ECSManager manager(16);
+    auto* transforms = manager.registerSystem<TransformSystem>();
+
+    Entity* parent = manager.createEntity();
+    parent->addComponent<TransformComponent>(Vector3(1.0f, 0.0f, 0.0f));
+    Entity* child = manager.createEntity();
+    child->addComponent<TransformComponent>(Vector3(0.0f, 2.0f, 0.0f));
+    child->setParent(parent);
+    Entity* grandchild = manager.createEntity();
+    grandchild->addComponent<TransformComponent>(Vector3(0.0f, 0.0f, 3.0f));
+    grandchild->setParent(child);
+
+    manager.update(0.0f);
+    REQUIRE(near(storedTranslation(grandchild), Vector3(1.0f, 2.0f, 3.0f)));
+
+    parent->getComponent<TransformComponent>().setPosition(Vector3(5.0f, 0.0f, 0.0f));
+    manager.update(0.0f);
+    REQUIRE(transforms->getUpdatedCount() == 3);
+    REQUIRE(near(storedTranslation(child), Vector3(5.0f, 2.0f, 0.0f)));
+    REQUIRE(near(storedTranslation(grandchild), Vector3(5.0f, 2.0f, 3.0f)));
+
+    // The parent also moves in storage during the frame
+    parent->addComponent<BroadphaseComponent>(1.0f);
+    parent->getComponent<TransformComponent>().setPosition(Vector3(-1.0f, 0.0f, 0.0f));
+    manager.update(0.0f);
+    REQUIRE(near(storedTranslation(parent), Vector3(-1.0f, 0.0f, 0.0f)));
+    REQUIRE(near(storedTranslation(grandchild), Vector3(-1.0f, 2.0f, 3.0f)));
+
+    // Re-parenting takes effect in the same frame as well
+    grandchild->setParent(parent);
+    manager.update(0.0f);
+    REQUIRE(near(storedTranslation(grandchild), Vector3(-1.0f, 0.0f, 3.0f)));
+}
+
+TEST_CASE("Component moves unrelated to the hierarchy recompute nothing", "[ecs][transform]") {
+    ECSManager manager(64);
+    auto* transforms = manager.registerSystem<TransformSystem>();
+
+    Entity* root = manager.createEntity();
+    root->addComponent<TransformComponent>(Vector3(1.0f, 0.0f, 0.0f));
+    std::vector<Entity*> children;
+    for (int i = 0; i < 8; i++) {
+        Entity* child = manager.createEntity();
+        child->addComponent<TransformComponent>(Vector3(0.0f, float(i), 0.0f));
+        child->setParent(root);
+        children.push_back(child);
+    }
+    manager.update(0.0f);
+    REQUIRE(transforms->getUpdatedCount() == 9);
+    manager.update(0.0f);
+    REQUIRE(transforms->getUpdatedCount() == 0);
+
+    // Every transform changes archetype, some swap rows on the way
+    std::uint64_t structure = manager.getStructureVersion();
+    root->addComponent<CameraComponent>();
+    for (int i = 0; i < 8; i += 2) {
+        children[i]->addComponent<BroadphaseComponent>(0.5f);
+    }
+    REQUIRE(manager.getStructureVersion() != structure);
+    manager.update(0.0f);
+    REQUIRE(transforms->getUpdatedCount() == 0);
+
+    // The cached pointers follow the components to their new rows
+    children[3]->getComponent<TransformComponent>().setPosition(Vector3(0.0f, 0.0f, 7.0f));
+    manager.update(0.0f);
+    REQUIRE(transforms->getUpdatedCount() == 1);
+    REQUIRE(near(storedTranslation(children[3]), Vector3(1.0f, 0.0f, 7.0f)));
+
+    root->getComponent<TransformComponent>().setPosition(Vector3(2.0f, 0.0f, 0.0f));
+    manager.update(0.0f);
+    REQUIRE(transforms->getUpdatedCount() == 9);
+    for (int i = 0; i < 8; i++) {
+        Vector3 expected = i == 3 ? Vector3(2.0f, 0.0f, 7.0f) : Vector3(2.0f, float(i), 0.0f);
+        REQUIRE(near(storedTranslation(children[i]), expected));
+    }
+
+    // A transform leaving the system is a rebuild, which recomputes everything
+    children[7]->removeComponent<TransformComponent>();
+    manager.update(0.0f);
+    REQUIRE(transforms->getUpdatedCount() == 8);
+}
@@ -0,0 +1,150 @@
+#include "rendering/geometry_arena.h"
+#include "rendering/mesh.h"
+#include "gl_stub.h"
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+using namespace engine::rendering;
+
+namespace {
+
+using Space = GeometryArena::Space;
+
+bool sameBlocks(const Space& space, const std::vector<GeometryArena::FreeBlock>& expected) {
+    if (space.freeBlocks.size() != expected.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < expected.size(); i++) {
+        if (space.freeBlocks[i].offset != expected[i].offset || space.freeBlocks[i].count != expected[i].count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE("Arena space reuses the first free block that fits", "[rendering][arena]") {
+    Space space;
+    space.capacity = 100;
+    REQUIRE(space.allocate(10) == 0);
+    REQUIRE(space.allocate(20) == 10);
+    REQUIRE(space.allocate(10) == 30);
+    REQUIRE(space.allocate(30) == 40);
+    REQUIRE(space.allocate(5) == 70);
+    REQUIRE(space.end == 75);
+
+    // Two holes, [0, 10) and [30, 40), that touch nothing else free
+    space.release(0, 10);
+    space.release(30, 10);
+    REQUIRE(sameBlocks(space, {{0, 10}, {30, 10}}));
+
+    // The first hole is split, then the rest of it is used up
+    REQUIRE(space.allocate(4) == 0);
+    REQUIRE(sameBlocks(space, {{4, 6}, {30, 10}}));
+    REQUIRE(space.allocate(6) == 4);
+    REQUIRE(sameBlocks(space, {{30, 10}}));
+
+    // Too big for the hole: taken from the end
+    REQUIRE(space.allocate(12) == 75);
+    REQUIRE(space.end == 87);
+
+    // Fits neither a hole nor what is left past the end
+    REQUIRE(space.allocate(14) == space.capacity);
+    REQUIRE(space.end == 87);
+    REQUIRE(space.allocate(13) == 87);
+    REQUIRE(space.end == 100);
+}
+
+TEST_CASE("Arena space merges a released range with the blocks on both sides", "[rendering][arena]") {
+    Space space;
+    space.capacity = 100;
+    for (int i = 0; i < 6; i++) {
+        REQUIRE(space.allocate(10) == std::uint32_t(i * 10));
+    }
+
+    space.release(10, 10);
+    space.release(30, 10);
+    REQUIRE(sameBlocks(space, {{10, 10}, {30, 10}}));
+
+    // [20, 30) touches both: one block [10, 40)
+    space.release(20, 10);
+    REQUIRE(sameBlocks(space, {{10, 30}}));
+
+    // Only the block after it, then only the block before it
+    space.release(0, 10);
+    REQUIRE(sameBlocks(space, {{0, 40}}));
+    space.release(40, 10);
+    REQUIRE(sameBlocks(space, {{0, 50}}));
+    REQUIRE(space.end == 60);
+
+    // The merged block is handed out as one
+    REQUIRE(space.allocate(45) == 0);
+    REQUIRE(sameBlocks(space, {{45, 5}}));
+}
+
+TEST_CASE("Arena space pulls its end back when the last range is released", "[rendering][arena]") {
+    Space space;
+    space.capacity = 100;
+    REQUIRE(space.allocate(10) == 0);
+    REQUIRE(space.allocate(10) == 10);
+    REQUIRE(space.allocate(10) == 20);
+    REQUIRE(space.end == 30);
+
+    // The last range goes back past the end instead of into the list
+    space.release(20, 10);
+    REQUIRE(space.end == 20);
+    REQUIRE(space.freeBlocks.empty());
+
+    // A free block that now reaches the end is folded into it as well
+    space.release(0, 10);
+    REQUIRE(sameBlocks(space, {{0, 10}}));
+    space.release(10, 10);
+    REQUIRE(space.end == 0);
+    REQUIRE(space.freeBlocks.empty());
+
+    REQUIRE(space.allocate(100) == 0);
+}
+
+TEST_CASE("The arena doubles a full buffer and copies what it holds", "[rendering][arena]") {
+    testing::installCountingGL();
+    testing::resetGLCalls();
+
+    GeometryArena arena(8, 8);
+    GeometryArena::Range first = arena.allocate(std::vector<Vertex>(6), std::vector<unsigned int>(6));
+    REQUIRE(first.firstVertex == 0);
+    REQUIRE(first.firstIndex == 0);
+    REQUIRE(testing::getGLCalls().buffersCreated == 2);
+    REQUIRE(testing::getGLCalls().bufferCopies == 0);
+
+    // The vertices no longer fit and their buffer grows; the indices still do
+    testing::resetGLCalls();
+    GeometryArena::Range second = arena.allocate(std::vector<Vertex>(4), std::vector<unsigned int>(2));
+    REQUIRE(second.firstVertex == 6);
+    REQUIRE(second.firstIndex == 6);
+    REQUIRE(arena.getVertexCapacity() == 16);
+    REQUIRE(arena.getIndexCapacity() == 8);
+    REQUIRE(testing::getGLCalls().buffersCreated == 1);
+    REQUIRE(testing::getGLCalls().buffersDeleted == 1);
+    REQUIRE(testing::getGLCalls().bufferCopies == 1);
+    REQUIRE(testing::getGLCalls().bytesCopied == 6 * sizeof(Vertex));
+
+    // A free block too small to help: doubled as often as needed, and only
+    // the used part of the old buffer is copied
+    arena.release(first);
+    testing::resetGLCalls();
+    GeometryArena::Range third = arena.allocate(std::vector<Vertex>(20), std::vector<unsigned int>(3));
+    REQUIRE(third.firstVertex == 10);
+    REQUIRE(arena.getVertexCapacity() == 32);
+    REQUIRE(third.firstIndex == 0);
+    REQUIRE(arena.getIndexCapacity() == 8);
+    REQUIRE(testing::getGLCalls().bufferCopies == 1);
+    REQUIRE(testing::getGLCalls().bytesCopied == 10 * sizeof(Vertex));
+
+    // The space freed earlier is still reused after growing
+    testing::resetGLCalls();
+    GeometryArena::Range fourth = arena.allocate(std::vector<Vertex>(6), std::vector<unsigned int>(3));
+    REQUIRE(fourth.firstVertex == 0);
+    REQUIRE(fourth.firstIndex == 3);
+    REQUIRE(testing::getGLCalls().bufferCopies == 0);
+}
@@ -0,0 +1,82 @@
+#include "gl_stub.h"
+#include <GL/glew.h>
+
+namespace engine {
+namespace rendering {
+namespace testing {
+
+namespace {
+
+GLCallCounts g_calls;
+GLuint g_nextName = 1;
+
+void GLAPIENTRY genNames(GLsizei count, GLuint* names) {
+    for (GLsizei i = 0; i < count; i++) {
+        names[i] = g_nextName++;
+    }
+}
+
+void GLAPIENTRY genBuffers(GLsizei count, GLuint* buffers) {
+    genNames(count, buffers);
+    g_calls.buffersCreated += count;
+}
+
+void GLAPIENTRY deleteBuffers(GLsizei count, const GLuint*) {
+    g_calls.buffersDeleted += count;
+}
+
+void GLAPIENTRY bindBuffer(GLenum, GLuint) {}
+
+void GLAPIENTRY bufferData(GLenum, GLsizeiptr, const void*, GLenum) {
+    g_calls.bufferAllocations++;
+}
+
+void GLAPIENTRY bufferSubData(GLenum, GLintptr, GLsizeiptr, const void*) {
+    g_calls.bufferUploads++;
+}
+
+void GLAPIENTRY copyBufferSubData(GLenum, GLenum, GLintptr, GLintptr, GLsizeiptr size) {
+    g_calls.bufferCopies++;
+    g_calls.bytesCopied += static_cast<std::size_t>(size);
+}
+
+void GLAPIENTRY deleteVertexArrays(GLsizei, const GLuint*) {}
+
+void GLAPIENTRY bindVertexArray(GLuint array) {
+    if (array != 0) {
+        g_calls.vertexArrayBinds++;
+    }
+}
+
+void GLAPIENTRY enableVertexAttribArray(GLuint) {}
+
+void GLAPIENTRY vertexAttribPointer(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*) {}
+
+} // namespace
+
+void installCountingGL() {
+    // GLEW's entry points are function pointers, loaded by glewInit()
+    glGenBuffers = genBuffers;
+    glDeleteBuffers = deleteBuffers;
+    glBindBuffer = bindBuffer;
+    glBufferData = bufferData;
+    glBufferSubData = bufferSubData;
+    glCopyBufferSubData = copyBufferSubData;
+    glGenVertexArrays = genNames;
+    glDeleteVertexArrays = deleteVertexArrays;
+    glBindVertexArray = bindVertexArray;
+    glEnableVertexAttribArray = enableVertexAttribArray;
+    glVertexAttribPointer = vertexAttribPointer;
+}
+
+const GLCallCounts& getGLCalls() {
+    return g_calls;
+}
+
+void resetGLCalls() {
+    g_calls = GLCallCounts();
+}
+
+} // namespace testing
+} // namespace rendering
+} // namespace engine
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+
+namespace engine {
+namespace rendering {
+namespace testing {
+
+// Calls made through the counting GL entry points since resetGLCalls()
+struct GLCallCounts {
+    std::size_t buffersCreated = 0;
+    std::size_t buffersDeleted = 0;
+    std::size_t bufferAllocations = 0;  // glBufferData
+    std::size_t bufferUploads = 0;      // glBufferSubData
+    std::size_t bufferCopies = 0;       // glCopyBufferSubData
+    std::size_t bytesCopied = 0;
+    std::size_t vertexArrayBinds = 0;
+};
+
+// Point GLEW's buffer and vertex array entry points at stand-ins that only
+// count calls and hand out names, so the geometry arena, meshes and the
+// render queue's batching run without a context. Entry points GLEW does not
+// load, such as the GL 1.1 texture calls, are left alone.
+void installCountingGL();
+
+const GLCallCounts& getGLCalls();
+void resetGLCalls();
+
+} // namespace testing
+} // namespace rendering
+} // namespace engine
@@ -0,0 +1,338 @@
+#include "rendering/render_queue.h"
+#include "rendering/shader.h"
+#include "rendering/mesh.h"
+#include "rendering/model/material.h"
+#include "ecs/math/Affine3x4.h"
+#include "ecs/math/Matrix3x3.h"
+#include "gl_stub.h"
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+using namespace engine::rendering;
+
+namespace {
+
+// Objects for queued draws. Materials are only compared by address until
+// submit(), which needs a context and is not called here, so they are
+// stand-ins rather than real materials with their fallback texture.
+struct Scene {
+    std::vector<std::unique_ptr<Shader>> shaders;
+    std::vector<std::unique_ptr<Mesh>> meshes;
+    std::vector<std::aligned_storage_t<sizeof(Material), alignof(Material)>> materials;
+    Engine::Math::Affine3x4 worldMatrix;
+    Engine::Math::Matrix3x3 normalMatrix;
+
+    Scene(std::size_t shaderCount, std::size_t materialCount, std::size_t meshCount) : materials(materialCount) {
+        testing::installCountingGL();
+        for (std::size_t i = 0; i < shaderCount; i++) {
+            shaders.push_back(std::make_unique<Shader>());
+        }
+        // Meshes of different sizes, so each has its own range in the arena
+        for (std::size_t i = 0; i < meshCount; i++) {
+            meshes.push_back(std::make_unique<Mesh>());
+            std::vector<Vertex> vertices(3 + i);
+            std::vector<unsigned int> indices = {0, 1, 2};
+            meshes.back()->setVertices(vertices, indices);
+        }
+    }
+
+    Material* material(std::size_t i) { return reinterpret_cast<Material*>(&materials[i]); }
+};
+
+// One queued draw, as the tests added it
+struct Draw {
+    RenderPass pass;
+    std::size_t shader;
+    std::size_t material;
+    std::size_t mesh;
+    float depth;
+
+    auto state() const { return std::make_tuple(shader, material, mesh); }
+};
+
+void addDraws(RenderQueue& queue, Scene& scene, const std::vector<Draw>& draws) {
+    for (const Draw& draw : draws) {
+        queue.add(draw.pass, *scene.shaders[draw.shader], scene.material(draw.material), *scene.meshes[draw.mesh],
+                  draw.depth, scene.worldMatrix, scene.normalMatrix);
+    }
+}
+
+std::vector<Draw> randomDraws(std::size_t count, std::size_t shaders, std::size_t materials, std::size_t meshes,
+                              unsigned int seed) {
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> depth(0.5f, 500.0f);
+    std::vector<Draw> draws;
+    for (std::size_t i = 0; i < count; i++) {
+        RenderPass pass = random() % 4 == 0 ? RenderPass::Transparent : RenderPass::Opaque;
+        draws.push_back({pass, random() % shaders, random() % materials, random() % meshes, depth(random)});
+    }
+    return draws;
+}
+
+// Draws in the order the queue sorted them
+std::vector<Draw> sortedDraws(const RenderQueue& queue, const std::vector<Draw>& draws) {
+    std::vector<Draw> sorted;
+    for (std::size_t i = 0; i < queue.size(); i++) {
+        sorted.push_back(draws[queue.getSortedIndex(i)]);
+    }
+    return sorted;
+}
+
+// How often consecutive draws differ in `field`: the binds submit() makes
+template <typename Field>
+std::size_t changes(const std::vector<Draw>& draws, Field field) {
+    std::size_t count = draws.empty() ? 0 : 1;
+    for (std::size_t i = 1; i < draws.size(); i++) {
+        count += field(draws[i]) != field(draws[i - 1]);
+    }
+    return count;
+}
+
+} // namespace
+
+TEST_CASE("Sort keys order by pass, then state, then depth", "[rendering][queue]") {
+    auto key = RenderQueue::makeKey;
+    const RenderPass opaque = RenderPass::Opaque;
+    const RenderPass transparent = RenderPass::Transparent;
+
+    // Every opaque draw comes before every transparent one
+    REQUIRE(key(opaque, 1023, 16383, 16383, 1e30f) < key(transparent, 0, 0, 0, 1e30f));
+
+    // Opaque: shader, then material, then mesh, then front to back
+    REQUIRE(key(opaque, 0, 5, 5, 100.0f) < key(opaque, 1, 0, 0, 1.0f));
+    REQUIRE(key(opaque, 1, 0, 5, 100.0f) < key(opaque, 1, 1, 0, 1.0f));
+    REQUIRE(key(opaque, 1, 1, 0, 100.0f) < key(opaque, 1, 1, 1, 1.0f));
+    REQUIRE(key(opaque, 1, 1, 1, 1.0f) < key(opaque, 1, 1, 1, 1.5f));
+    REQUIRE(key(opaque, 1, 1, 1, 0.01f) < key(opaque, 1, 1, 1, 0.02f));
+
+    // Transparent: back to front across all state, state breaks ties
+    REQUIRE(key(transparent, 9, 9, 9, 50.0f) < key(transparent, 0, 0, 0, 10.0f));
+    REQUIRE(key(transparent, 0, 0, 0, 10.0f) < key(transparent, 0, 0, 1, 10.0f));
+
+    // Draws behind the camera or with a NaN depth sort as depth 0
+    REQUIRE(key(opaque, 1, 1, 1, -4.0f) == key(opaque, 1, 1, 1, 0.0f));
+    REQUIRE(key(opaque, 1, 1, 1, std::nanf("")) == key(opaque, 1, 1, 1, 0.0f));
+
+    // Ids wrap at the width of their field
+    REQUIRE(key(opaque, 1 << 10, 0, 0, 1.0f) == key(opaque, 0, 0, 0, 1.0f));
+    REQUIRE(key(opaque, 0, 1 << 14, 0, 1.0f) == key(opaque, 0, 0, 0, 1.0f));
+    REQUIRE(key(opaque, 0, 0, 1 << 14, 1.0f) == key(opaque, 0, 0, 0, 1.0f));
+}
+
+TEST_CASE("The radix sort orders like std::stable_sort", "[rendering][queue]") {
+    Scene scene(3, 8, 4);
+    RenderQueue queue;
+
+    // Few distinct objects make many equal keys; one shader makes whole
+    // key bytes equal, which skips their passes
+    for (auto [shaders, depthLevels] : {std::make_pair(3, 0), std::make_pair(3, 4), std::make_pair(1, 2)}) {
+        std::vector<Draw> draws = randomDraws(3000, shaders, 8, 4, 7u + shaders + depthLevels);
+        if (depthLevels > 0) {
+            for (Draw& draw : draws) {
+                draw.depth = float(int(draw.depth) % depthLevels + 1);
+            }
+        }
+        queue.clear();
+        addDraws(queue, scene, draws);
+        queue.sort();
+
+        // Keys by add() order, then the order std::stable_sort gives
+        REQUIRE(queue.size() == draws.size());
+        std::vector<std::uint64_t> keys(draws.size());
+        for (std::size_t i = 0; i < queue.size(); i++) {
+            keys[queue.getSortedIndex(i)] = queue.getSortedKey(i);
+        }
+        std::vector<std::uint32_t> expected(draws.size());
+        std::iota(expected.begin(), expected.end(), 0);
+        std::stable_sort(expected.begin(), expected.end(),
+                         [&](std::uint32_t a, std::uint32_t b) { return keys[a] < keys[b]; });
+
+        for (std::size_t i = 0; i < queue.size(); i++) {
+            REQUIRE(queue.getSortedIndex(i) == expected[i]);
+        }
+    }
+
+    // Nothing and a single draw are left alone
+    queue.clear();
+    queue.sort();
+    REQUIRE(queue.size() == 0);
+    addDraws(queue, scene, {{RenderPass::Opaque, 0, 0, 0, 1.0f}});
+    queue.sort();
+    REQUIRE(queue.getSortedIndex(0) == 0);
+}
+
+TEST_CASE("Opaque draws are grouped by state, transparent ones drawn back to front", "[rendering][queue]") {
+    Scene scene(2, 3, 2);
+    std::vector<Draw> draws = randomDraws(500, 2, 3, 2, 11u);
+    RenderQueue queue;
+    addDraws(queue, scene, draws);
+    queue.sort();
+    std::vector<Draw> sorted = sortedDraws(queue, draws);
+
+    auto firstTransparent = std::find_if(sorted.begin(), sorted.end(),
+                                         [](const Draw& draw) { return draw.pass == RenderPass::Transparent; });
+    REQUIRE(std::all_of(firstTransparent, sorted.end(),
+                        [](const Draw& draw) { return draw.pass == RenderPass::Transparent; }));
+    std::vector<Draw> opaque(sorted.begin(), firstTransparent);
+    std::vector<Draw> transparent(firstTransparent, sorted.end());
+    REQUIRE_FALSE(opaque.empty());
+    REQUIRE_FALSE(transparent.empty());
+
+    // Each shader, material and mesh combination is one run, front to back
+    std::set<std::tuple<std::size_t, std::size_t, std::size_t>> states;
+    for (const Draw& draw : opaque) {
+        states.insert(draw.state());
+    }
+    REQUIRE(changes(opaque, [](const Draw& draw) { return draw.state(); }) == states.size());
+    REQUIRE(changes(opaque, [](const Draw& draw) { return draw.shader; }) == 2);
+    for (std::size_t i = 1; i < opaque.size(); i++) {
+        if (opaque[i].state() == opaque[i - 1].state()) {
+            REQUIRE(opaque[i - 1].depth <= opaque[i].depth);
+        }
+    }
+
+    for (std::size_t i = 1; i < transparent.size(); i++) {
+        REQUIRE(transparent[i - 1].depth >= transparent[i].depth);
+    }
+}
+
+TEST_CASE("Draws without an instanced variant are batched one by one", "[rendering][queue]") {
+    Scene scene(2, 3, 2);
+    std::vector<Draw> draws = randomDraws(100, 2, 3, 2, 5u);
+    RenderQueue queue;
+    addDraws(queue, scene, draws);
+    queue.sort();
+    queue.buildBatches();
+
+    const std::vector<RenderQueue::Batch>& batches = queue.getBatches();
+    REQUIRE(batches.size() == draws.size());
+    for (std::size_t i = 0; i < batches.size(); i++) {
+        REQUIRE(batches[i].first == i);
+        REQUIRE(batches[i].count == 1);
+        REQUIRE(batches[i].commandCount == 0);
+    }
+    REQUIRE(queue.getIndirectCommands().size() == 0);
+}
+
+TEST_CASE("Sorting a 5000-draw, 20-material scene leaves one bind per material", "[rendering][queue]") {
+    constexpr std::size_t MATERIALS = 20;
+    constexpr std::size_t MESHES = 10;
+    Scene scene(1, MATERIALS, MESHES);
+    std::vector<Draw> draws = randomDraws(5000, 1, MATERIALS, MESHES, 3u);
+    for (Draw& draw : draws) {
+        draw.pass = RenderPass::Opaque;
+    }
+
+    RenderQueue queue;
+    addDraws(queue, scene, draws);
+    auto material = [](const Draw& draw) { return draw.material; };
+    auto state = [](const Draw& draw) { return draw.state(); };
+    REQUIRE(changes(draws, material) > 4000);
+
+    queue.sort();
+    std::vector<Draw> sorted = sortedDraws(queue, draws);
+    REQUIRE(changes(sorted, material) == MATERIALS);
+    REQUIRE(changes(sorted, state) <= MATERIALS * MESHES);
+}
+
+TEST_CASE("Object ids start over once a key field is used up", "[rendering][queue]") {
+    Shader shader;
+    std::vector<std::unique_ptr<Mesh>> meshes;
+    for (std::size_t i = 0; i < (1 << 14) + 2; i++) {
+        meshes.push_back(std::make_unique<Mesh>());
+    }
+    Engine::Math::Affine3x4 worldMatrix;
+    Engine::Math::Matrix3x3 normalMatrix;
+    RenderQueue queue;
+
+    // More meshes than 14 bits can number; the last two alias the first two
+    for (const auto& mesh : meshes) {
+        queue.add(RenderPass::Opaque, shader, nullptr, *mesh, 1.0f, worldMatrix, normalMatrix);
+    }
+    queue.sort();
+    REQUIRE(queue.getSortedKey(0) == queue.getSortedKey(1));
+
+    // The next frame numbers its meshes from zero again
+    queue.clear();
+    queue.add(RenderPass::Opaque, shader, nullptr, *meshes.back(), 1.0f, worldMatrix, normalMatrix);
+    queue.add(RenderPass::Opaque, shader, nullptr, *meshes.front(), 1.0f, worldMatrix, normalMatrix);
+    queue.sort();
+    REQUIRE(queue.getSortedIndex(0) == 0);
+    REQUIRE(queue.getSortedKey(0) == RenderQueue::makeKey(RenderPass::Opaque, 0, 0, 0, 1.0f));
+    REQUIRE(queue.getSortedKey(1) == RenderQueue::makeKey(RenderPass::Opaque, 0, 0, 1, 1.0f));
+}
+
+TEST_CASE("Instanced runs of one mesh and material become one command", "[rendering][queue]") {
+    // Shader 0 has an instanced variant, shader 1 does not
+    Scene scene(2, 2, 3);
+    Shader variant;
+    RenderQueue queue;
+    queue.setInstancedVariant(*scene.shaders[0], &variant);
+
+    // Instances per material and mesh of shader 0
+    const std::size_t counts[2][3] = {{4, 0, 2}, {1, 3, 5}};
+    std::vector<Draw> draws;
+    for (int copy = 0; copy < 5; copy++) {
+        for (std::size_t material = 0; material < 2; material++) {
+            for (std::size_t mesh = 0; mesh < 3; mesh++) {
+                if (std::size_t(copy) < counts[material][mesh]) {
+                    draws.push_back({RenderPass::Opaque, 0, material, mesh, float(copy + 1)});
+                }
+            }
+        }
+        draws.push_back({RenderPass::Opaque, 1, 0, 0, float(copy + 1)});
+    }
+    addDraws(queue, scene, draws);
+    queue.sort();
+    queue.buildBatches();
+
+    // One batch per material of shader 0, then one per draw of shader 1
+    const std::vector<RenderQueue::Batch>& batches = queue.getBatches();
+    const IndirectDrawBuilder& commands = queue.getIndirectCommands();
+    REQUIRE(batches.size() == 2 + 5);
+
+    std::uint32_t instance = 0;
+    for (std::size_t material = 0; material < 2; material++) {
+        const RenderQueue::Batch& batch = batches[material];
+        std::size_t total = 0;
+        std::size_t meshes = 0;
+        for (std::size_t mesh = 0; mesh < 3; mesh++) {
+            total += counts[material][mesh];
+            meshes += counts[material][mesh] > 0;
+        }
+        REQUIRE(batch.count == total);
+        REQUIRE(batch.commandCount == meshes);
+
+        // A command per mesh, with consecutive instances
+        std::set<std::size_t> seen;
+        for (std::size_t command = batch.firstCommand; command < batch.firstCommand + batch.commandCount; command++) {
+            const DrawElementsIndirectCommand& draw = commands[command];
+            std::size_t mesh = 0;
+            while (mesh < 3 && scene.meshes[mesh]->getGeometry().firstVertex != std::uint32_t(draw.baseVertex)) {
+                mesh++;
+            }
+            REQUIRE(mesh < 3);
+            CAPTURE(material, mesh);
+            const GeometryArena::Range& geometry = scene.meshes[mesh]->getGeometry();
+            REQUIRE(draw.firstIndex == geometry.firstIndex);
+            REQUIRE(draw.count == geometry.indexCount);
+            REQUIRE(draw.instanceCount == counts[material][mesh]);
+            REQUIRE(draw.baseInstance == instance);
+            REQUIRE(seen.insert(mesh).second);
+            instance += draw.instanceCount;
+        }
+    }
+    REQUIRE(commands.size() == 5);
+
+    for (std::size_t i = 2; i < batches.size(); i++) {
+        REQUIRE(batches[i].count == 1);
+        REQUIRE(batches[i].commandCount == 0);
+    }
+}
@@ -0,0 +1,89 @@
+#include "rendering/uniform_buffer.h"
+#include "ecs/components/CameraComponent.h"
+#include "ecs/math/Affine3x4.h"
+#include "ecs/math/Matrix4x4.h"
+#include "ecs/math/Quaternion.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include <glm/glm.hpp>
+
+using namespace Engine::Math;
+using engine::rendering::storeMatrix;
+using engine::rendering::storeNormalMatrix;
+
+namespace {
+
+// Uniform blocks must hold what the shaders used to get from
+// glUniformMatrix4fv(..., GL_FALSE, value_ptr(matrix.toGLM()))
+void requireSameLayout(const float (&uploaded)[16], const glm::mat4& expected) {
+    for (int col = 0; col < 4; col++) {
+        for (int row = 0; row < 4; row++) {
+            CAPTURE(col, row);
+            REQUIRE(uploaded[col * 4 + row] == Catch::Approx(expected[col][row]).margin(1e-5));
+        }
+    }
+}
+
+const Vector3 POSITION(3.0f, -2.0f, 7.5f);
+const Quaternion ROTATION = Quaternion::fromEulerAngles(0.3f, 1.1f, -0.4f);
+const Vector3 SCALE(2.0f, 0.5f, 1.5f);
+
+} // namespace
+
+TEST_CASE("storeMatrix matches toGLM for a TRS matrix", "[rendering][uniforms]") {
+    Matrix4x4 trs = Matrix4x4::createTRS(POSITION, ROTATION, SCALE);
+
+    float uploaded[16];
+    storeMatrix(trs, uploaded);
+    requireSameLayout(uploaded, trs.toGLM());
+}
+
+TEST_CASE("storeMatrix matches toGLM for the camera projection and view", "[rendering][uniforms]") {
+    Engine::ECS::CameraComponent camera;
+    camera.setPerspective(60.0f, 16.0f / 9.0f, 0.1f, 500.0f);
+    const Matrix4x4& projection = camera.getProjectionMatrix();
+
+    float uploaded[16];
+    storeMatrix(projection, uploaded);
+    requireSameLayout(uploaded, projection.toGLM());
+
+    // The -1 that copies -z into w must land in column 2, row 3
+    REQUIRE(uploaded[2 * 4 + 3] == Catch::Approx(-1.0f));
+
+    Matrix4x4 view = Matrix4x4::createLookAt(Vector3(4.0f, 3.0f, 10.0f), Vector3(0.0f, 1.0f, 0.0f),
+                                             Vector3(0.0f, 1.0f, 0.0f));
+    storeMatrix(view, uploaded);
+    requireSameLayout(uploaded, view.toGLM());
+}
+
+TEST_CASE("storeMatrix of an Affine3x4 matches toGLM of the same Matrix4x4", "[rendering][uniforms]") {
+    Affine3x4 affine = Affine3x4::createTRS(POSITION, ROTATION, SCALE);
+
+    float uploaded[16];
+    storeMatrix(affine, uploaded);
+    requireSameLayout(uploaded, Matrix4x4::createTRS(POSITION, ROTATION, SCALE).toGLM());
+    requireSameLayout(uploaded, affine.toMatrix4x4().toGLM());
+}
+
+TEST_CASE("storeNormalMatrix matches toGLM with std140 column padding", "[rendering][uniforms]") {
+    Matrix3x3 normal = Affine3x4::createTRS(POSITION, ROTATION, SCALE).normalMatrix();
+
+    // The same 3x3 in the upper left of a Matrix4x4
+    Matrix4x4 expanded;
+    for (int row = 0; row < 3; row++) {
+        for (int col = 0; col < 3; col++) {
+            expanded(row, col) = normal(row, col);
+        }
+    }
+    glm::mat4 expected = expanded.toGLM();
+
+    float uploaded[12];
+    storeNormalMatrix(normal, uploaded);
+    for (int col = 0; col < 3; col++) {
+        for (int row = 0; row < 3; row++) {
+            CAPTURE(col, row);
+            REQUIRE(uploaded[col * 4 + row] == Catch::Approx(expected[col][row]).margin(1e-5));
+        }
+        REQUIRE(uploaded[col * 4 + 3] == 0.0f);
+    }
+}